@@ -37,6 +37,7 @@
 #include "graphicstate.h"
 #include "log.h"
 #include "math_utils.h"
+#include "media_scheduler.h"
 #include "memory.h"
 #include "nodegl.h"
 #include "internal.h"
@@ -116,6 +117,7 @@ static int cmd_stop(struct ngl_ctx *s, void *arg)
 static void reset_scene(struct ngl_ctx *s, int action)
 {
     ngli_hud_freep(&s->hud);
+    ngli_parallel_update_reset(&s->parallel_update);
     if (s->scene) {
         ngli_node_detach_ctx(s->scene, s);
         if (action == NGLI_ACTION_UNREF_SCENE)
@@ -145,6 +147,10 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_node *scene)
         s->scene = ngl_node_ref(scene);
     }
 
+    ret = ngli_parallel_update_init(&s->parallel_update, s->threadpool, s->scene);
+    if (ret < 0)
+        goto fail;
+
     const struct ngl_config *config = &s->config;
     if (config->hud) {
         s->hud = ngli_hud_create(s);
@@ -170,13 +176,15 @@ void ngli_ctx_reset(struct ngl_ctx *s, int action)
     if (s->gpu_ctx)
         ngli_gpu_ctx_wait_idle(s->gpu_ctx);
     reset_scene(s, action);
+    ngli_media_scheduler_freep(&s->media_scheduler);
+    ngli_threadpool_freep(&s->threadpool);
 #if defined(HAVE_VAAPI)
     ngli_vaapi_ctx_reset(&s->vaapi_ctx);
 #endif
 #if defined(TARGET_ANDROID)
     ngli_android_ctx_reset(&s->android_ctx);
 #endif
-    ngli_texture_freep(&s->font_atlas); // allocated by the first node text
+    ngli_font_atlas_freep(&s->font_atlas); // allocated by the first node text
     ngli_pgcache_reset(&s->pgcache);
     ngli_gpu_ctx_freep(&s->gpu_ctx);
     ngli_config_reset(&s->config);
@@ -204,7 +212,14 @@ int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config)
         return ret;
     }
 
-    ret = ngli_pgcache_init(&s->pgcache, s->gpu_ctx);
+    /*
+     * OpenGL program objects hold their uniform values and are bound to the
+     * context current in each thread, so the GL contexts only share the
+     * program binaries through the on-disk cache (program_cache_dir)
+     */
+    const int share_programs = config->shared_ctx && config->backend == NGL_BACKEND_VULKAN;
+    struct pgcache *shared_pgcache = share_programs ? &config->shared_ctx->pgcache : NULL;
+    ret = ngli_pgcache_init(&s->pgcache, s->gpu_ctx, shared_pgcache);
     if (ret < 0)
         goto fail;
 
@@ -229,6 +244,20 @@ int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config)
         goto fail;
     }
 
+    if (config->nb_update_threads > 1) {
+        s->threadpool = ngli_threadpool_create(config->nb_update_threads);
+        if (!s->threadpool) {
+            ret = NGL_ERROR_MEMORY;
+            goto fail;
+        }
+    }
+
+    s->media_scheduler = ngli_media_scheduler_create(config->max_media_startups, config->max_media_decoders);
+    if (!s->media_scheduler) {
+        ret = NGL_ERROR_MEMORY;
+        goto fail;
+    }
+
     struct ngl_node *old_scene = s->scene; // note: the old scene is detached
     s->scene = NULL; // make sure the old scene is not unreferenced by set_scene()
     ret = ngli_ctx_set_scene(s, old_scene);
@@ -265,6 +294,11 @@ int ngli_ctx_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
     return 0;
 }
 
+int ngli_ctx_flush_capture(struct ngl_ctx *s)
+{
+    return ngli_gpu_ctx_flush_capture(s->gpu_ctx);
+}
+
 int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
 {
     const int64_t start_time = s->hud ? ngli_gettime_relative() : 0;
@@ -284,6 +318,17 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
     if (ret < 0)
         return ret;
 
+    ret = ngli_media_scheduler_run(s->media_scheduler);
+    if (ret < 0)
+        return ret;
+
+    const int64_t parallel_start_time = s->hud ? ngli_gettime_relative() : 0;
+    int64_t parallel_work_time = 0;
+    ret = ngli_parallel_update_run(&s->parallel_update, t, s->hud ? &parallel_work_time : NULL);
+    if (ret < 0)
+        return ret;
+    const int64_t parallel_time = s->hud ? ngli_gettime_relative() - parallel_start_time : 0;
+
     ret = ngli_node_update(scene, t);
     if (ret < 0)
         return ret;
@@ -294,6 +339,13 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
 
     s->cpu_update_time = s->hud ? ngli_gettime_relative() - start_time : 0;
 
+    /*
+     * Estimation of the update time if it was running on a single thread: the
+     * wall time of the parallel update is replaced by the time spent by all
+     * the threads updating the nodes
+     */
+    s->cpu_update_seq_time = s->cpu_update_time - parallel_time + parallel_work_time;
+
     return 0;
 }
 
@@ -348,6 +400,25 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t)
     return ngli_gpu_ctx_end_draw(s->gpu_ctx, t);
 }
 
+int ngli_ctx_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                        ngl_draw_callback_type callback, void *arg)
+{
+    for (int i = 0; i < nb_times; i++) {
+        int ret = ngli_ctx_draw(s, times[i]);
+        if (ret < 0)
+            return ret;
+
+        if (callback) {
+            ret = callback(arg, i, times[i]);
+            if (ret < 0)
+                return ret;
+            if (ret > 0)
+                break;
+        }
+    }
+    return 0;
+}
+
 int ngli_ctx_dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg)
 {
     pthread_mutex_lock(&s->lock);
@@ -643,6 +714,51 @@ int ngl_configure(struct ngl_ctx *s, struct ngl_config *config)
         return NGL_ERROR_INVALID_ARG;
     }
 
+    if (config->nb_update_threads < 0) {
+        LOG(ERROR, "invalid number of update threads %d", config->nb_update_threads);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->max_media_startups < 0) {
+        LOG(ERROR, "invalid maximum number of media startups %d", config->max_media_startups);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->max_media_decoders < 0) {
+        LOG(ERROR, "invalid maximum number of media decoders %d", config->max_media_decoders);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->capture_async_depth < 0) {
+        LOG(ERROR, "invalid asynchronous capture depth %d", config->capture_async_depth);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->capture_async_depth > 0) {
+        if (!config->offscreen || config->capture_buffer_type != NGL_CAPTURE_BUFFER_TYPE_CPU) {
+            LOG(ERROR, "asynchronous capture is only supported with offscreen "
+                       "rendering and the CPU capture buffer type");
+            return NGL_ERROR_UNSUPPORTED;
+        }
+        if (!config->capture_callback) {
+            LOG(ERROR, "asynchronous capture requires a capture callback");
+            return NGL_ERROR_INVALID_USAGE;
+        }
+    }
+
+    const struct ngl_ctx *shared_ctx = config->shared_ctx;
+    if (shared_ctx) {
+        if (shared_ctx == s || !shared_ctx->configured) {
+            LOG(ERROR, "shared context must be another configured context");
+            return NGL_ERROR_INVALID_USAGE;
+        }
+        if (shared_ctx->config.backend != config->backend ||
+            shared_ctx->config.platform != config->platform) {
+            LOG(ERROR, "shared context must use the same backend and platform");
+            return NGL_ERROR_INVALID_USAGE;
+        }
+    }
+
     s->api_impl = api_map[config->backend].api_impl;
     if (!s->api_impl) {
         LOG(ERROR, "backend \"%s\" not available with this build",
@@ -683,6 +799,16 @@ int ngl_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
     return ret;
 }
 
+int ngl_flush_capture(struct ngl_ctx *s)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before flushing captures");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    return s->api_impl->flush_capture(s);
+}
+
 int ngl_set_scene(struct ngl_ctx *s, struct ngl_node *scene)
 {
     if (!s->configured) {
@@ -713,6 +839,22 @@ int ngl_draw(struct ngl_ctx *s, double t)
     return s->api_impl->draw(s, t);
 }
 
+int ngl_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                   ngl_draw_callback_type callback, void *arg)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before drawing");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    if (nb_times < 0 || (nb_times && !times)) {
+        LOG(ERROR, "invalid draw times");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    return s->api_impl->draw_times(s, times, nb_times, callback, arg);
+}
+
 int ngl_gl_wrap_framebuffer(struct ngl_ctx *s, uint32_t framebuffer)
 {
     if (!s->configured) {
@@ -127,6 +127,21 @@ static int glw_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
     return NGL_ERROR_UNSUPPORTED;
 }
 
+static int cmd_flush_capture(struct ngl_ctx *s, void *arg)
+{
+    return ngli_ctx_flush_capture(s);
+}
+
+static int gl_flush_capture(struct ngl_ctx *s)
+{
+    return ngli_ctx_dispatch_cmd(s, cmd_flush_capture, NULL);
+}
+
+static int glw_flush_capture(struct ngl_ctx *s)
+{
+    return 0;
+}
+
 static int cmd_set_scene(struct ngl_ctx *s, void *arg)
 {
     struct ngl_node *node = arg;
@@ -184,6 +199,40 @@ static int glw_draw(struct ngl_ctx *s, double t)
     return ret;
 }
 
+struct draw_times_params {
+    const double *times;
+    int nb_times;
+    ngl_draw_callback_type callback;
+    void *arg;
+};
+
+static int cmd_draw_times(struct ngl_ctx *s, void *arg)
+{
+    const struct draw_times_params *params = arg;
+    return ngli_ctx_draw_times(s, params->times, params->nb_times, params->callback, params->arg);
+}
+
+static int gl_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                         ngl_draw_callback_type callback, void *arg)
+{
+    struct draw_times_params params = {
+        .times    = times,
+        .nb_times = nb_times,
+        .callback = callback,
+        .arg      = arg,
+    };
+    return ngli_ctx_dispatch_cmd(s, cmd_draw_times, &params);
+}
+
+static int glw_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                          ngl_draw_callback_type callback, void *arg)
+{
+    ngli_gpu_ctx_gl_reset_state(s->gpu_ctx);
+    int ret = ngli_ctx_draw_times(s, times, nb_times, callback, arg);
+    ngli_gpu_ctx_gl_reset_state(s->gpu_ctx);
+    return ret;
+}
+
 static int cmd_reset(struct ngl_ctx *s, void *arg)
 {
     const int action = *(int *)arg;
@@ -243,6 +292,11 @@ static int glv_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
     return is_glw(&s->config) ? glw_set_capture_buffer(s, capture_buffer) : gl_set_capture_buffer(s, capture_buffer);
 }
 
+static int glv_flush_capture(struct ngl_ctx *s)
+{
+    return is_glw(&s->config) ? glw_flush_capture(s) : gl_flush_capture(s);
+}
+
 static int glv_set_scene(struct ngl_ctx *s, struct ngl_node *node)
 {
     return is_glw(&s->config) ? glw_set_scene(s, node) : gl_set_scene(s, node);
@@ -258,6 +312,13 @@ static int glv_draw(struct ngl_ctx *s, double t)
     return is_glw(&s->config) ? glw_draw(s, t) : gl_draw(s, t);
 }
 
+static int glv_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                          ngl_draw_callback_type callback, void *arg)
+{
+    return is_glw(&s->config) ? glw_draw_times(s, times, nb_times, callback, arg)
+                              : gl_draw_times(s, times, nb_times, callback, arg);
+}
+
 static void glv_reset(struct ngl_ctx *s, int action)
 {
     is_glw(&s->config) ? glw_reset(s, action) : gl_reset(s, action);
@@ -272,9 +333,11 @@ const struct api_impl api_gl = {
     .configure           = glv_configure,
     .resize              = glv_resize,
     .set_capture_buffer  = glv_set_capture_buffer,
+    .flush_capture       = glv_flush_capture,
     .set_scene           = glv_set_scene,
     .prepare_draw        = glv_prepare_draw,
     .draw                = glv_draw,
+    .draw_times          = glv_draw_times,
     .reset               = glv_reset,
     .gl_wrap_framebuffer = glv_wrap_framebuffer,
 };
@@ -73,6 +73,7 @@ struct egl_priv {
     int has_platform_wayland_ext;
     int has_surfaceless_context_ext;
     int has_device_base_ext;
+    int own_display;
 #if defined(HAVE_WAYLAND)
     struct wl_egl_window *wl_egl_window;
 #endif
@@ -189,6 +190,14 @@ static int egl_probe_client_extensions(struct egl_priv *egl)
 
 static int egl_check_display(struct egl_priv *egl, EGLDisplay display)
 {
+    /*
+     * The display may already be in use by another context (typically the
+     * shared context), terminating it would destroy the resources of the
+     * other context
+     */
+    if (eglQueryString(display, EGL_VERSION))
+        return 0;
+
     EGLint major, minor;
     EGLBoolean ret = eglInitialize(display, &major, &minor);
     if (!ret)
@@ -305,6 +314,13 @@ static int egl_init(struct glcontext *ctx, uintptr_t display, uintptr_t window,
         return -1;
     }
 
+    /*
+     * A context created in the share group of another context uses the same
+     * display, which is terminated by the shared context since it outlives
+     * this one
+     */
+    egl->own_display = !other;
+
     egl->extensions = eglQueryString(egl->display, EGL_EXTENSIONS);
     if (!egl->extensions) {
         LOG(ERROR, "could not retrieve EGL extensions");
@@ -492,7 +508,7 @@ static void egl_uninit(struct glcontext *ctx)
     if (egl->handle)
         eglDestroyContext(egl->display, egl->handle);
 
-    if (egl->display)
+    if (egl->display && egl->own_display)
         eglTerminate(egl->display);
 
 #if defined(TARGET_LINUX)
@@ -213,6 +213,7 @@ static const struct glfeature {
         .funcs_offsets  = (const size_t[]){OFFSET(FenceSync),
                                            OFFSET(ClientWaitSync),
                                            OFFSET(WaitSync),
+                                           OFFSET(DeleteSync),
                                            -1}
     }, {
         .name           = "yuv_target",
@@ -321,5 +322,15 @@ static const struct glfeature {
         .flag           = NGLI_FEATURE_GL_OES_STANDARD_DERIVATIVES,
         .es_version     = 300,
         .es_extensions  = (const char*[]){"GL_OES_standard_derivatives", NULL},
+    }, {
+        .name           = "get_program_binary",
+        .flag           = NGLI_FEATURE_GL_GET_PROGRAM_BINARY,
+        .version        = 410,
+        .es_version     = 300,
+        .extensions     = (const char*[]){"GL_ARB_get_program_binary", NULL},
+        .funcs_offsets  = (const size_t[]){OFFSET(GetProgramBinary),
+                                           OFFSET(ProgramBinary),
+                                           OFFSET(ProgramParameteri),
+                                           -1}
     }
 };
@@ -120,6 +120,10 @@ typedef void (NGLI_GL_APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint
 # define GL_MAX_SAMPLES                        0x8D57
 # define GL_MAX_COLOR_ATTACHMENTS              0x8CDF
 # define GL_SYNC_GPU_COMMANDS_COMPLETE         0x9117
+# define GL_SYNC_FLUSH_COMMANDS_BIT            0x00000001
+# define GL_WAIT_FAILED                        0x911D
+# define GL_PIXEL_PACK_BUFFER                  0x88EB
+# define GL_MAP_READ_BIT                       0x0001
 # define GL_TIMEOUT_IGNORED                    0xFFFFFFFFFFFFFFFFull
 # define GL_TEXTURE_RECTANGLE                  0x84F5
 # define GL_STENCIL_INDEX                      0x1901
@@ -230,6 +234,9 @@ typedef void (NGLI_GL_APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint
 # define GL_DEPTH_STENCIL_ATTACHMENT           0x821A
 # define GL_ACTIVE_RESOURCES                   0x92F5
 # define GL_ACTIVE_UNIFORM_BLOCKS              0x8A36
+# define GL_PROGRAM_BINARY_RETRIEVABLE_HINT    0x8257
+# define GL_PROGRAM_BINARY_LENGTH              0x8741
+# define GL_NUM_PROGRAM_BINARY_FORMATS         0x87FE
 # define GL_UNIFORM_BUFFER                     0x8A11
 # define GL_UNIFORM_BLOCK_BINDING              0x8A3F
 # define GL_MAX_UNIFORM_BLOCK_SIZE             0x8A30
@@ -56,6 +56,141 @@ static void capture_cpu(struct gpu_ctx *s)
     ngli_glReadPixels(gl, 0, 0, rt->width, rt->height, GL_RGBA, GL_UNSIGNED_BYTE, config->capture_buffer);
 }
 
+static int capture_async_deliver(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    const struct ngl_config *config = &s->config;
+
+    struct capture_slot_gl *slot = &s_priv->capture_slots[s_priv->capture_slot_head];
+    s_priv->capture_slot_head = (s_priv->capture_slot_head + 1) % s_priv->nb_capture_slots;
+    s_priv->nb_pending_captures--;
+
+    const GLenum status = ngli_glClientWaitSync(gl, slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    ngli_glDeleteSync(gl, slot->fence);
+    slot->fence = NULL;
+    if (status == GL_WAIT_FAILED) {
+        LOG(ERROR, "could not wait for capture @ t=%f", slot->t);
+        return NGL_ERROR_GRAPHICS_GENERIC;
+    }
+
+    int ret = 0;
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->pbo);
+    const uint8_t *data = ngli_glMapBufferRange(gl, GL_PIXEL_PACK_BUFFER, 0, s_priv->capture_size, GL_MAP_READ_BIT);
+    if (data) {
+        config->capture_callback(config->capture_callback_arg, slot->t, data, s_priv->capture_size);
+        ngli_glUnmapBuffer(gl, GL_PIXEL_PACK_BUFFER);
+    } else {
+        LOG(ERROR, "could not map capture buffer @ t=%f", slot->t);
+        ret = NGL_ERROR_GRAPHICS_GENERIC;
+    }
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+
+    return ret;
+}
+
+static int capture_cpu_async(struct gpu_ctx *s, double t)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    struct rendertarget *rt = s_priv->default_rt;
+    struct rendertarget_gl *rt_gl = (struct rendertarget_gl *)rt;
+
+    /* The ring is full: the oldest capture must be delivered to free a slot */
+    if (s_priv->nb_pending_captures == s_priv->nb_capture_slots) {
+        int ret = capture_async_deliver(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    const int index = (s_priv->capture_slot_head + s_priv->nb_pending_captures) % s_priv->nb_capture_slots;
+    struct capture_slot_gl *slot = &s_priv->capture_slots[index];
+
+    const GLuint fbo_id = rt_gl->resolve_id ? rt_gl->resolve_id : rt_gl->id;
+    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->pbo);
+    ngli_glReadPixels(gl, 0, 0, rt->width, rt->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->fence = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!slot->fence) {
+        LOG(ERROR, "could not create capture fence");
+        return NGL_ERROR_GRAPHICS_GENERIC;
+    }
+    slot->t = t;
+    s_priv->nb_pending_captures++;
+
+    /* Make sure the GPU starts processing the frame without waiting for the next one */
+    ngli_glFlush(gl);
+
+    return 0;
+}
+
+static int capture_async_init(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    const struct ngl_config *config = &s->config;
+    const struct rendertarget *rt = s_priv->default_rt;
+
+    const uint64_t features = NGLI_FEATURE_GL_MAP_BUFFER_RANGE | NGLI_FEATURE_GL_SYNC;
+    if ((gl->features & features) != features) {
+        LOG(ERROR, "context does not support asynchronous capture");
+        return NGL_ERROR_GRAPHICS_UNSUPPORTED;
+    }
+
+    s_priv->capture_slots = ngli_calloc(config->capture_async_depth, sizeof(*s_priv->capture_slots));
+    if (!s_priv->capture_slots)
+        return NGL_ERROR_MEMORY;
+    s_priv->nb_capture_slots = config->capture_async_depth;
+    s_priv->capture_size = rt->width * rt->height * 4;
+
+    for (int i = 0; i < s_priv->nb_capture_slots; i++) {
+        struct capture_slot_gl *slot = &s_priv->capture_slots[i];
+        ngli_glGenBuffers(gl, 1, &slot->pbo);
+        ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->pbo);
+        ngli_glBufferData(gl, GL_PIXEL_PACK_BUFFER, s_priv->capture_size, NULL, GL_STREAM_READ);
+    }
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+
+    return 0;
+}
+
+static int gl_flush_capture(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+
+    while (s_priv->nb_pending_captures) {
+        int ret = capture_async_deliver(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static void capture_async_reset(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+
+    if (!s_priv->capture_slots)
+        return;
+
+    gl_flush_capture(s);
+
+    for (int i = 0; i < s_priv->nb_capture_slots; i++) {
+        struct capture_slot_gl *slot = &s_priv->capture_slots[i];
+        if (slot->fence)
+            ngli_glDeleteSync(gl, slot->fence);
+        ngli_glDeleteBuffers(gl, 1, &slot->pbo);
+    }
+    ngli_freep(&s_priv->capture_slots);
+    s_priv->nb_capture_slots = 0;
+    s_priv->capture_slot_head = 0;
+    s_priv->nb_pending_captures = 0;
+}
+
 static void capture_corevideo(struct gpu_ctx *s)
 {
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
@@ -317,6 +452,12 @@ static int offscreen_rendertarget_init(struct gpu_ctx *s)
     };
     s_priv->capture_func = capture_func_map[config->capture_buffer_type];
 
+    if (config->capture_async_depth) {
+        ret = capture_async_init(s);
+        if (ret < 0)
+            return ret;
+    }
+
     return 0;
 }
 
@@ -337,6 +478,7 @@ static int onscreen_rendertarget_init(struct gpu_ctx *s)
 static void rendertarget_reset(struct gpu_ctx *s)
 {
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    capture_async_reset(s);
     ngli_rendertarget_freep(&s_priv->default_rt);
     ngli_rendertarget_freep(&s_priv->default_rt_load);
     ngli_texture_freep(&s_priv->color);
@@ -472,6 +614,10 @@ static int gl_init(struct gpu_ctx *s)
             LOG(ERROR, "capture_buffer is not supported by external context");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->capture_async_depth) {
+            LOG(ERROR, "asynchronous capture is not supported by external context");
+            return NGL_ERROR_INVALID_ARG;
+        }
     } else if (config->offscreen) {
         if (config->width <= 0 || config->height <= 0) {
             LOG(ERROR, "could not create offscreen context with invalid dimensions (%dx%d)",
@@ -503,12 +649,23 @@ static int gl_init(struct gpu_ctx *s)
     }
 #endif
 
+    /*
+     * The shared context handle is only used to create the context in its
+     * share group: an external context is already created by the user
+     */
+    uintptr_t shared_handle = 0;
+    if (s->shared_ctx && !external) {
+        const struct gpu_ctx_gl *shared_gl = (const struct gpu_ctx_gl *)s->shared_ctx;
+        shared_handle = ngli_glcontext_get_handle(shared_gl->glcontext);
+    }
+
     const struct glcontext_params params = {
         .platform      = config->platform,
         .backend       = config->backend,
         .external      = external,
         .display       = config->display,
         .window        = config->window,
+        .shared_ctx    = shared_handle,
         .swap_interval = config->swap_interval,
         .offscreen     = config->offscreen,
         .width         = config->width,
@@ -831,8 +988,13 @@ static int gl_end_draw(struct gpu_ctx *s, double t)
     const struct ngl_config *config = &s->config;
     const struct ngl_config_gl *config_gl = config->backend_config;
 
-    if (s_priv->capture_func && config->capture_buffer)
+    if (s_priv->capture_slots) {
+        int ret = capture_cpu_async(s, t);
+        if (ret < 0)
+            return ret;
+    } else if (s_priv->capture_func && config->capture_buffer) {
         s_priv->capture_func(s);
+    }
 
     int ret = ngli_glcontext_check_gl_error(gl, __func__);
 
@@ -991,6 +1153,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_##cls_suffix = {
     .init                               = gl_init,                               \
     .resize                             = gl_resize,                             \
     .set_capture_buffer                 = gl_set_capture_buffer,                 \
+    .flush_capture                      = gl_flush_capture,                      \
     .begin_update                       = gl_begin_update,                       \
     .end_update                         = gl_end_update,                         \
     .begin_draw                         = gl_begin_draw,                         \
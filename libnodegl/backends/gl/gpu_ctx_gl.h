@@ -41,6 +41,12 @@ struct rendertarget;
 
 typedef void (*capture_func_type)(struct gpu_ctx *s);
 
+struct capture_slot_gl {
+    GLuint pbo;
+    GLsync fence;
+    double t;
+};
+
 struct gpu_ctx_gl {
     struct gpu_ctx parent;
     struct glcontext *glcontext;
@@ -64,6 +70,12 @@ struct gpu_ctx_gl {
     CVPixelBufferRef capture_cvbuffer;
     CVOpenGLESTextureRef capture_cvtexture;
 #endif
+    /* Asynchronous capture ring of pixel pack buffers */
+    struct capture_slot_gl *capture_slots;
+    int nb_capture_slots;
+    int capture_slot_head; /* oldest pending capture */
+    int nb_pending_captures;
+    int capture_size;
     /* Timer */
     GLuint queries[2];
     void (*glGenQueries)(const struct glcontext *gl, GLsizei n, GLuint * ids);
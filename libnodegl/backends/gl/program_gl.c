@@ -19,6 +19,7 @@
  * under the License.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -253,10 +254,8 @@ struct program *ngli_program_gl_create(struct gpu_ctx *gpu_ctx)
     return (struct program *)s;
 }
 
-int ngli_program_gl_init(struct program *s, const struct program_params *params)
+static int program_compile_and_link(struct glcontext *gl, GLuint pid, const struct program_params *params)
 {
-    struct program_gl *s_priv = (struct program_gl *)s;
-
     int ret = 0;
     struct {
         const char *name;
@@ -269,17 +268,6 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
         [NGLI_PROGRAM_SHADER_COMP] = {"compute",  GL_COMPUTE_SHADER,  params->compute,  0},
     };
 
-    struct gpu_ctx_gl *gpu_ctx_gl = (struct gpu_ctx_gl *)s->gpu_ctx;
-    struct glcontext *gl = gpu_ctx_gl->glcontext;
-
-    const uint64_t features = NGLI_FEATURE_GL_COMPUTE_SHADER_ALL;
-    if (params->compute && (gl->features & features) != features) {
-        LOG(ERROR, "context does not support compute shaders");
-        return NGL_ERROR_GRAPHICS_UNSUPPORTED;
-    }
-
-    s_priv->id = ngli_glCreateProgram(gl);
-
     for (int i = 0; i < NGLI_ARRAY_NB(shaders); i++) {
         if (!shaders[i].src)
             continue;
@@ -295,13 +283,13 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
                     params->label ? params->label : "", s_with_numbers);
                 ngli_free(s_with_numbers);
             }
-            goto fail;
+            goto end;
         }
-        ngli_glAttachShader(gl, s_priv->id, shader);
+        ngli_glAttachShader(gl, pid, shader);
     }
 
-    ngli_glLinkProgram(gl, s_priv->id);
-    ret = program_check_status(gl, s_priv->id, GL_LINK_STATUS);
+    ngli_glLinkProgram(gl, pid);
+    ret = program_check_status(gl, pid, GL_LINK_STATUS);
     if (ret < 0) {
         struct bstr *bstr = ngli_bstr_create();
         if (bstr) {
@@ -319,26 +307,154 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
             LOG(ERROR, "%s", ngli_bstr_strptr(bstr));
             ngli_bstr_freep(&bstr);
         }
-        goto fail;
     }
 
+end:
     for (int i = 0; i < NGLI_ARRAY_NB(shaders); i++)
         ngli_glDeleteShader(gl, shaders[i].id);
 
-    s->uniforms = program_probe_uniforms(gl, s_priv->id);
-    s->attributes = program_probe_attributes(gl, s_priv->id);
-    s->buffer_blocks = program_probe_buffer_blocks(gl, s_priv->id);
-    if (!s->uniforms || !s->attributes || !s->buffer_blocks) {
-        ret = NGL_ERROR_MEMORY;
-        goto fail;
+    return ret;
+}
+
+/*
+ * The program binaries are only valid for the exact same driver, so the
+ * cache key includes the driver identification strings along with the
+ * shader sources.
+ */
+static char *get_program_cache_key(struct glcontext *gl, const struct program_params *params)
+{
+    struct bstr *bstr = ngli_bstr_create();
+    if (!bstr)
+        return NULL;
+
+    ngli_bstr_printf(bstr, "gl:%d:%s:%s:%s", gl->backend,
+                     (const char *)ngli_glGetString(gl, GL_VENDOR),
+                     (const char *)ngli_glGetString(gl, GL_RENDERER),
+                     (const char *)ngli_glGetString(gl, GL_VERSION));
+
+    const char *srcs[] = {params->vertex, params->fragment, params->compute};
+    for (int i = 0; i < NGLI_ARRAY_NB(srcs); i++)
+        ngli_bstr_printf(bstr, "\n--%d--\n%s", i, srcs[i] ? srcs[i] : "");
+
+    char *key = ngli_bstr_check(bstr) < 0 ? NULL : ngli_bstr_strdup(bstr);
+    ngli_bstr_freep(&bstr);
+    return key;
+}
+
+static int program_load_binary(struct glcontext *gl, struct diskcache *cache,
+                               GLuint pid, const char *key)
+{
+    void *data;
+    size_t size;
+    int ret = ngli_diskcache_load(cache, key, &data, &size);
+    if (ret < 0)
+        return ret;
+
+    if (size <= sizeof(uint32_t) || size - sizeof(uint32_t) > INT_MAX) {
+        ngli_free(data);
+        ngli_diskcache_reject(cache);
+        return NGL_ERROR_NOT_FOUND;
+    }
+
+    uint32_t format;
+    memcpy(&format, data, sizeof(format));
+    ngli_glProgramBinary(gl, pid, format, (const uint8_t *)data + sizeof(format),
+                         (GLsizei)(size - sizeof(format)));
+    ngli_free(data);
+
+    /*
+     * The binary can be rejected by the driver (typically after an update
+     * not reflected in the version string), in which case the program is
+     * rebuilt from its sources.
+     */
+    GLint status = GL_FALSE;
+    ngli_glGetProgramiv(gl, pid, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        LOG(DEBUG, "cached program binary rejected by the driver");
+        ngli_diskcache_reject(cache);
+        return NGL_ERROR_NOT_FOUND;
     }
 
     return 0;
+}
 
-fail:
-    for (int i = 0; i < NGLI_ARRAY_NB(shaders); i++)
-        ngli_glDeleteShader(gl, shaders[i].id);
+static void program_store_binary(struct glcontext *gl, struct diskcache *cache,
+                                 GLuint pid, const char *key)
+{
+    GLint length = 0;
+    ngli_glGetProgramiv(gl, pid, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    const size_t size = sizeof(uint32_t) + length;
+    uint8_t *data = ngli_malloc(size);
+    if (!data)
+        return;
+
+    GLenum format = 0;
+    ngli_glGetProgramBinary(gl, pid, length, NULL, &format, data + sizeof(uint32_t));
+    const uint32_t format_u32 = format;
+    memcpy(data, &format_u32, sizeof(format_u32));
+
+    ngli_diskcache_store(cache, key, data, size);
+    ngli_free(data);
+}
+
+int ngli_program_gl_init(struct program *s, const struct program_params *params)
+{
+    struct program_gl *s_priv = (struct program_gl *)s;
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    struct gpu_ctx_gl *gpu_ctx_gl = (struct gpu_ctx_gl *)gpu_ctx;
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    const uint64_t features = NGLI_FEATURE_GL_COMPUTE_SHADER_ALL;
+    if (params->compute && (gl->features & features) != features) {
+        LOG(ERROR, "context does not support compute shaders");
+        return NGL_ERROR_GRAPHICS_UNSUPPORTED;
+    }
+
+    char *cache_key = NULL;
+    struct diskcache *cache = &gpu_ctx->program_cache;
+    if (ngli_diskcache_enabled(cache) && (gl->features & NGLI_FEATURE_GL_GET_PROGRAM_BINARY)) {
+        cache_key = get_program_cache_key(gl, params);
+        if (!cache_key)
+            return NGL_ERROR_MEMORY;
+    }
+
+    s_priv->id = ngli_glCreateProgram(gl);
+
+    int ret = NGL_ERROR_NOT_FOUND;
+    if (cache_key) {
+        ret = program_load_binary(gl, cache, s_priv->id, cache_key);
+        if (ret == NGL_ERROR_NOT_FOUND) {
+            /* Restart from a fresh program object in case the load failed */
+            ngli_glDeleteProgram(gl, s_priv->id);
+            s_priv->id = ngli_glCreateProgram(gl);
+            ngli_glProgramParameteri(gl, s_priv->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        } else if (ret < 0) {
+            goto end;
+        }
+    }
+
+    if (ret == NGL_ERROR_NOT_FOUND) {
+        ret = program_compile_and_link(gl, s_priv->id, params);
+        if (ret < 0)
+            goto end;
+        /* Failing to populate the cache is not fatal */
+        if (cache_key)
+            program_store_binary(gl, cache, s_priv->id, cache_key);
+    }
+
+    s->uniforms = program_probe_uniforms(gl, s_priv->id);
+    s->attributes = program_probe_attributes(gl, s_priv->id);
+    s->buffer_blocks = program_probe_buffer_blocks(gl, s_priv->id);
+    if (!s->uniforms || !s->attributes || !s->buffer_blocks)
+        ret = NGL_ERROR_MEMORY;
+    else
+        ret = 0;
 
+end:
+    ngli_free(cache_key);
     return ret;
 }
 
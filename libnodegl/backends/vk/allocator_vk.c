@@ -0,0 +1,388 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "allocator_vk.h"
+#include "darray.h"
+#include "log.h"
+#include "memory.h"
+#include "utils.h"
+
+#define DEFAULT_BLOCK_SIZE (32 * 1024 * 1024)
+
+/* Fraction of the heap size above which the blocks are shrunk */
+#define MAX_HEAP_FRACTION 8
+
+enum {
+    POOL_KIND_BUFFER,
+    POOL_KIND_IMAGE,
+    NB_POOL_KINDS
+};
+
+struct memrange {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct memblock_vk {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    void *mapped_data;
+    struct darray free_ranges; /* struct memrange, sorted by offset */
+    int nb_allocations;
+    struct mempool_vk *pool; /* NULL for dedicated allocations */
+};
+
+struct mempool_vk {
+    struct darray blocks; /* struct memblock_vk * */
+    VkDeviceSize block_size;
+};
+
+struct allocator_vk {
+    struct vkcontext *vk;
+    struct mempool_vk pools[NB_POOL_KINDS][VK_MAX_MEMORY_TYPES];
+
+    /* Statistics */
+    int64_t nb_blocks;
+    int64_t nb_allocations;
+    uint64_t reserved_size;
+    uint64_t used_size;
+};
+
+struct allocator_vk *ngli_allocator_vk_create(struct vkcontext *vk)
+{
+    struct allocator_vk *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->vk = vk;
+
+    const VkPhysicalDeviceMemoryProperties *mem_props = &vk->phydev_mem_props;
+    for (int i = 0; i < NB_POOL_KINDS; i++) {
+        for (uint32_t j = 0; j < VK_MAX_MEMORY_TYPES; j++) {
+            struct mempool_vk *pool = &s->pools[i][j];
+            ngli_darray_init(&pool->blocks, sizeof(struct memblock_vk *), 0);
+            if (j >= mem_props->memoryTypeCount)
+                continue;
+            const uint32_t heap_index = mem_props->memoryTypes[j].heapIndex;
+            const VkDeviceSize heap_size = mem_props->memoryHeaps[heap_index].size;
+            pool->block_size = NGLI_MIN(DEFAULT_BLOCK_SIZE, heap_size / MAX_HEAP_FRACTION);
+        }
+    }
+
+    return s;
+}
+
+static VkResult create_block(struct allocator_vk *s, VkDeviceSize size, uint32_t mem_type_index,
+                             struct memblock_vk **blockp)
+{
+    struct vkcontext *vk = s->vk;
+
+    struct memblock_vk *block = ngli_calloc(1, sizeof(*block));
+    if (!block)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    ngli_darray_init(&block->free_ranges, sizeof(struct memrange), 0);
+
+    const VkMemoryAllocateInfo allocate_info = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize  = size,
+        .memoryTypeIndex = mem_type_index,
+    };
+    VkResult res = vkAllocateMemory(vk->device, &allocate_info, NULL, &block->memory);
+    if (res != VK_SUCCESS) {
+        ngli_free(block);
+        return res;
+    }
+    block->size = size;
+
+    const VkMemoryPropertyFlags props = vk->phydev_mem_props.memoryTypes[mem_type_index].propertyFlags;
+    if (props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        res = vkMapMemory(vk->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped_data);
+        if (res != VK_SUCCESS) {
+            vkFreeMemory(vk->device, block->memory, NULL);
+            ngli_free(block);
+            return res;
+        }
+    }
+
+    s->nb_blocks++;
+    s->reserved_size += size;
+
+    *blockp = block;
+    return VK_SUCCESS;
+}
+
+static void destroy_block(struct allocator_vk *s, struct memblock_vk *block)
+{
+    struct vkcontext *vk = s->vk;
+
+    if (block->mapped_data)
+        vkUnmapMemory(vk->device, block->memory);
+    vkFreeMemory(vk->device, block->memory, NULL);
+    ngli_darray_reset(&block->free_ranges);
+
+    s->nb_blocks--;
+    s->reserved_size -= block->size;
+
+    ngli_free(block);
+}
+
+static int insert_range(struct darray *ranges_array, int index, const struct memrange *range)
+{
+    if (!ngli_darray_push(ranges_array, range))
+        return NGL_ERROR_MEMORY;
+    struct memrange *ranges = ngli_darray_data(ranges_array);
+    const int count = ngli_darray_count(ranges_array);
+    memmove(&ranges[index + 1], &ranges[index], (count - index - 1) * sizeof(*ranges));
+    ranges[index] = *range;
+    return 0;
+}
+
+/*
+ * Carve an allocation from the first free range able to hold it, return 0 if
+ * the block has no room for it.
+ */
+static int block_alloc(struct memblock_vk *block, VkDeviceSize size, VkDeviceSize alignment,
+                       VkDeviceSize *offsetp)
+{
+    struct darray *ranges_array = &block->free_ranges;
+    struct memrange *ranges = ngli_darray_data(ranges_array);
+    for (int i = 0; i < ngli_darray_count(ranges_array); i++) {
+        const struct memrange range = ranges[i];
+        const VkDeviceSize offset = NGLI_ALIGN(range.offset, alignment);
+        const VkDeviceSize end = range.offset + range.size;
+        if (offset + size > end)
+            continue;
+
+        const struct memrange head = {.offset = range.offset, .size = offset - range.offset};
+        const struct memrange tail = {.offset = offset + size, .size = end - offset - size};
+        if (head.size && tail.size) {
+            /*
+             * The tail is inserted first so the free ranges are left
+             * untouched if it fails; the insertion may also reallocate the
+             * ranges array
+             */
+            if (insert_range(ranges_array, i + 1, &tail) < 0)
+                return NGL_ERROR_MEMORY;
+            ranges = ngli_darray_data(ranges_array);
+            ranges[i] = head;
+        } else if (head.size) {
+            ranges[i] = head;
+        } else if (tail.size) {
+            ranges[i] = tail;
+        } else {
+            ngli_darray_remove(ranges_array, i);
+        }
+
+        block->nb_allocations++;
+        *offsetp = offset;
+        return 1;
+    }
+    return 0;
+}
+
+static int block_free(struct memblock_vk *block, VkDeviceSize offset, VkDeviceSize size)
+{
+    struct darray *ranges_array = &block->free_ranges;
+    struct memrange *ranges = ngli_darray_data(ranges_array);
+    const int count = ngli_darray_count(ranges_array);
+
+    int index = 0;
+    while (index < count && ranges[index].offset < offset)
+        index++;
+
+    const int merge_prev = index > 0 && ranges[index - 1].offset + ranges[index - 1].size == offset;
+    const int merge_next = index < count && offset + size == ranges[index].offset;
+
+    block->nb_allocations--;
+
+    if (merge_prev && merge_next) {
+        ranges[index - 1].size += size + ranges[index].size;
+        ngli_darray_remove(ranges_array, index);
+    } else if (merge_prev) {
+        ranges[index - 1].size += size;
+    } else if (merge_next) {
+        ranges[index].offset = offset;
+        ranges[index].size += size;
+    } else {
+        const struct memrange range = {.offset = offset, .size = size};
+        return insert_range(ranges_array, index, &range);
+    }
+    return 0;
+}
+
+VkResult ngli_allocator_vk_alloc(struct allocator_vk *s, const VkMemoryRequirements *reqs,
+                                 int mem_type_index, int flags, struct allocation_vk *allocation)
+{
+    memset(allocation, 0, sizeof(*allocation));
+
+    const int kind = (flags & NGLI_ALLOCATION_VK_FLAG_IMAGE) ? POOL_KIND_IMAGE : POOL_KIND_BUFFER;
+    struct mempool_vk *pool = &s->pools[kind][mem_type_index];
+    const VkDeviceSize alignment = NGLI_MAX(reqs->alignment, 1);
+
+    struct memblock_vk *block = NULL;
+    VkDeviceSize offset = 0;
+
+    if ((flags & NGLI_ALLOCATION_VK_FLAG_DEDICATED) || reqs->size > pool->block_size / 2) {
+        VkResult res = create_block(s, reqs->size, mem_type_index, &block);
+        if (res != VK_SUCCESS)
+            return res;
+        block->nb_allocations = 1;
+    } else {
+        struct memblock_vk **blocks = ngli_darray_data(&pool->blocks);
+        for (int i = 0; i < ngli_darray_count(&pool->blocks); i++) {
+            int ret = block_alloc(blocks[i], reqs->size, alignment, &offset);
+            if (ret < 0)
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            if (ret) {
+                block = blocks[i];
+                break;
+            }
+        }
+
+        if (!block) {
+            VkResult res = create_block(s, pool->block_size, mem_type_index, &block);
+            if (res != VK_SUCCESS)
+                return res;
+            block->pool = pool;
+
+            const struct memrange range = {.offset = 0, .size = pool->block_size};
+            if (!ngli_darray_push(&block->free_ranges, &range) ||
+                !ngli_darray_push(&pool->blocks, &block)) {
+                destroy_block(s, block);
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+
+            LOG(DEBUG, "new memory block of %" PRIu64 " bytes for memory type %d (%s)",
+                (uint64_t)pool->block_size, mem_type_index, kind == POOL_KIND_IMAGE ? "images" : "buffers");
+
+            int ret = block_alloc(block, reqs->size, alignment, &offset);
+            if (ret < 0)
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            ngli_assert(ret);
+        }
+    }
+
+    allocation->block       = block;
+    allocation->memory      = block->memory;
+    allocation->offset      = offset;
+    allocation->size        = reqs->size;
+    allocation->mapped_data = block->mapped_data ? (uint8_t *)block->mapped_data + offset : NULL;
+
+    s->nb_allocations++;
+    s->used_size += reqs->size;
+
+    return VK_SUCCESS;
+}
+
+void ngli_allocator_vk_free(struct allocator_vk *s, struct allocation_vk *allocation)
+{
+    struct memblock_vk *block = allocation->block;
+    if (!block)
+        return;
+
+    s->nb_allocations--;
+    s->used_size -= allocation->size;
+
+    struct mempool_vk *pool = block->pool;
+    if (!pool) {
+        destroy_block(s, block);
+        memset(allocation, 0, sizeof(*allocation));
+        return;
+    }
+
+    if (block_free(block, allocation->offset, allocation->size) < 0)
+        LOG(ERROR, "could not track freed memory range, %" PRIu64 " bytes are lost",
+            (uint64_t)allocation->size);
+    memset(allocation, 0, sizeof(*allocation));
+
+    /*
+     * Release the empty blocks, except if this is the last one of the pool
+     * to prevent allocation trashing with short lived resources (such as
+     * staging buffers)
+     */
+    if (block->nb_allocations || ngli_darray_count(&pool->blocks) == 1)
+        return;
+
+    struct memblock_vk **blocks = ngli_darray_data(&pool->blocks);
+    for (int i = 0; i < ngli_darray_count(&pool->blocks); i++) {
+        if (blocks[i] == block) {
+            ngli_darray_remove(&pool->blocks, i);
+            break;
+        }
+    }
+    destroy_block(s, block);
+}
+
+void ngli_allocator_vk_get_stats(const struct allocator_vk *s, struct gpu_memory_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->nb_blocks      = s->nb_blocks;
+    stats->nb_allocations = s->nb_allocations;
+    stats->reserved_size  = s->reserved_size;
+    stats->used_size      = s->used_size;
+
+    /*
+     * The fragmented memory is the free memory that is not part of the
+     * largest free range of its block, and thus only usable by the
+     * allocations smaller than the block size
+     */
+    for (int i = 0; i < NB_POOL_KINDS; i++) {
+        for (int j = 0; j < VK_MAX_MEMORY_TYPES; j++) {
+            const struct mempool_vk *pool = &s->pools[i][j];
+            struct memblock_vk **blocks = ngli_darray_data(&pool->blocks);
+            for (int k = 0; k < ngli_darray_count(&pool->blocks); k++) {
+                const struct darray *ranges_array = &blocks[k]->free_ranges;
+                const struct memrange *ranges = ngli_darray_data(ranges_array);
+                VkDeviceSize free_size = 0;
+                VkDeviceSize largest_size = 0;
+                for (int l = 0; l < ngli_darray_count(ranges_array); l++) {
+                    free_size += ranges[l].size;
+                    largest_size = NGLI_MAX(largest_size, ranges[l].size);
+                }
+                stats->fragmented_size += free_size - largest_size;
+            }
+        }
+    }
+}
+
+void ngli_allocator_vk_freep(struct allocator_vk **sp)
+{
+    struct allocator_vk *s = *sp;
+    if (!s)
+        return;
+
+    if (s->nb_allocations)
+        LOG(WARNING, "%" PRId64 " device memory allocation(s) still alive", s->nb_allocations);
+
+    for (int i = 0; i < NB_POOL_KINDS; i++) {
+        for (int j = 0; j < VK_MAX_MEMORY_TYPES; j++) {
+            struct mempool_vk *pool = &s->pools[i][j];
+            struct memblock_vk **blocks = ngli_darray_data(&pool->blocks);
+            for (int k = 0; k < ngli_darray_count(&pool->blocks); k++)
+                destroy_block(s, blocks[k]);
+            ngli_darray_reset(&pool->blocks);
+        }
+    }
+
+    ngli_freep(sp);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ALLOCATOR_VK_H
+#define ALLOCATOR_VK_H
+
+#include <vulkan/vulkan.h>
+
+#include "gpu_ctx.h"
+#include "vkcontext.h"
+
+/* The memory is bound to an image (and not a buffer) */
+#define NGLI_ALLOCATION_VK_FLAG_IMAGE     (1 << 0)
+
+/* The memory gets its own VkDeviceMemory object instead of being pooled */
+#define NGLI_ALLOCATION_VK_FLAG_DEDICATED (1 << 1)
+
+struct memblock_vk;
+
+struct allocation_vk {
+    struct memblock_vk *block;
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void *mapped_data; /* persistently mapped, NULL if the memory is not host visible */
+};
+
+/*
+ * Device memory allocator sub-allocating the resources from large blocks of
+ * memory, with one pool of blocks per memory type and per resource kind
+ * (buffers and images are never mixed within a block so the
+ * bufferImageGranularity constraint does not need to be honored).
+ *
+ * Each block tracks its free ranges sorted by offset: allocations are served
+ * from the first fitting range and freed ranges are merged with their
+ * neighbours. Large resources and resources flagged as dedicated get their own
+ * device memory object.
+ */
+struct allocator_vk;
+
+struct allocator_vk *ngli_allocator_vk_create(struct vkcontext *vk);
+VkResult ngli_allocator_vk_alloc(struct allocator_vk *s, const VkMemoryRequirements *reqs,
+                                 int mem_type_index, int flags, struct allocation_vk *allocation);
+void ngli_allocator_vk_free(struct allocator_vk *s, struct allocation_vk *allocation);
+void ngli_allocator_vk_get_stats(const struct allocator_vk *s, struct gpu_memory_stats *stats);
+void ngli_allocator_vk_freep(struct allocator_vk **sp);
+
+#endif
@@ -25,8 +25,10 @@ const struct api_impl api_vk = {
     .configure          = ngli_ctx_configure,
     .resize             = ngli_ctx_resize,
     .set_capture_buffer = ngli_ctx_set_capture_buffer,
+    .flush_capture      = ngli_ctx_flush_capture,
     .set_scene          = ngli_ctx_set_scene,
     .prepare_draw       = ngli_ctx_prepare_draw,
     .draw               = ngli_ctx_draw,
+    .draw_times         = ngli_ctx_draw_times,
     .reset              = ngli_ctx_reset,
 };
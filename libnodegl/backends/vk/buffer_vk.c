@@ -26,17 +26,19 @@
 #include "gpu_ctx_vk.h"
 #include "internal.h"
 #include "memory.h"
+#include "staging_vk.h"
 #include "vkcontext.h"
 
-static VkResult create_vk_buffer(struct vkcontext *vk,
+static VkResult create_vk_buffer(struct gpu_ctx_vk *gpu_ctx_vk,
                                  VkDeviceSize size,
                                  VkBufferUsageFlags usage,
                                  VkMemoryPropertyFlags mem_props,
                                  VkBuffer *bufferp,
-                                 VkDeviceMemory *memoryp)
+                                 struct allocation_vk *memoryp)
 {
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     VkBuffer buffer = VK_NULL_HANDLE;
-    VkDeviceMemory memory = VK_NULL_HANDLE;
+    struct allocation_vk memory = {0};
 
     const VkBufferCreateInfo buffer_create_info = {
         .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -62,16 +64,11 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
         }
     }
 
-    const VkMemoryAllocateInfo memory_allocate_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
-    };
-    res = vkAllocateMemory(vk->device, &memory_allocate_info, NULL, &memory);
+    res = ngli_allocator_vk_alloc(gpu_ctx_vk->allocator, &mem_reqs, mem_type_index, 0, &memory);
     if (res != VK_SUCCESS)
         goto fail;
 
-    res = vkBindBufferMemory(vk->device, buffer, memory, 0);
+    res = vkBindBufferMemory(vk->device, buffer, memory.memory, memory.offset);
     if (res != VK_SUCCESS)
         goto fail;
 
@@ -82,7 +79,7 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
 
 fail:
     vkDestroyBuffer(vk->device, buffer, NULL);
-    vkFreeMemory(vk->device, memory, NULL);
+    ngli_allocator_vk_free(gpu_ctx_vk->allocator, &memory);
     return res;
 }
 
@@ -108,7 +105,6 @@ struct buffer *ngli_buffer_vk_create(struct gpu_ctx *gpu_ctx)
 VkResult ngli_buffer_vk_init(struct buffer *s, int size, int usage)
 {
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
     s->size = size;
@@ -128,7 +124,7 @@ VkResult ngli_buffer_vk_init(struct buffer *s, int size, int usage)
     }
 
     const VkBufferUsageFlags flags = get_vk_buffer_usage_flags(usage);
-    return create_vk_buffer(vk, size, flags, mem_props, &s_priv->buffer, &s_priv->memory);
+    return create_vk_buffer(gpu_ctx_vk, size, flags, mem_props, &s_priv->buffer, &s_priv->memory);
 }
 
 VkResult ngli_buffer_vk_upload(struct buffer *s, const void *data, int size, int offset)
@@ -146,64 +142,38 @@ VkResult ngli_buffer_vk_upload(struct buffer *s, const void *data, int size, int
     }
 
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
-    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    const VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    VkResult res = create_vk_buffer(vk, s->size, usage, mem_props,
-                                    &s_priv->staging_buffer, &s_priv->staging_memory);
+    struct staging_upload_vk upload;
+    VkResult res = ngli_staging_vk_begin_upload(gpu_ctx_vk->staging, size, 4, &upload);
     if (res != VK_SUCCESS)
         return res;
 
-    uint8_t *mapped_data;
-    res = vkMapMemory(vk->device, s_priv->staging_memory, 0, s->size, 0, (void *)&mapped_data);
-    if (res != VK_SUCCESS)
-        return res;
-    memcpy(mapped_data + offset, data, size);
-    vkUnmapMemory(vk->device, s_priv->staging_memory);
-
-    struct cmd_vk *cmd_vk;
-    res = ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &cmd_vk);
-    if (res != VK_SUCCESS)
-        return res;
+    memcpy(upload.mapped_data, data, size);
 
     const VkBufferCopy region = {
-        .srcOffset = 0,
+        .srcOffset = upload.offset,
         .dstOffset = offset,
         .size      = size,
     };
-    vkCmdCopyBuffer(cmd_vk->cmd_buf, s_priv->staging_buffer, s_priv->buffer, 1, &region);
+    vkCmdCopyBuffer(upload.cmd->cmd_buf, upload.buffer, s_priv->buffer, 1, &region);
 
-    res = ngli_cmd_vk_execute_transient(&cmd_vk);
-    if (res != VK_SUCCESS)
-        return res;
-
-    vkDestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
-    s_priv->staging_buffer = VK_NULL_HANDLE;
-    vkFreeMemory(vk->device, s_priv->staging_memory, NULL);
-    s_priv->staging_memory = VK_NULL_HANDLE;
-
-    return VK_SUCCESS;
+    return ngli_staging_vk_end_upload(gpu_ctx_vk->staging, &upload);
 }
 
 VkResult ngli_buffer_vk_map(struct buffer *s, int size, int offset, void **data)
 {
-    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
-    return vkMapMemory(vk->device, s_priv->memory, offset, size, 0, data);
+    /* Host visible memory blocks are persistently mapped by the allocator */
+    if (!s_priv->memory.mapped_data)
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    *data = (uint8_t *)s_priv->memory.mapped_data + offset;
+    return VK_SUCCESS;
 }
 
 void ngli_buffer_vk_unmap(struct buffer *s)
 {
-    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
-    struct buffer_vk *s_priv = (struct buffer_vk *)s;
-
-    vkUnmapMemory(vk->device, s_priv->memory);
 }
 
 void ngli_buffer_vk_freep(struct buffer **sp)
@@ -217,8 +187,6 @@ void ngli_buffer_vk_freep(struct buffer **sp)
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
     vkDestroyBuffer(vk->device, s_priv->buffer, NULL);
-    vkFreeMemory(vk->device, s_priv->memory, NULL);
-    vkDestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
-    vkFreeMemory(vk->device, s_priv->staging_memory, NULL);
+    ngli_allocator_vk_free(gpu_ctx_vk->allocator, &s_priv->memory);
     ngli_freep(sp);
 }
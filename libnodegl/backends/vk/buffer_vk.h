@@ -24,14 +24,13 @@
 
 #include <vulkan/vulkan.h>
 
+#include "allocator_vk.h"
 #include "buffer.h"
 
 struct buffer_vk {
     struct buffer parent;
     VkBuffer buffer;
-    VkDeviceMemory memory;
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
+    struct allocation_vk memory;
 };
 
 struct buffer *ngli_buffer_vk_create(struct gpu_ctx *gpu_ctx);
@@ -138,7 +138,9 @@ VkResult ngli_cmd_vk_submit(struct cmd_vk *s)
         .pSignalSemaphores    = ngli_darray_data(&s->signal_sems),
     };
 
+    ngli_vkcontext_lock_queues(vk);
     res = vkQueueSubmit(vk->graphic_queue, 1, &submit_info, s->fence);
+    ngli_vkcontext_unlock_queues(vk);
     if (res != VK_SUCCESS)
         return res;
 
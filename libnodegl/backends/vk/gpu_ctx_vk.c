@@ -21,6 +21,7 @@
 
 #include <string.h>
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 
@@ -31,6 +32,8 @@
 #include "log.h"
 #include "math_utils.h"
 #include "memory.h"
+#include "uniform_ring.h"
+#include "utils.h"
 
 #include "buffer_vk.h"
 #include "format_vk.h"
@@ -267,6 +270,39 @@ static VkResult create_render_resources(struct gpu_ctx *s)
         res = ngli_buffer_vk_map(s_priv->capture_buffer, s_priv->capture_buffer_size, 0, &s_priv->mapped_data);
         if (res != VK_SUCCESS)
             return res;
+
+        if (config->capture_async_depth) {
+            s_priv->capture_slots = ngli_calloc(config->capture_async_depth, sizeof(*s_priv->capture_slots));
+            if (!s_priv->capture_slots)
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+            s_priv->nb_capture_slots = config->capture_async_depth;
+
+            for (int i = 0; i < s_priv->nb_capture_slots; i++) {
+                struct capture_slot_vk *slot = &s_priv->capture_slots[i];
+                slot->buffer = ngli_buffer_vk_create(s);
+                if (!slot->buffer)
+                    return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+                res = ngli_buffer_vk_init(slot->buffer,
+                                          s_priv->capture_buffer_size,
+                                          NGLI_BUFFER_USAGE_MAP_READ |
+                                          NGLI_BUFFER_USAGE_TRANSFER_DST_BIT);
+                if (res != VK_SUCCESS)
+                    return res;
+
+                res = ngli_buffer_vk_map(slot->buffer, s_priv->capture_buffer_size, 0, &slot->mapped_data);
+                if (res != VK_SUCCESS)
+                    return res;
+
+                slot->cmd = ngli_cmd_vk_create(s);
+                if (!slot->cmd)
+                    return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+                res = ngli_cmd_vk_init(slot->cmd, 0);
+                if (res != VK_SUCCESS)
+                    return res;
+            }
+        }
     }
 
     return VK_SUCCESS;
@@ -306,6 +342,18 @@ static void destroy_render_resources(struct gpu_ctx *s)
         s_priv->mapped_data = NULL;
     }
     ngli_buffer_vk_freep(&s_priv->capture_buffer);
+
+    for (int i = 0; i < s_priv->nb_capture_slots; i++) {
+        struct capture_slot_vk *slot = &s_priv->capture_slots[i];
+        if (slot->mapped_data)
+            ngli_buffer_vk_unmap(slot->buffer);
+        ngli_buffer_vk_freep(&slot->buffer);
+        ngli_cmd_vk_freep(&slot->cmd);
+    }
+    ngli_freep(&s_priv->capture_slots);
+    s_priv->nb_capture_slots = 0;
+    s_priv->capture_slot_head = 0;
+    s_priv->nb_pending_captures = 0;
 }
 
 static VkResult create_query_pool(struct gpu_ctx *s)
@@ -330,6 +378,85 @@ static void destroy_query_pool(struct gpu_ctx *s)
     vkDestroyQueryPool(vk->device, s_priv->query_pool, NULL);
 }
 
+static char *get_pipeline_cache_key(const struct vkcontext *vk)
+{
+    const VkPhysicalDeviceProperties *props = &vk->phy_device_props;
+    char uuid[2 * VK_UUID_SIZE + 1];
+    for (int i = 0; i < VK_UUID_SIZE; i++)
+        snprintf(uuid + 2 * i, 3, "%02x", props->pipelineCacheUUID[i]);
+    return ngli_asprintf("vk:pipeline_cache:%08x:%08x:%08x:%s",
+                         props->vendorID, props->deviceID, props->driverVersion, uuid);
+}
+
+static VkResult create_pipeline_cache(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    /* Pipeline caches are internally synchronized and can be used from any thread */
+    if (s->shared_ctx) {
+        const struct gpu_ctx_vk *shared_vk = (const struct gpu_ctx_vk *)s->shared_ctx;
+        s_priv->pipeline_cache = shared_vk->pipeline_cache;
+        return VK_SUCCESS;
+    }
+
+    void *data = NULL;
+    size_t size = 0;
+    if (ngli_diskcache_enabled(&s->program_cache)) {
+        char *key = get_pipeline_cache_key(vk);
+        if (!key)
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        int ret = ngli_diskcache_load(&s->program_cache, key, &data, &size);
+        ngli_free(key);
+        if (ret == NGL_ERROR_MEMORY)
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    /*
+     * The implementation checks the header of the initial data and silently
+     * ignores it if it is incompatible with the device.
+     */
+    const VkPipelineCacheCreateInfo create_info = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = size,
+        .pInitialData    = data,
+    };
+    VkResult res = vkCreatePipelineCache(vk->device, &create_info, NULL, &s_priv->pipeline_cache);
+    ngli_free(data);
+    return res;
+}
+
+static void destroy_pipeline_cache(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    if (!s_priv->pipeline_cache)
+        return;
+
+    if (s->shared_ctx) {
+        s_priv->pipeline_cache = VK_NULL_HANDLE;
+        return;
+    }
+
+    if (ngli_diskcache_enabled(&s->program_cache)) {
+        size_t size = 0;
+        VkResult res = vkGetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, NULL);
+        void *data = res == VK_SUCCESS && size ? ngli_malloc(size) : NULL;
+        if (data) {
+            res = vkGetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, data);
+            char *key = get_pipeline_cache_key(vk);
+            if (res == VK_SUCCESS && key)
+                ngli_diskcache_store(&s->program_cache, key, data, size);
+            ngli_free(key);
+            ngli_free(data);
+        }
+    }
+
+    vkDestroyPipelineCache(vk->device, s_priv->pipeline_cache, NULL);
+    s_priv->pipeline_cache = VK_NULL_HANDLE;
+}
+
 static VkResult create_command_pool_and_buffers(struct gpu_ctx *s)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
@@ -618,7 +745,9 @@ static VkResult recreate_swapchain(struct gpu_ctx *gpu_ctx, struct vkcontext *vk
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)gpu_ctx;
 
+    ngli_vkcontext_lock_queues(vk);
     VkResult res = vkDeviceWaitIdle(vk->device);
+    ngli_vkcontext_unlock_queues(vk);
     if (res != VK_SUCCESS)
         return res;
 
@@ -759,7 +888,9 @@ static VkResult swapchain_present_buffer(struct gpu_ctx *s, double t)
         present_info.pNext = &present_time_info;
     }
 
+    ngli_vkcontext_lock_queues(vk);
     VkResult res = vkQueuePresentKHR(vk->present_queue, &present_info);
+    ngli_vkcontext_unlock_queues(vk);
     switch (res) {
     case VK_SUCCESS:
     case VK_SUBOPTIMAL_KHR:
@@ -823,6 +954,10 @@ static int vk_init(struct gpu_ctx *s)
             LOG(ERROR, "capture_buffer is not supported by onscreen context");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (s->shared_ctx) {
+            LOG(ERROR, "shared context is only supported with offscreen rendering");
+            return NGL_ERROR_UNSUPPORTED;
+        }
     }
 
 #if DEBUG_GPU_CAPTURE
@@ -849,22 +984,33 @@ static int vk_init(struct gpu_ctx *s)
     ngli_darray_init(&s_priv->rts, sizeof(struct rendertarget *), 0);
     ngli_darray_init(&s_priv->rts_load, sizeof(struct rendertarget *), 0);
 
-    s_priv->vkcontext = ngli_vkcontext_create();
-    if (!s_priv->vkcontext)
-        return NGL_ERROR_MEMORY;
+    VkResult res;
+    if (s->shared_ctx) {
+        /* The device is owned by the shared context, which outlives this one */
+        const struct gpu_ctx_vk *shared_vk = (const struct gpu_ctx_vk *)s->shared_ctx;
+        s_priv->vkcontext = shared_vk->vkcontext;
+    } else {
+        s_priv->vkcontext = ngli_vkcontext_create();
+        if (!s_priv->vkcontext)
+            return NGL_ERROR_MEMORY;
 
-    VkResult res = ngli_vkcontext_init(s_priv->vkcontext, config);
-    if (res != VK_SUCCESS) {
-        LOG(ERROR, "unable to initialize Vulkan context: %s", ngli_vk_res2str(res));
-        /*
-         * Reset the failed vkcontext so if we do not end up calling vulkan
-         * functions on a partially initialized vkcontext in
-         * ngli_gpu_ctx_freep() / vk_destroy().
-         */
-        ngli_vkcontext_freep(&s_priv->vkcontext);
-        return ngli_vk_res2ret(res);
+        res = ngli_vkcontext_init(s_priv->vkcontext, config);
+        if (res != VK_SUCCESS) {
+            LOG(ERROR, "unable to initialize Vulkan context: %s", ngli_vk_res2str(res));
+            /*
+             * Reset the failed vkcontext so if we do not end up calling vulkan
+             * functions on a partially initialized vkcontext in
+             * ngli_gpu_ctx_freep() / vk_destroy().
+             */
+            ngli_vkcontext_freep(&s_priv->vkcontext);
+            return ngli_vk_res2ret(res);
+        }
     }
 
+    s_priv->allocator = ngli_allocator_vk_create(s_priv->vkcontext);
+    if (!s_priv->allocator)
+        return NGL_ERROR_MEMORY;
+
 #if DEBUG_GPU_CAPTURE
     if (s->gpu_capture)
         ngli_gpu_capture_begin(s->gpu_capture_ctx);
@@ -903,6 +1049,8 @@ static int vk_init(struct gpu_ctx *s)
      * direct Vulkan equivalent so use a sane default value */
     s->limits.max_texture_image_units            = 32;
     s->limits.max_uniform_block_size             = limits->maxUniformBufferRange;
+    s->limits.min_uniform_block_offset_alignment = limits->minUniformBufferOffsetAlignment;
+    s->limits.min_storage_block_offset_alignment = limits->minStorageBufferOffsetAlignment;
 
     if (config->set_surface_pts &&
         !ngli_vkcontext_has_extension(vk, VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME, 1)) {
@@ -923,6 +1071,10 @@ static int vk_init(struct gpu_ctx *s)
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
 
+    res = create_pipeline_cache(s);
+    if (res != VK_SUCCESS)
+        return ngli_vk_res2ret(res);
+
     res = create_semaphores(s);
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
@@ -931,6 +1083,14 @@ static int vk_init(struct gpu_ctx *s)
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
 
+    s_priv->staging = ngli_staging_vk_create(s, s_priv->nb_in_flight_frames);
+    if (!s_priv->staging)
+        return NGL_ERROR_MEMORY;
+
+    s->uniform_ring = ngli_uniform_ring_create(s, s_priv->nb_in_flight_frames);
+    if (!s->uniform_ring)
+        return NGL_ERROR_MEMORY;
+
     res = create_dummy_texture(s);
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
@@ -1002,6 +1162,52 @@ static int vk_set_capture_buffer(struct gpu_ctx *s, void *capture_buffer)
     return 0;
 }
 
+static void untrack_cmd(struct gpu_ctx *s, const struct cmd_vk *cmd)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    struct cmd_vk **cmds = ngli_darray_data(&s_priv->pending_cmds);
+    for (int i = 0; i < ngli_darray_count(&s_priv->pending_cmds); i++) {
+        if (cmds[i] == cmd) {
+            ngli_darray_remove(&s_priv->pending_cmds, i);
+            return;
+        }
+    }
+}
+
+static int capture_async_deliver(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    const struct ngl_config *config = &s->config;
+
+    struct capture_slot_vk *slot = &s_priv->capture_slots[s_priv->capture_slot_head];
+    s_priv->capture_slot_head = (s_priv->capture_slot_head + 1) % s_priv->nb_capture_slots;
+    s_priv->nb_pending_captures--;
+
+    /* The slot command buffer only contains the copy of this capture */
+    VkResult res = ngli_cmd_vk_wait(slot->cmd);
+    if (res != VK_SUCCESS)
+        return ngli_vk_res2ret(res);
+
+    config->capture_callback(config->capture_callback_arg, slot->t,
+                             slot->mapped_data, s_priv->capture_buffer_size);
+
+    return 0;
+}
+
+static int vk_flush_capture(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    while (s_priv->nb_pending_captures) {
+        int ret = capture_async_deliver(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 static int vk_begin_update(struct gpu_ctx *s, double t)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
@@ -1020,6 +1226,14 @@ static int vk_begin_update(struct gpu_ctx *s, double t)
         return res;
 
     s_priv->cur_frame_index = (s_priv->cur_frame_index + 1) % s_priv->nb_in_flight_frames;
+    s_priv->frame_count++;
+
+    /*
+     * All the pending commands have completed, the staging memory and the
+     * uniform data can be recycled
+     */
+    ngli_staging_vk_begin_frame(s_priv->staging, s_priv->cur_frame_index);
+    ngli_uniform_ring_begin_frame(s->uniform_ring, s_priv->cur_frame_index);
 
     s_priv->cur_cmd = s_priv->update_cmds[s_priv->cur_frame_index];
     return ngli_cmd_vk_begin(s_priv->cur_cmd);
@@ -1141,7 +1355,44 @@ static int vk_end_draw(struct gpu_ctx *s, double t)
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
 
     if (config->offscreen) {
-        if (config->capture_buffer) {
+        if (s_priv->capture_slots) {
+            VkResult res = ngli_cmd_vk_submit(s_priv->cur_cmd);
+            if (res != VK_SUCCESS)
+                return ngli_vk_res2ret(res);
+
+            /* The ring is full: the oldest capture must be delivered to free a slot */
+            if (s_priv->nb_pending_captures == s_priv->nb_capture_slots) {
+                int ret = capture_async_deliver(s);
+                if (ret < 0)
+                    return ret;
+            }
+
+            const int index = (s_priv->capture_slot_head + s_priv->nb_pending_captures) % s_priv->nb_capture_slots;
+            struct capture_slot_vk *slot = &s_priv->capture_slots[index];
+
+            /*
+             * The copy is recorded in the slot own command buffer, submitted
+             * after the frame one on the same queue. It is only waited for
+             * when the capture is delivered, so it is not tracked along with
+             * the frame commands which are waited for at the next update.
+             */
+            res = ngli_cmd_vk_begin(slot->cmd);
+            if (res != VK_SUCCESS)
+                return ngli_vk_res2ret(res);
+
+            s_priv->cur_cmd = slot->cmd;
+            struct texture **colors = ngli_darray_data(&s_priv->colors);
+            struct texture *color = colors[s_priv->cur_frame_index];
+            ngli_texture_vk_copy_to_buffer(color, slot->buffer);
+
+            res = ngli_cmd_vk_submit(slot->cmd);
+            if (res != VK_SUCCESS)
+                return ngli_vk_res2ret(res);
+            untrack_cmd(s, slot->cmd);
+
+            slot->t = t;
+            s_priv->nb_pending_captures++;
+        } else if (config->capture_buffer) {
             struct texture **colors = ngli_darray_data(&s_priv->colors);
             struct texture *color = colors[s_priv->cur_frame_index];
             ngli_texture_vk_copy_to_buffer(color, s_priv->capture_buffer);
@@ -1185,7 +1436,12 @@ static void vk_destroy(struct gpu_ctx *s)
     if (!vk)
         return;
 
+    ngli_vkcontext_lock_queues(vk);
     vkDeviceWaitIdle(vk->device);
+    ngli_vkcontext_unlock_queues(vk);
+
+    if (s_priv->capture_slots)
+        vk_flush_capture(s);
 
 #if DEBUG_GPU_CAPTURE
     if (s->gpu_capture)
@@ -1193,23 +1449,39 @@ static void vk_destroy(struct gpu_ctx *s)
     ngli_gpu_capture_freep(&s->gpu_capture_ctx);
 #endif
 
+    /* The capture slots command buffers must be released before their pool */
+    destroy_render_resources(s);
     destroy_command_pool_and_buffers(s);
     destroy_semaphores(s);
     destroy_dummy_texture(s);
-    destroy_render_resources(s);
+    ngli_staging_vk_freep(&s_priv->staging);
+    ngli_uniform_ring_freep(&s->uniform_ring);
     destroy_swapchain(s);
     destroy_query_pool(s);
+    destroy_pipeline_cache(s);
 
     ngli_glslang_uninit();
 
-    ngli_vkcontext_freep(&s_priv->vkcontext);
+    ngli_allocator_vk_freep(&s_priv->allocator);
+    if (s->shared_ctx)
+        s_priv->vkcontext = NULL;
+    else
+        ngli_vkcontext_freep(&s_priv->vkcontext);
+}
+
+static void vk_get_memory_stats(struct gpu_ctx *s, struct gpu_memory_stats *stats)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    ngli_allocator_vk_get_stats(s_priv->allocator, stats);
 }
 
 static void vk_wait_idle(struct gpu_ctx *s)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
     struct vkcontext *vk = s_priv->vkcontext;
+    ngli_vkcontext_lock_queues(vk);
     vkDeviceWaitIdle(vk->device);
+    ngli_vkcontext_unlock_queues(vk);
 }
 
 static int vk_transform_cull_mode(struct gpu_ctx *s, int cull_mode)
@@ -1305,6 +1577,7 @@ static void vk_begin_render_pass(struct gpu_ctx *s, struct rendertarget *rt)
     vkCmdBeginRenderPass(cmd_buf, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
     s_priv->current_rt = rt;
+    s_priv->bound_pipeline = VK_NULL_HANDLE;
 }
 
 static void vk_end_render_pass(struct gpu_ctx *s)
@@ -1428,6 +1701,15 @@ static int vk_texture_upload(struct texture *s, const uint8_t *data, int linesiz
     return ngli_vk_res2ret(res);
 }
 
+static int vk_texture_upload_borrowed(struct texture *s, const uint8_t *data, int linesize,
+                                      void (*release)(void *arg), void *arg)
+{
+    VkResult res = ngli_texture_vk_upload_borrowed(s, data, linesize, release, arg);
+    if (res != VK_SUCCESS)
+        LOG(ERROR, "unable to upload texture: %s", ngli_vk_res2str(res));
+    return ngli_vk_res2ret(res);
+}
+
 static int vk_texture_generate_mipmap(struct texture *s)
 {
     VkResult res = ngli_texture_vk_generate_mipmap(s);
@@ -1458,11 +1740,13 @@ const struct gpu_ctx_class ngli_gpu_ctx_vk = {
     .init                               = vk_init,
     .resize                             = vk_resize,
     .set_capture_buffer                 = vk_set_capture_buffer,
+    .flush_capture                      = vk_flush_capture,
     .begin_update                       = vk_begin_update,
     .end_update                         = vk_end_update,
     .begin_draw                         = vk_begin_draw,
     .query_draw_time                    = vk_query_draw_time,
     .end_draw                           = vk_end_draw,
+    .get_memory_stats                   = vk_get_memory_stats,
     .wait_idle                          = vk_wait_idle,
     .destroy                            = vk_destroy,
 
@@ -1514,6 +1798,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_vk = {
     .texture_create                     = ngli_texture_vk_create,
     .texture_init                       = vk_texture_init,
     .texture_upload                     = vk_texture_upload,
+    .texture_upload_borrowed            = vk_texture_upload_borrowed,
     .texture_generate_mipmap            = vk_texture_generate_mipmap,
     .texture_freep                      = ngli_texture_vk_freep,
 };
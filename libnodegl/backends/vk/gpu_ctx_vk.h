@@ -22,13 +22,23 @@
 #ifndef GPU_CTX_VK_H
 #define GPU_CTX_VK_H
 
+#include "allocator_vk.h"
 #include "gpu_ctx.h"
+#include "staging_vk.h"
 #include "vkcontext.h"
 #include "command_vk.h"
 
+struct capture_slot_vk {
+    struct buffer *buffer;
+    void *mapped_data;
+    struct cmd_vk *cmd; /* records the copy of the capture into buffer */
+    double t;
+};
+
 struct gpu_ctx_vk {
     struct gpu_ctx parent;
     struct vkcontext *vkcontext;
+    struct allocator_vk *allocator;
 
     VkSemaphore *image_avail_sems;
     VkSemaphore *update_finished_sems;
@@ -37,6 +47,8 @@ struct gpu_ctx_vk {
 
     VkCommandPool cmd_pool;
 
+    struct staging_vk *staging;
+
     struct cmd_vk **cmds;
     struct cmd_vk **update_cmds;
     struct darray pending_cmds;
@@ -45,6 +57,8 @@ struct gpu_ctx_vk {
 
     VkQueryPool query_pool;
 
+    VkPipelineCache pipeline_cache;
+
     VkSurfaceCapabilitiesKHR surface_caps;
     VkSurfaceFormatKHR surface_format;
     VkPresentModeKHR present_mode;
@@ -60,6 +74,7 @@ struct gpu_ctx_vk {
 
     int nb_in_flight_frames;
     int cur_frame_index;
+    int64_t frame_count; /* number of frames started, identifies the current one */
 
     struct darray colors;
     struct darray ms_colors;
@@ -70,6 +85,12 @@ struct gpu_ctx_vk {
     int capture_buffer_size;
     void *mapped_data;
 
+    /* Asynchronous capture ring of host visible buffers */
+    struct capture_slot_vk *capture_slots;
+    int nb_capture_slots;
+    int capture_slot_head; /* oldest pending capture */
+    int nb_pending_captures;
+
     struct rendertarget *default_rt;
     struct rendertarget *default_rt_load;
     struct rendertarget_desc default_rt_desc;
@@ -83,6 +104,12 @@ struct gpu_ctx_vk {
     struct texture *dummy_texture;
 
     struct rendertarget *current_rt;
+
+    /* Graphics states bound in the current render pass */
+    VkPipeline bound_pipeline;
+    VkViewport bound_viewport;
+    VkRect2D bound_scissor;
+
     int viewport[4];
     int scissor[4];
     float clear_color[4];
@@ -57,6 +57,7 @@ struct buffer_binding {
     struct pipeline_buffer_desc desc;
     const struct buffer *buffer;
     uint32_t update_desc_flags;
+    int dynamic_offset_index; /* -1 if the offset is part of the descriptor */
 };
 
 struct texture_binding {
@@ -355,7 +356,7 @@ static VkResult pipeline_graphics_init(struct pipeline *s)
         .renderPass          = render_pass,
         .subpass             = 0,
     };
-    res = vkCreateGraphicsPipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    res = vkCreateGraphicsPipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 
     vkDestroyRenderPass(vk->device, render_pass, NULL);
 
@@ -382,7 +383,7 @@ static VkResult pipeline_compute_init(struct pipeline *s)
         .layout = s_priv->pipeline_layout,
     };
 
-    return vkCreateComputePipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    return vkCreateComputePipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 }
 
 static const VkShaderStageFlags stage_flag_map[NGLI_PROGRAM_SHADER_NB] = {
@@ -412,12 +413,68 @@ static VkDescriptorType get_vk_descriptor_type(int type)
     return descriptor_type;
 }
 
-static VkResult create_desc_set_layout_bindings(struct pipeline *s, const struct pipeline_params *params)
+static VkDescriptorType get_vk_buffer_descriptor_type(const struct pipeline_buffer_desc *desc)
+{
+    if (desc->dynamic) {
+        ngli_assert(desc->type == NGLI_TYPE_UNIFORM_BUFFER);
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    }
+    return get_vk_descriptor_type(desc->type);
+}
+
+/*
+ * The dynamic offsets are passed to vkCmdBindDescriptorSets() in the order of
+ * their bindings
+ */
+static VkResult init_dynamic_offsets(struct pipeline *s)
+{
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    struct buffer_binding *buffer_bindings = ngli_darray_data(&s_priv->buffer_bindings);
+    const int nb_buffer_bindings = ngli_darray_count(&s_priv->buffer_bindings);
+    for (int i = 0; i < nb_buffer_bindings; i++) {
+        struct buffer_binding *binding = &buffer_bindings[i];
+        binding->dynamic_offset_index = -1;
+        if (!binding->desc.dynamic)
+            continue;
+
+        binding->dynamic_offset_index = 0;
+        for (int j = 0; j < nb_buffer_bindings; j++) {
+            const struct pipeline_buffer_desc *desc = &buffer_bindings[j].desc;
+            if (desc->dynamic && desc->binding < binding->desc.binding)
+                binding->dynamic_offset_index++;
+        }
+
+        const uint32_t offset = 0;
+        if (!ngli_darray_push(&s_priv->dynamic_offsets, &offset))
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    return VK_SUCCESS;
+}
+
+/* Each pool holds one descriptor set per frame slot */
+static VkResult create_desc_pool(struct pipeline *s, VkDescriptorPool *desc_pool)
 {
     const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
     const struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
 
+    const VkDescriptorPoolCreateInfo descriptor_pool_create_info = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .poolSizeCount = s_priv->nb_desc_pool_sizes,
+        .pPoolSizes    = s_priv->desc_pool_sizes,
+        .maxSets       = gpu_ctx_vk->nb_in_flight_frames,
+    };
+
+    return vkCreateDescriptorPool(vk->device, &descriptor_pool_create_info, NULL, desc_pool);
+}
+
+static VkResult create_desc_set_layout_bindings(struct pipeline *s, const struct pipeline_params *params)
+{
+    const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
     ngli_darray_init(&s_priv->desc_set_layout_bindings, sizeof(VkDescriptorSetLayoutBinding), 0);
 
     VkDescriptorPoolSize desc_pool_size_map[NGLI_TYPE_NB] = {
@@ -428,12 +485,13 @@ static VkResult create_desc_set_layout_bindings(struct pipeline *s, const struct
         [NGLI_TYPE_SAMPLER_CUBE]   = {.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER},
         [NGLI_TYPE_IMAGE_2D]       = {.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE},
     };
+    VkDescriptorPoolSize desc_pool_size_dynamic = {.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC};
 
     const struct pipeline_layout *layout = &params->layout;
     for (int i = 0; i < layout->nb_buffers; i++) {
         const struct pipeline_buffer_desc *desc = &layout->buffers_desc[i];
 
-        const VkDescriptorType type = get_vk_descriptor_type(desc->type);
+        const VkDescriptorType type = get_vk_buffer_descriptor_type(desc);
         const VkDescriptorSetLayoutBinding binding = {
             .binding         = desc->binding,
             .descriptorType  = type,
@@ -449,10 +507,18 @@ static VkResult create_desc_set_layout_bindings(struct pipeline *s, const struct
         if (!ngli_darray_push(&s_priv->buffer_bindings, &buffer_binding))
             return VK_ERROR_OUT_OF_HOST_MEMORY;
 
+        if (desc->dynamic) {
+            desc_pool_size_dynamic.descriptorCount += gpu_ctx_vk->nb_in_flight_frames;
+            continue;
+        }
         ngli_assert(desc_pool_size_map[desc->type].type);
         desc_pool_size_map[desc->type].descriptorCount += gpu_ctx_vk->nb_in_flight_frames;
     }
 
+    VkResult res = init_dynamic_offsets(s);
+    if (res != VK_SUCCESS)
+        return res;
+
     for (int i = 0; i < layout->nb_textures; i++) {
         const struct pipeline_texture_desc *desc = &layout->textures_desc[i];
 
@@ -477,27 +543,16 @@ static VkResult create_desc_set_layout_bindings(struct pipeline *s, const struct
         desc_pool_size_map[desc->type].descriptorCount += gpu_ctx_vk->nb_in_flight_frames;
     }
 
-    uint32_t nb_desc_pool_sizes = 0;
-    VkDescriptorPoolSize desc_pool_sizes[NGLI_TYPE_NB];
     for (int i = 0; i < NGLI_ARRAY_NB(desc_pool_size_map); i++) {
         if (desc_pool_size_map[i].descriptorCount)
-            desc_pool_sizes[nb_desc_pool_sizes++] = desc_pool_size_map[i];
+            s_priv->desc_pool_sizes[s_priv->nb_desc_pool_sizes++] = desc_pool_size_map[i];
     }
-    if (!nb_desc_pool_sizes)
+    if (desc_pool_size_dynamic.descriptorCount)
+        s_priv->desc_pool_sizes[s_priv->nb_desc_pool_sizes++] = desc_pool_size_dynamic;
+    if (!s_priv->nb_desc_pool_sizes)
         return VK_SUCCESS;
 
-    const VkDescriptorPoolCreateInfo descriptor_pool_create_info = {
-        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .poolSizeCount = nb_desc_pool_sizes,
-        .pPoolSizes    = desc_pool_sizes,
-        .maxSets       = gpu_ctx_vk->nb_in_flight_frames,
-    };
-
-    VkResult res = vkCreateDescriptorPool(vk->device, &descriptor_pool_create_info, NULL, &s_priv->desc_pool);
-    if (res != VK_SUCCESS)
-        return res;
-
-    return VK_SUCCESS;
+    return create_desc_pool(s, &s_priv->desc_pool);
 }
 
 static VkResult create_desc_layout(struct pipeline *s)
@@ -519,42 +574,126 @@ static VkResult create_desc_layout(struct pipeline *s)
     return VK_SUCCESS;
 }
 
-static VkResult create_desc_sets(struct pipeline *s)
+static VkResult alloc_desc_set(struct pipeline *s, VkDescriptorPool desc_pool, struct desc_sets_vk *desc_sets)
 {
     const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
     const struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
 
-    VkDescriptorSetLayout *desc_set_layouts = ngli_calloc(gpu_ctx_vk->nb_in_flight_frames, sizeof(*desc_set_layouts));
-    if (!desc_set_layouts)
-        return VK_ERROR_OUT_OF_HOST_MEMORY;
-
-    for (int i = 0; i < gpu_ctx_vk->nb_in_flight_frames; i++)
-        desc_set_layouts[i] = s_priv->desc_set_layout;
-
     const VkDescriptorSetAllocateInfo descriptor_set_allocate_info = {
         .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .descriptorPool     = s_priv->desc_pool,
-        .descriptorSetCount = gpu_ctx_vk->nb_in_flight_frames,
-        .pSetLayouts        = desc_set_layouts
+        .descriptorPool     = desc_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts        = &s_priv->desc_set_layout,
     };
 
-    s_priv->desc_sets = ngli_calloc(gpu_ctx_vk->nb_in_flight_frames, sizeof(*s_priv->desc_sets));
-    if (!s_priv->desc_sets) {
-        ngli_free(desc_set_layouts);
+    VkDescriptorSet desc_set;
+    VkResult res = vkAllocateDescriptorSets(vk->device, &descriptor_set_allocate_info, &desc_set);
+    if (res != VK_SUCCESS)
+        return res;
+
+    if (!ngli_darray_push(&desc_sets->sets, &desc_set))
         return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    return VK_SUCCESS;
+}
+
+static VkResult alloc_spare_desc_set(struct pipeline *s, struct desc_sets_vk *desc_sets)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    if (!s_priv->nb_spare_desc_sets) {
+        VkDescriptorPool desc_pool;
+        VkResult res = create_desc_pool(s, &desc_pool);
+        if (res != VK_SUCCESS)
+            return res;
+
+        if (!ngli_darray_push(&s_priv->spare_desc_pools, &desc_pool)) {
+            vkDestroyDescriptorPool(vk->device, desc_pool, NULL);
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        s_priv->nb_spare_desc_sets = gpu_ctx_vk->nb_in_flight_frames;
     }
 
-    VkResult res = vkAllocateDescriptorSets(vk->device, &descriptor_set_allocate_info, s_priv->desc_sets);
-    if (res != VK_SUCCESS) {
-        ngli_free(desc_set_layouts);
+    const VkDescriptorPool *desc_pools = ngli_darray_data(&s_priv->spare_desc_pools);
+    const int nb_desc_pools = ngli_darray_count(&s_priv->spare_desc_pools);
+    VkResult res = alloc_desc_set(s, desc_pools[nb_desc_pools - 1], desc_sets);
+    if (res != VK_SUCCESS)
         return res;
+    s_priv->nb_spare_desc_sets--;
+
+    return VK_SUCCESS;
+}
+
+static VkResult create_desc_sets(struct pipeline *s)
+{
+    const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    if (!s_priv->desc_pool)
+        return VK_SUCCESS;
+
+    s_priv->desc_sets = ngli_calloc(gpu_ctx_vk->nb_in_flight_frames, sizeof(*s_priv->desc_sets));
+    if (!s_priv->desc_sets)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    for (int i = 0; i < gpu_ctx_vk->nb_in_flight_frames; i++) {
+        struct desc_sets_vk *desc_sets = &s_priv->desc_sets[i];
+        ngli_darray_init(&desc_sets->sets, sizeof(VkDescriptorSet), 0);
+        desc_sets->frame = -1;
+        VkResult res = alloc_desc_set(s, s_priv->desc_pool, desc_sets);
+        if (res != VK_SUCCESS)
+            return res;
     }
 
-    ngli_free(desc_set_layouts);
     return VK_SUCCESS;
 }
 
+static void destroy_desc_sets(struct pipeline *s)
+{
+    const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    if (s_priv->desc_sets) {
+        for (int i = 0; i < gpu_ctx_vk->nb_in_flight_frames; i++)
+            ngli_darray_reset(&s_priv->desc_sets[i].sets);
+        ngli_freep(&s_priv->desc_sets);
+    }
+
+    VkDescriptorPool *desc_pools = ngli_darray_data(&s_priv->spare_desc_pools);
+    for (int i = 0; i < ngli_darray_count(&s_priv->spare_desc_pools); i++)
+        vkDestroyDescriptorPool(vk->device, desc_pools[i], NULL);
+    ngli_darray_clear(&s_priv->spare_desc_pools);
+    s_priv->nb_spare_desc_sets = 0;
+}
+
+static VkDescriptorSet *get_desc_set(struct pipeline *s)
+{
+    const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    struct desc_sets_vk *desc_sets = &s_priv->desc_sets[gpu_ctx_vk->cur_frame_index];
+    return ngli_darray_get(&desc_sets->sets, desc_sets->current);
+}
+
+static void bind_desc_set(struct pipeline *s, VkCommandBuffer cmd_buf, VkPipelineBindPoint bind_point)
+{
+    const struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    if (!s_priv->desc_sets)
+        return;
+
+    vkCmdBindDescriptorSets(cmd_buf, bind_point, s_priv->pipeline_layout,
+                            0, 1, get_desc_set(s),
+                            ngli_darray_count(&s_priv->dynamic_offsets),
+                            ngli_darray_data(&s_priv->dynamic_offsets));
+    s_priv->desc_sets[gpu_ctx_vk->cur_frame_index].bound = 1;
+}
+
 static VkResult create_pipeline_layout(struct pipeline *s)
 {
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
@@ -618,9 +757,9 @@ static void destroy_pipeline(struct pipeline *s)
 
     destroy_pipeline_keep_pool(s);
 
+    destroy_desc_sets(s);
     vkDestroyDescriptorPool(vk->device, s_priv->desc_pool, NULL);
     s_priv->desc_pool = VK_NULL_HANDLE;
-    ngli_freep(&s_priv->desc_sets);
 }
 
 static void request_desc_sets_update(struct pipeline *s)
@@ -652,12 +791,14 @@ static VkResult recreate_pipeline(struct pipeline *s)
      */
     destroy_pipeline_keep_pool(s);
 
-    VkResult res = vkResetDescriptorPool(vk->device, s_priv->desc_pool, 0);
-    if (res != VK_SUCCESS)
-        return res;
-    ngli_freep(&s_priv->desc_sets);
+    destroy_desc_sets(s);
+    if (s_priv->desc_pool) {
+        VkResult res = vkResetDescriptorPool(vk->device, s_priv->desc_pool, 0);
+        if (res != VK_SUCCESS)
+            return res;
+    }
 
-    res = create_pipeline(s);
+    VkResult res = create_pipeline(s);
     if (res != VK_SUCCESS)
         return res;
 
@@ -691,6 +832,8 @@ VkResult ngli_pipeline_vk_init(struct pipeline *s, const struct pipeline_params
     ngli_darray_init(&s_priv->texture_bindings, sizeof(struct texture_binding), 0);
     ngli_darray_init(&s_priv->buffer_bindings,  sizeof(struct buffer_binding), 0);
     ngli_darray_init(&s_priv->attribute_bindings, sizeof(struct attribute_binding), 0);
+    ngli_darray_init(&s_priv->dynamic_offsets, sizeof(uint32_t), 0);
+    ngli_darray_init(&s_priv->spare_desc_pools, sizeof(VkDescriptorPool), 0);
 
     if (params->type == NGLI_PIPELINE_TYPE_GRAPHICS) {
         VkResult res = create_attribute_descs(s, params);
@@ -844,6 +987,20 @@ int ngli_pipeline_vk_update_buffer(struct pipeline *s, int index, const struct b
     struct buffer_binding *buffer_binding = ngli_darray_get(&s_priv->buffer_bindings, index);
     ngli_assert(buffer_binding);
 
+    /*
+     * Only the dynamic offset changes when the same buffer range is bound at
+     * another offset, the descriptor sets are left untouched. Another buffer
+     * (such as a new uniform ring buffer) requires a descriptor update, which
+     * moves the next draws to another descriptor set if the current one is
+     * already in use by this frame (see select_desc_set()).
+     */
+    if (buffer_binding->dynamic_offset_index >= 0) {
+        uint32_t *dynamic_offsets = ngli_darray_data(&s_priv->dynamic_offsets);
+        dynamic_offsets[buffer_binding->dynamic_offset_index] = offset;
+        if (buffer_binding->buffer == buffer && buffer_binding->desc.size == size)
+            return 0;
+    }
+
     buffer_binding->buffer = buffer;
     buffer_binding->desc.offset = offset;
     buffer_binding->desc.size = size;
@@ -862,6 +1019,77 @@ static VkIndexType get_vk_indices_type(int indices_format)
     return vk_indices_type_map[indices_format];
 }
 
+static int need_desc_set_update(struct pipeline *s, uint32_t update_desc_flags)
+{
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    const struct texture_binding *texture_bindings = ngli_darray_data(&s_priv->texture_bindings);
+    for (int i = 0; i < ngli_darray_count(&s_priv->texture_bindings); i++)
+        if (texture_bindings[i].update_desc_flags & update_desc_flags)
+            return 1;
+
+    const struct buffer_binding *buffer_bindings = ngli_darray_data(&s_priv->buffer_bindings);
+    for (int i = 0; i < ngli_darray_count(&s_priv->buffer_bindings); i++)
+        if (buffer_bindings[i].update_desc_flags & update_desc_flags)
+            return 1;
+
+    return 0;
+}
+
+static void request_desc_set_update(struct pipeline *s, uint32_t update_desc_flags)
+{
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+
+    struct texture_binding *texture_bindings = ngli_darray_data(&s_priv->texture_bindings);
+    for (int i = 0; i < ngli_darray_count(&s_priv->texture_bindings); i++)
+        texture_bindings[i].update_desc_flags |= update_desc_flags;
+
+    struct buffer_binding *buffer_bindings = ngli_darray_data(&s_priv->buffer_bindings);
+    for (int i = 0; i < ngli_darray_count(&s_priv->buffer_bindings); i++)
+        buffer_bindings[i].update_desc_flags |= update_desc_flags;
+}
+
+/*
+ * Select the descriptor set of the frame slot to write and bind. The first
+ * set is used by default. Once a set has been bound in the frame being
+ * recorded, it must not be updated anymore (the commands recorded earlier
+ * still reference its descriptors), so a binding change (such as the uniform
+ * ring switching to a new buffer) moves the following draws to the next set.
+ * Both cases start from a set that was last written in another frame, so all
+ * of its descriptors are written again.
+ */
+static VkResult select_desc_set(struct pipeline *s, uint32_t update_desc_flags)
+{
+    struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct desc_sets_vk *desc_sets = &s_priv->desc_sets[gpu_ctx_vk->cur_frame_index];
+
+    /* The sets of the frame slot are not in use anymore in a new frame */
+    if (desc_sets->frame != gpu_ctx_vk->frame_count) {
+        desc_sets->frame = gpu_ctx_vk->frame_count;
+        desc_sets->bound = 0;
+        if (desc_sets->current) {
+            desc_sets->current = 0;
+            request_desc_set_update(s, update_desc_flags);
+        }
+        return VK_SUCCESS;
+    }
+
+    if (!desc_sets->bound || !need_desc_set_update(s, update_desc_flags))
+        return VK_SUCCESS;
+
+    if (desc_sets->current + 1 == ngli_darray_count(&desc_sets->sets)) {
+        VkResult res = alloc_spare_desc_set(s, desc_sets);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+    desc_sets->current++;
+    desc_sets->bound = 0;
+    request_desc_set_update(s, update_desc_flags);
+
+    return VK_SUCCESS;
+}
+
 static int update_descriptor_set(struct pipeline *s)
 {
     struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
@@ -870,6 +1098,14 @@ static int update_descriptor_set(struct pipeline *s)
     const uint32_t update_desc_flags = (1 << gpu_ctx_vk->cur_frame_index);
     const uint32_t update_desc_mask = ~update_desc_flags;
 
+    if (!s_priv->desc_sets)
+        return 0;
+
+    VkResult res = select_desc_set(s, update_desc_flags);
+    if (res != VK_SUCCESS)
+        return ngli_vk_res2ret(res);
+    const VkDescriptorSet desc_set = *get_desc_set(s);
+
     struct texture_binding *texture_bindings = ngli_darray_data(&s_priv->texture_bindings);
     for (int i = 0; i < ngli_darray_count(&s_priv->texture_bindings); i++) {
         struct texture_binding *binding = &texture_bindings[i];
@@ -883,7 +1119,7 @@ static int update_descriptor_set(struct pipeline *s)
             const struct pipeline_texture_desc *desc = &binding->desc;
             const VkWriteDescriptorSet write_descriptor_set = {
                 .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet           = s_priv->desc_sets[gpu_ctx_vk->cur_frame_index],
+                .dstSet           = desc_set,
                 .dstBinding       = desc->binding,
                 .dstArrayElement  = 0,
                 .descriptorType   = get_vk_descriptor_type(desc->type),
@@ -903,15 +1139,15 @@ static int update_descriptor_set(struct pipeline *s)
             const struct buffer_vk *buffer_vk = (struct buffer_vk *)(binding->buffer);
             const VkDescriptorBufferInfo descriptor_buffer_info = {
                 .buffer = buffer_vk->buffer,
-                .offset = desc->offset,
+                .offset = binding->dynamic_offset_index >= 0 ? 0 : desc->offset,
                 .range  = desc->size ? desc->size : binding->buffer->size,
             };
             const VkWriteDescriptorSet write_descriptor_set = {
                 .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet           = s_priv->desc_sets[gpu_ctx_vk->cur_frame_index],
+                .dstSet           = desc_set,
                 .dstBinding       = desc->binding,
                 .dstArrayElement  = 0,
-                .descriptorType   = get_vk_descriptor_type(desc->type),
+                .descriptorType   = get_vk_buffer_descriptor_type(desc),
                 .descriptorCount  = 1,
                 .pBufferInfo      = &descriptor_buffer_info,
                 .pImageInfo       = NULL,
@@ -934,7 +1170,16 @@ static int prepare_pipeline(struct pipeline *s, VkCommandBuffer cmd_buf)
     if (ret < 0)
         return ret;
 
-    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, s_priv->pipeline);
+    /*
+     * Consecutive draws of the same pipeline (which the draw list sorting
+     * favors) do not need to bind it and its dynamic states again
+     */
+    const int rebind = s_priv->pipeline != gpu_ctx_vk->bound_pipeline;
+    if (rebind) {
+        vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, s_priv->pipeline);
+        vkCmdSetLineWidth(cmd_buf, 1.0f);
+        gpu_ctx_vk->bound_pipeline = s_priv->pipeline;
+    }
 
     const VkViewport viewport = {
         .x        = gpu_ctx_vk->viewport[0],
@@ -944,8 +1189,10 @@ static int prepare_pipeline(struct pipeline *s, VkCommandBuffer cmd_buf)
         .minDepth = 0.f,
         .maxDepth = 1.f,
     };
-    vkCmdSetViewport(cmd_buf, 0, 1, &viewport);
-    vkCmdSetLineWidth(cmd_buf, 1.0f);
+    if (rebind || memcmp(&viewport, &gpu_ctx_vk->bound_viewport, sizeof(viewport))) {
+        vkCmdSetViewport(cmd_buf, 0, 1, &viewport);
+        gpu_ctx_vk->bound_viewport = viewport;
+    }
 
     VkRect2D scissor = {0};
     const struct rendertarget *rt = gpu_ctx_vk->current_rt;
@@ -961,11 +1208,12 @@ static int prepare_pipeline(struct pipeline *s, VkCommandBuffer cmd_buf)
         scissor.extent.width  = rt->width;
         scissor.extent.height = rt->height;
     }
-    vkCmdSetScissor(cmd_buf, 0, 1, &scissor);
+    if (rebind || memcmp(&scissor, &gpu_ctx_vk->bound_scissor, sizeof(scissor))) {
+        vkCmdSetScissor(cmd_buf, 0, 1, &scissor);
+        gpu_ctx_vk->bound_scissor = scissor;
+    }
 
-    if (s_priv->desc_sets)
-        vkCmdBindDescriptorSets(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, s_priv->pipeline_layout,
-                                0, 1, &s_priv->desc_sets[gpu_ctx_vk->cur_frame_index], 0, NULL);
+    bind_desc_set(s, cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
     const int nb_vertex_buffers = ngli_darray_count(&s_priv->vertex_buffers);
     const VkBuffer *vertex_buffers = ngli_darray_data(&s_priv->vertex_buffers);
@@ -1022,9 +1270,7 @@ void ngli_pipeline_vk_dispatch(struct pipeline *s, int nb_group_x, int nb_group_
 
     vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, s_priv->pipeline);
 
-    if (s_priv->desc_sets)
-        vkCmdBindDescriptorSets(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, s_priv->pipeline_layout,
-                                0, 1, &s_priv->desc_sets[gpu_ctx_vk->cur_frame_index], 0, NULL);
+    bind_desc_set(s, cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE);
 
     vkCmdDispatch(cmd_buf, nb_group_x, nb_group_y, nb_group_z);
 
@@ -1075,6 +1321,8 @@ void ngli_pipeline_vk_freep(struct pipeline **sp)
     ngli_darray_reset(&s_priv->vertex_buffers);
     ngli_darray_reset(&s_priv->vertex_offsets);
     ngli_darray_reset(&s_priv->desc_set_layout_bindings);
+    ngli_darray_reset(&s_priv->dynamic_offsets);
+    ngli_darray_reset(&s_priv->spare_desc_pools);
 
     ngli_freep(sp);
 }
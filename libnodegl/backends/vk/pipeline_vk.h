@@ -26,9 +26,22 @@
 
 #include "pipeline.h"
 #include "darray.h"
+#include "type.h"
 
 struct gpu_ctx;
 
+/*
+ * Descriptor sets of a frame slot: a set must not be updated once bound in
+ * the frame being recorded, so a binding changing afterwards switches the
+ * following draws to another set (allocated on demand from the spare pools)
+ */
+struct desc_sets_vk {
+    struct darray sets;   // array of VkDescriptorSet
+    int current;          // index of the set used by the draws
+    int64_t frame;        // frame in which the sets were last used
+    int bound;            // whether the current set is bound in that frame
+};
+
 struct pipeline_vk {
     struct pipeline parent;
 
@@ -42,9 +55,14 @@ struct pipeline_vk {
     struct darray vertex_offsets;           // array of VkDeviceSize
 
     VkDescriptorPool desc_pool;
+    VkDescriptorPoolSize desc_pool_sizes[NGLI_TYPE_NB + 1];
+    uint32_t nb_desc_pool_sizes;
+    struct darray spare_desc_pools;         // array of VkDescriptorPool
+    int nb_spare_desc_sets;                 // sets left in the last spare pool
     struct darray desc_set_layout_bindings; // array of VkDescriptorSetLayoutBinding
+    struct darray dynamic_offsets;          // array of uint32_t, ordered by binding
     VkDescriptorSetLayout desc_set_layout;
-    VkDescriptorSet *desc_sets;
+    struct desc_sets_vk *desc_sets;         // one entry per frame slot
     VkPipelineLayout pipeline_layout;
     VkPipeline pipeline;
 };
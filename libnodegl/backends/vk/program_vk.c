@@ -40,10 +40,37 @@ struct program *ngli_program_vk_create(struct gpu_ctx *gpu_ctx)
     return (struct program *)s;
 }
 
+static int get_spirv(struct diskcache *cache, const struct vkcontext *vk,
+                     int stage, const char *src, void **datap, size_t *sizep)
+{
+    if (!ngli_diskcache_enabled(cache))
+        return ngli_glslang_compile(stage, src, datap, sizep);
+
+    const VkPhysicalDeviceProperties *props = &vk->phy_device_props;
+    char *key = ngli_asprintf("vk:spirv:%d.%d.%d:%08x:%08x:%08x:%d\n%s",
+                              GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH,
+                              props->vendorID, props->deviceID, props->driverVersion,
+                              stage, src);
+    if (!key)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_diskcache_load(cache, key, datap, sizep);
+    if (ret == NGL_ERROR_NOT_FOUND) {
+        ret = ngli_glslang_compile(stage, src, datap, sizep);
+        /* Failing to populate the cache is not fatal */
+        if (ret >= 0)
+            ngli_diskcache_store(cache, key, *datap, *sizep);
+    }
+
+    ngli_free(key);
+    return ret;
+}
+
 int ngli_program_vk_init(struct program *s, const struct program_params *params)
 {
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
     struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+    struct diskcache *cache = &s->gpu_ctx->program_cache;
     struct program_vk *s_priv = (struct program_vk *)s;
 
     const struct {
@@ -61,7 +88,7 @@ int ngli_program_vk_init(struct program *s, const struct program_params *params)
 
         void *data = NULL;
         size_t size = 0;
-        int ret = ngli_glslang_compile(shaders[i].stage, shaders[i].src, &data, &size);
+        int ret = get_spirv(cache, vk, shaders[i].stage, shaders[i].src, &data, &size);
         if (ret < 0) {
             char *s_with_numbers = ngli_numbered_lines(shaders[i].src);
             if (s_with_numbers) {
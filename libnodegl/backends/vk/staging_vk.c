@@ -0,0 +1,378 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "buffer_vk.h"
+#include "darray.h"
+#include "gpu_ctx_vk.h"
+#include "log.h"
+#include "memory.h"
+#include "staging_vk.h"
+#include "utils.h"
+
+#define DEFAULT_CHUNK_SIZE (4 * 1024 * 1024)
+
+struct staging_frame_vk {
+    struct darray chunks;  /* struct buffer * */
+    struct darray imports; /* struct staging_import_vk */
+    int offset;           /* position in the last chunk */
+    int next_chunk_size;
+};
+
+struct staging_vk {
+    struct gpu_ctx *gpu_ctx;
+    struct staging_frame_vk *frames;
+    int nb_frames;
+    int cur_frame;
+};
+
+static void free_chunks(struct staging_frame_vk *frame)
+{
+    struct buffer **chunks = ngli_darray_data(&frame->chunks);
+    for (int i = 0; i < ngli_darray_count(&frame->chunks); i++)
+        ngli_buffer_vk_freep(&chunks[i]);
+    ngli_darray_clear(&frame->chunks);
+}
+
+static void release_import(struct vkcontext *vk, struct staging_import_vk *import)
+{
+    vkDestroyBuffer(vk->device, import->buffer, NULL);
+    vkFreeMemory(vk->device, import->memory, NULL);
+    if (import->release)
+        import->release(import->release_arg);
+    memset(import, 0, sizeof(*import));
+}
+
+static void release_imports(struct staging_vk *s, struct staging_frame_vk *frame)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+
+    struct staging_import_vk *imports = ngli_darray_data(&frame->imports);
+    for (int i = 0; i < ngli_darray_count(&frame->imports); i++)
+        release_import(vk, &imports[i]);
+    ngli_darray_clear(&frame->imports);
+}
+
+struct staging_vk *ngli_staging_vk_create(struct gpu_ctx *gpu_ctx, int nb_frames)
+{
+    struct staging_vk *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+
+    s->frames = ngli_calloc(nb_frames, sizeof(*s->frames));
+    if (!s->frames) {
+        ngli_free(s);
+        return NULL;
+    }
+    s->nb_frames = nb_frames;
+
+    for (int i = 0; i < nb_frames; i++) {
+        struct staging_frame_vk *frame = &s->frames[i];
+        ngli_darray_init(&frame->chunks, sizeof(struct buffer *), 0);
+        ngli_darray_init(&frame->imports, sizeof(struct staging_import_vk), 0);
+        frame->next_chunk_size = DEFAULT_CHUNK_SIZE;
+    }
+
+    return s;
+}
+
+void ngli_staging_vk_begin_frame(struct staging_vk *s, int frame_index)
+{
+    s->cur_frame = frame_index;
+
+    struct staging_frame_vk *frame = &s->frames[frame_index];
+    frame->offset = 0;
+
+    release_imports(s, frame);
+
+    /*
+     * The frame has overflowed its staging memory: merge all its chunks into
+     * a single one (allocated on the next upload)
+     */
+    const int nb_chunks = ngli_darray_count(&frame->chunks);
+    if (nb_chunks > 1) {
+        int total_size = 0;
+        struct buffer **chunks = ngli_darray_data(&frame->chunks);
+        for (int i = 0; i < nb_chunks; i++)
+            total_size += chunks[i]->size;
+        free_chunks(frame);
+        frame->next_chunk_size = total_size;
+        LOG(DEBUG, "staging memory of frame %d grown to %d bytes", frame_index, total_size);
+    }
+}
+
+/*
+ * The copies recorded in the frame command buffer are ordered with all the
+ * commands recorded before and after them, which may access the same
+ * destination (previous draws reading it, other uploads, following draws)
+ */
+static void insert_barrier(struct cmd_vk *cmd,
+                           VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+                           VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+{
+    const VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+    };
+    vkCmdPipelineBarrier(cmd->cmd_buf, src_stage, dst_stage, 0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
+static VkResult add_chunk(struct staging_vk *s, struct staging_frame_vk *frame, int size)
+{
+    struct buffer *chunk = ngli_buffer_vk_create(s->gpu_ctx);
+    if (!chunk)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    const int usage = NGLI_BUFFER_USAGE_DYNAMIC_BIT |
+                      NGLI_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                      NGLI_BUFFER_USAGE_MAP_WRITE;
+    VkResult res = ngli_buffer_vk_init(chunk, NGLI_MAX(size, frame->next_chunk_size), usage);
+    if (res != VK_SUCCESS) {
+        ngli_buffer_vk_freep(&chunk);
+        return res;
+    }
+
+    if (!ngli_darray_push(&frame->chunks, &chunk)) {
+        ngli_buffer_vk_freep(&chunk);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    frame->offset = 0;
+
+    return VK_SUCCESS;
+}
+
+static VkResult select_cmd(struct staging_vk *s, struct staging_upload_vk *upload)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+
+    /* Copy commands are not allowed within a render pass */
+    if (gpu_ctx_vk->cur_cmd && !gpu_ctx_vk->current_rt) {
+        upload->cmd = gpu_ctx_vk->cur_cmd;
+        insert_barrier(upload->cmd,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        return VK_SUCCESS;
+    }
+
+    upload->transient = 1;
+    return ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &upload->cmd);
+}
+
+VkResult ngli_staging_vk_begin_upload(struct staging_vk *s, int size, int alignment,
+                                      struct staging_upload_vk *upload)
+{
+    struct staging_frame_vk *frame = &s->frames[s->cur_frame];
+
+    memset(upload, 0, sizeof(*upload));
+
+    struct buffer **chunks = ngli_darray_data(&frame->chunks);
+    int nb_chunks = ngli_darray_count(&frame->chunks);
+    int chunk_offset = frame->offset;
+    int offset = (frame->offset + alignment - 1) / alignment * alignment;
+    if (!nb_chunks || offset + size > chunks[nb_chunks - 1]->size) {
+        VkResult res = add_chunk(s, frame, size);
+        if (res != VK_SUCCESS)
+            return res;
+        chunks = ngli_darray_data(&frame->chunks);
+        nb_chunks = ngli_darray_count(&frame->chunks);
+        chunk_offset = 0;
+        offset = 0;
+    }
+
+    const struct buffer_vk *chunk = (const struct buffer_vk *)chunks[nb_chunks - 1];
+    upload->buffer       = chunk->buffer;
+    upload->offset       = offset;
+    upload->mapped_data  = (uint8_t *)chunk->memory.mapped_data + offset;
+    upload->chunk_index  = nb_chunks - 1;
+    upload->chunk_offset = chunk_offset;
+    frame->offset = offset + size;
+
+    return select_cmd(s, upload);
+}
+
+static uint32_t find_import_memory_type(struct vkcontext *vk, uint32_t type_bits)
+{
+    for (uint32_t i = 0; i < vk->phydev_mem_props.memoryTypeCount; i++) {
+        if (type_bits & (1U << i))
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+VkResult ngli_staging_vk_begin_import(struct staging_vk *s, const void *data, int size, int alignment,
+                                      void (*release)(void *arg), void *release_arg,
+                                      struct staging_upload_vk *upload)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+
+    memset(upload, 0, sizeof(*upload));
+
+    const VkDeviceSize host_alignment = vk->min_imported_host_pointer_alignment;
+    if (!host_alignment)
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    /*
+     * The imported range must start and end on the host pointer alignment (a
+     * power of two), while the copy source offset within it must honor the
+     * texel alignment
+     */
+    const uintptr_t start = (uintptr_t)data & ~(uintptr_t)(host_alignment - 1);
+    const uintptr_t end = NGLI_ALIGN((uintptr_t)data + size, (uintptr_t)host_alignment);
+    const VkDeviceSize offset = (uintptr_t)data - start;
+    if (offset % alignment)
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    VkMemoryHostPointerPropertiesEXT host_props = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT,
+    };
+    VkResult res = vk->GetMemoryHostPointerPropertiesEXT(vk->device,
+                                                         VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                                                         (void *)start, &host_props);
+    if (res != VK_SUCCESS)
+        return res;
+
+    const VkExternalMemoryBufferCreateInfo external_info = {
+        .sType       = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+        .handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+    };
+
+    const VkBufferCreateInfo buffer_info = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext       = &external_info,
+        .size        = end - start,
+        .usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+
+    struct staging_import_vk import = {0};
+    res = vkCreateBuffer(vk->device, &buffer_info, NULL, &import.buffer);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkMemoryRequirements mem_reqs;
+    vkGetBufferMemoryRequirements(vk->device, import.buffer, &mem_reqs);
+
+    const uint32_t mem_type_index = find_import_memory_type(vk, mem_reqs.memoryTypeBits & host_props.memoryTypeBits);
+    if (mem_type_index == UINT32_MAX) {
+        release_import(vk, &import);
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    const VkImportMemoryHostPointerInfoEXT import_info = {
+        .sType        = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+        .handleType   = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        .pHostPointer = (void *)start,
+    };
+
+    const VkMemoryAllocateInfo alloc_info = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = &import_info,
+        .allocationSize  = end - start,
+        .memoryTypeIndex = mem_type_index,
+    };
+
+    res = vkAllocateMemory(vk->device, &alloc_info, NULL, &import.memory);
+    if (res != VK_SUCCESS) {
+        release_import(vk, &import);
+        return res;
+    }
+
+    res = vkBindBufferMemory(vk->device, import.buffer, import.memory, 0);
+    if (res != VK_SUCCESS) {
+        release_import(vk, &import);
+        return res;
+    }
+
+    /*
+     * The import is registered in the frame before any command is recorded so
+     * its release can always be deferred until the commands have completed.
+     * The release callback is only attached once the import has succeeded: on
+     * failure, the caller keeps the ownership of the data.
+     */
+    struct staging_frame_vk *frame = &s->frames[s->cur_frame];
+    if (!ngli_darray_push(&frame->imports, &import)) {
+        release_import(vk, &import);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    upload->buffer      = import.buffer;
+    upload->offset      = offset;
+    upload->chunk_index = -1;
+    upload->imported    = 1;
+
+    res = select_cmd(s, upload);
+    if (res != VK_SUCCESS) {
+        release_import(vk, ngli_darray_pop(&frame->imports));
+        return res;
+    }
+
+    struct staging_import_vk *registered = ngli_darray_tail(&frame->imports);
+    registered->release     = release;
+    registered->release_arg = release_arg;
+
+    return VK_SUCCESS;
+}
+
+VkResult ngli_staging_vk_end_upload(struct staging_vk *s, struct staging_upload_vk *upload)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+    struct staging_frame_vk *frame = &s->frames[s->cur_frame];
+
+    if (!upload->transient) {
+        insert_barrier(upload->cmd,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+        return VK_SUCCESS;
+    }
+
+    VkResult res = ngli_cmd_vk_execute_transient(&upload->cmd);
+
+    /* The copy has completed, the staging memory can be reused right away */
+    if (upload->imported)
+        release_import(vk, ngli_darray_pop(&frame->imports));
+    else if (upload->chunk_index == ngli_darray_count(&frame->chunks) - 1)
+        frame->offset = upload->chunk_offset;
+
+    return res;
+}
+
+void ngli_staging_vk_freep(struct staging_vk **sp)
+{
+    struct staging_vk *s = *sp;
+    if (!s)
+        return;
+
+    for (int i = 0; i < s->nb_frames; i++) {
+        free_chunks(&s->frames[i]);
+        ngli_darray_reset(&s->frames[i].chunks);
+        release_imports(s, &s->frames[i]);
+        ngli_darray_reset(&s->frames[i].imports);
+    }
+    ngli_freep(&s->frames);
+    ngli_freep(sp);
+}
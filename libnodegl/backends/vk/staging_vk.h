@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef STAGING_VK_H
+#define STAGING_VK_H
+
+#include <vulkan/vulkan.h>
+
+#include "command_vk.h"
+#include "gpu_ctx.h"
+
+/*
+ * Staging memory ring used for the buffer and texture uploads.
+ *
+ * Each frame in flight owns a set of host visible buffers from which the
+ * staging memory is linearly allocated; the set is recycled once the frame
+ * commands have completed, at the beginning of the next update of this frame
+ * slot. If a frame overflows its buffers, a new one is added, and the set is
+ * merged into a single larger buffer when recycled, so the steady state never
+ * allocates.
+ *
+ * The copies are recorded in the current frame command buffer. Outside of a
+ * frame, or within a render pass (where copy commands are not allowed), the
+ * copies are submitted in a transient command buffer and waited for, in which
+ * case the staging memory is immediately given back to the ring.
+ *
+ * When VK_EXT_external_memory_host is available, host memory owned by the
+ * caller can also be imported and used directly as the copy source, saving
+ * the copy into the ring. The imported memory is released (and its release
+ * callback called) along with the staging memory of the frame.
+ */
+struct staging_vk;
+
+struct staging_import_vk {
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+    void (*release)(void *arg);
+    void *release_arg;
+};
+
+struct staging_upload_vk {
+    struct cmd_vk *cmd;
+    int transient;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    void *mapped_data;
+    int chunk_index;
+    int chunk_offset; /* chunk position before the allocation, used to rewind the ring */
+    int imported;     /* the copy source is imported host memory */
+};
+
+struct staging_vk *ngli_staging_vk_create(struct gpu_ctx *gpu_ctx, int nb_frames);
+void ngli_staging_vk_begin_frame(struct staging_vk *s, int frame_index);
+
+/*
+ * Allocate size bytes of staging memory (with its offset aligned on
+ * alignment, which does not need to be a power of two) and select the
+ * command buffer in which the copy must be recorded.
+ */
+VkResult ngli_staging_vk_begin_upload(struct staging_vk *s, int size, int alignment,
+                                      struct staging_upload_vk *upload);
+
+/*
+ * Import size bytes of host memory as the copy source, without copying them.
+ * On success, release(release_arg) is called once the copy has completed and
+ * data must remain valid until then. VK_ERROR_FEATURE_NOT_PRESENT is returned
+ * if the memory cannot be imported (missing extension, incompatible
+ * alignment), in which case the caller is expected to fall back on
+ * ngli_staging_vk_begin_upload().
+ */
+VkResult ngli_staging_vk_begin_import(struct staging_vk *s, const void *data, int size, int alignment,
+                                      void (*release)(void *arg), void *release_arg,
+                                      struct staging_upload_vk *upload);
+VkResult ngli_staging_vk_end_upload(struct staging_vk *s, struct staging_upload_vk *upload);
+void ngli_staging_vk_freep(struct staging_vk **sp);
+
+#endif
@@ -29,6 +29,7 @@
 #include "internal.h"
 #include "log.h"
 #include "memory.h"
+#include "staging_vk.h"
 #include "texture_vk.h"
 #include "utils.h"
 #include "vkutils.h"
@@ -394,16 +395,19 @@ VkResult ngli_texture_vk_init(struct texture *s, const struct texture_params *pa
             return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
 
-    const VkMemoryAllocateInfo alloc_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = lazy_allocated ? 0 : mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
-    };
-    res = vkAllocateMemory(vk->device, &alloc_info, NULL, &s_priv->image_memory);
+    /*
+     * Lazily allocated memory is never sub-allocated so its commitment can
+     * be tracked per attachment
+     */
+    const int alloc_flags = NGLI_ALLOCATION_VK_FLAG_IMAGE |
+                            (lazy_allocated ? NGLI_ALLOCATION_VK_FLAG_DEDICATED : 0);
+    res = ngli_allocator_vk_alloc(gpu_ctx_vk->allocator, &mem_reqs, mem_type_index,
+                                  alloc_flags, &s_priv->image_memory);
     if (res != VK_SUCCESS)
         return res;
 
-    res = vkBindImageMemory(vk->device, s_priv->image, s_priv->image_memory, 0);
+    res = vkBindImageMemory(vk->device, s_priv->image, s_priv->image_memory.memory,
+                            s_priv->image_memory.offset);
     if (res != VK_SUCCESS)
         return res;
 
@@ -530,56 +534,13 @@ void ngli_texture_vk_copy_to_buffer(struct texture *s, struct buffer *buffer)
                            buffer_vk->buffer, 1, &region);
 }
 
-VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int linesize)
+static VkResult record_upload(struct texture *s, struct staging_upload_vk *upload, int linesize)
 {
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
     const struct texture_params *params = &s->params;
     struct texture_vk *s_priv = (struct texture_vk *)s;
 
-    /* Wrapped textures cannot update their content with this function */
-    ngli_assert(!s_priv->wrapped_image);
-    ngli_assert(params->usage & NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT);
-
-    if (!data)
-        return VK_SUCCESS;
-
-    if (!s_priv->staging_buffer || s_priv->staging_buffer_row_length != linesize) {
-        const int32_t width = linesize ? linesize : s->params.width;
-        const int32_t staging_buffer_size = width * s->params.height * s->params.depth * s_priv->bytes_per_pixel * s_priv->array_layers;
-
-        if (s_priv->staging_buffer_ptr) {
-            ngli_buffer_vk_unmap(s_priv->staging_buffer);
-            s_priv->staging_buffer_ptr = NULL;
-        }
-        ngli_buffer_vk_freep(&s_priv->staging_buffer);
-
-        s_priv->staging_buffer = ngli_buffer_vk_create(s->gpu_ctx);
-        if (!s_priv->staging_buffer)
-            return VK_ERROR_OUT_OF_HOST_MEMORY;
-
-        const int usage = NGLI_BUFFER_USAGE_DYNAMIC_BIT |
-                          NGLI_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                          NGLI_BUFFER_USAGE_MAP_WRITE;
-        VkResult res = ngli_buffer_vk_init(s_priv->staging_buffer, staging_buffer_size, usage);
-        if (res != VK_SUCCESS)
-            return res;
-
-        s_priv->staging_buffer_row_length = linesize;
-
-        res = ngli_buffer_vk_map(s_priv->staging_buffer, staging_buffer_size, 0, &s_priv->staging_buffer_ptr);
-        if (res != VK_SUCCESS)
-            return res;
-    }
-
-    memcpy(s_priv->staging_buffer_ptr, data, s_priv->staging_buffer->size);
-
-    struct cmd_vk *cmd_vk = gpu_ctx_vk->cur_cmd;
-    if (!cmd_vk) {
-        VkResult res = ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &cmd_vk);
-        if (res != VK_SUCCESS)
-            return res;
-    }
-    VkCommandBuffer cmd_buf = cmd_vk->cmd_buf;
+    VkCommandBuffer cmd_buf = upload->cmd->cmd_buf;
 
     const VkImageSubresourceRange subres_range = {
         .aspectMask     = get_vk_image_aspect_flags(s_priv->format),
@@ -599,7 +560,7 @@ VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int line
 
     const VkDeviceSize layer_size = s->params.width * s->params.height * s_priv->bytes_per_pixel;
     for (int32_t i = 0; i < s_priv->array_layers; i++) {
-        const VkDeviceSize offset = i * layer_size;
+        const VkDeviceSize offset = upload->offset + i * layer_size;
         const VkBufferImageCopy region = {
             .bufferOffset      = offset,
             .bufferRowLength   = linesize,
@@ -619,16 +580,13 @@ VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int line
 
         if (!ngli_darray_push(&copy_regions, &region)) {
             ngli_darray_reset(&copy_regions);
-            if (!gpu_ctx_vk->cur_cmd) {
-                ngli_cmd_vk_freep(&cmd_vk);
-            }
+            ngli_staging_vk_end_upload(gpu_ctx_vk->staging, upload);
             return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
     }
 
-    struct buffer_vk *staging_buffer_vk = (struct buffer_vk *)s_priv->staging_buffer;
     vkCmdCopyBufferToImage(cmd_buf,
-                           staging_buffer_vk->buffer,
+                           upload->buffer,
                            s_priv->image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            ngli_darray_count(&copy_regions),
@@ -642,11 +600,9 @@ VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int line
                             s_priv->image_layout,
                             &subres_range);
 
-    if (!gpu_ctx_vk->cur_cmd) {
-        VkResult res = ngli_cmd_vk_execute_transient(&cmd_vk);
-        if (res != VK_SUCCESS)
-            return res;
-    }
+    VkResult res = ngli_staging_vk_end_upload(gpu_ctx_vk->staging, upload);
+    if (res != VK_SUCCESS)
+        return res;
 
     if (params->mipmap_filter != NGLI_MIPMAP_FILTER_NONE)
         ngli_texture_generate_mipmap(s);
@@ -654,6 +610,64 @@ VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int line
     return VK_SUCCESS;
 }
 
+static int32_t get_upload_size(const struct texture *s, int linesize)
+{
+    const struct texture_vk *s_priv = (const struct texture_vk *)s;
+    const int32_t width = linesize ? linesize : s->params.width;
+    return width * s->params.height * s->params.depth * s_priv->bytes_per_pixel * s_priv->array_layers;
+}
+
+VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int linesize)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    const struct texture_params *params = &s->params;
+    struct texture_vk *s_priv = (struct texture_vk *)s;
+
+    /* Wrapped textures cannot update their content with this function */
+    ngli_assert(!s_priv->wrapped_image);
+    ngli_assert(params->usage & NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT);
+
+    if (!data)
+        return VK_SUCCESS;
+
+    const int32_t staging_size = get_upload_size(s, linesize);
+
+    /* The buffer offset must be a multiple of both 4 and the texel size */
+    struct staging_upload_vk upload;
+    VkResult res = ngli_staging_vk_begin_upload(gpu_ctx_vk->staging, staging_size,
+                                                4 * s_priv->bytes_per_pixel, &upload);
+    if (res != VK_SUCCESS)
+        return res;
+
+    memcpy(upload.mapped_data, data, staging_size);
+
+    return record_upload(s, &upload, linesize);
+}
+
+VkResult ngli_texture_vk_upload_borrowed(struct texture *s, const uint8_t *data, int linesize,
+                                         void (*release)(void *arg), void *arg)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    const struct texture_params *params = &s->params;
+    struct texture_vk *s_priv = (struct texture_vk *)s;
+
+    ngli_assert(!s_priv->wrapped_image);
+    ngli_assert(params->usage & NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT);
+
+    if (data && s_priv->array_layers == 1) {
+        struct staging_upload_vk upload;
+        VkResult res = ngli_staging_vk_begin_import(gpu_ctx_vk->staging, data, get_upload_size(s, linesize),
+                                                    4 * s_priv->bytes_per_pixel, release, arg, &upload);
+        if (res == VK_SUCCESS)
+            return record_upload(s, &upload, linesize);
+    }
+
+    /* The data cannot be imported, copy it through the staging ring instead */
+    VkResult res = ngli_texture_vk_upload(s, data, linesize);
+    release(arg);
+    return res;
+}
+
 VkResult ngli_texture_vk_generate_mipmap(struct texture *s)
 {
     struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
@@ -800,11 +814,7 @@ void ngli_texture_vk_freep(struct texture **sp)
         vkDestroyImageView(vk->device, s_priv->image_view, NULL);
     if (!s_priv->wrapped_image)
         vkDestroyImage(vk->device, s_priv->image, NULL);
-    vkFreeMemory(vk->device, s_priv->image_memory, NULL);
-
-    if (s_priv->staging_buffer_ptr)
-        ngli_buffer_vk_unmap(s_priv->staging_buffer);
-    ngli_buffer_freep(&s_priv->staging_buffer);
+    ngli_allocator_vk_free(gpu_ctx_vk->allocator, &s_priv->image_memory);
 
     ngli_freep(sp);
 }
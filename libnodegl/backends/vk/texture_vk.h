@@ -24,6 +24,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include "allocator_vk.h"
 #include "buffer.h"
 #include "texture.h"
 #include "vkcontext.h"
@@ -48,22 +49,21 @@ struct texture_vk {
     int wrapped_image;
     VkImageLayout default_image_layout;
     VkImageLayout image_layout;
-    VkDeviceMemory image_memory;
+    struct allocation_vk image_memory;
     VkImageView image_view;
     int wrapped_image_view;
     VkSampler sampler;
     int wrapped_sampler;
     int use_ycbcr_sampler;
     struct ycbcr_sampler_vk *ycbcr_sampler;
-    struct buffer *staging_buffer;
-    VkDeviceSize staging_buffer_row_length;
-    void *staging_buffer_ptr;
 };
 
 struct texture *ngli_texture_vk_create(struct gpu_ctx *gpu_ctx);
 VkResult ngli_texture_vk_init(struct texture *s, const struct texture_params *params);
 VkResult ngli_texture_vk_wrap(struct texture *s, const struct texture_vk_wrap_params *wrap_params);
 VkResult ngli_texture_vk_upload(struct texture *s, const uint8_t *data, int linesize);
+VkResult ngli_texture_vk_upload_borrowed(struct texture *s, const uint8_t *data, int linesize,
+                                         void (*release)(void *arg), void *arg);
 VkResult ngli_texture_vk_generate_mipmap(struct texture *s);
 void ngli_texture_vk_transition_layout(struct texture *s, VkImageLayout layout);
 void ngli_texture_vk_transition_to_default_layout(struct texture *s);
@@ -623,6 +623,7 @@ static VkResult create_device(struct vkcontext *s)
     static const char *optional_device_extensions[] = {
         VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
         VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME,
+        VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
         VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,
         VK_EXT_IMAGE_DRM_FORMAT_MODIFIER_EXTENSION_NAME,
         VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
@@ -803,6 +804,13 @@ struct vk_extension {
             DECLARE_FUNC(GetMemoryFdPropertiesKHR, 1),
             {0},
         },
+    }, {
+        .name = VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+        .device = 1,
+        .functions = (const struct vk_function[]) {
+            DECLARE_FUNC(GetMemoryHostPointerPropertiesEXT, 1),
+            {0},
+        },
     }, {
         .name = VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
         .device = 1,
@@ -864,9 +872,33 @@ static VkResult load_functions(struct vkcontext *s)
     return VK_SUCCESS;
 }
 
+static void query_external_memory_host_props(struct vkcontext *s)
+{
+    if (!ngli_vkcontext_has_extension(s, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, 1))
+        return;
+
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT host_props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+    };
+    VkPhysicalDeviceProperties2 props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &host_props,
+    };
+    vkGetPhysicalDeviceProperties2(s->phy_device, &props);
+    s->min_imported_host_pointer_alignment = host_props.minImportedHostPointerAlignment;
+}
+
 struct vkcontext *ngli_vkcontext_create(void)
 {
     struct vkcontext *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    if (pthread_mutex_init(&s->queue_lock, NULL)) {
+        ngli_free(s);
+        return NULL;
+    }
+
     return s;
 }
 
@@ -904,6 +936,8 @@ VkResult ngli_vkcontext_init(struct vkcontext *s, const struct ngl_config *confi
     if (res != VK_SUCCESS)
         return res;
 
+    query_external_memory_host_props(s);
+
     res = query_swapchain_support(s);
     if (res != VK_SUCCESS)
         return res;
@@ -920,6 +954,16 @@ void *ngli_vkcontext_get_proc_addr(struct vkcontext *s, const char *name)
     return vkGetInstanceProcAddr(s->instance, name);
 }
 
+void ngli_vkcontext_lock_queues(struct vkcontext *s)
+{
+    pthread_mutex_lock(&s->queue_lock);
+}
+
+void ngli_vkcontext_unlock_queues(struct vkcontext *s)
+{
+    pthread_mutex_unlock(&s->queue_lock);
+}
+
 int ngli_vkcontext_has_extension(const struct vkcontext *s, const char *name, int device)
 {
     uint32_t nb_extensions = device ? s->nb_device_extensions : s->nb_extensions;
@@ -965,5 +1009,6 @@ void ngli_vkcontext_freep(struct vkcontext **sp)
         XCloseDisplay(s->x11_display);
 #endif
 
+    pthread_mutex_destroy(&s->queue_lock);
     ngli_freep(sp);
 }
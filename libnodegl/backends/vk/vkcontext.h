@@ -31,6 +31,7 @@
 
 #include "darray.h"
 #include "nodegl.h"
+#include "pthread_compat.h"
 #include "rendertarget.h"
 #include "texture.h"
 
@@ -68,12 +69,20 @@ struct vkcontext {
     VkQueue present_queue;
     VkDevice device;
 
+    /*
+     * The queues (and the device wait) require an external synchronization
+     * since the device can be shared between contexts running in different
+     * threads
+     */
+    pthread_mutex_t queue_lock;
+
     int preferred_depth_format;
     int preferred_depth_stencil_format;
 
     VkPhysicalDeviceFeatures dev_features;
     VkPhysicalDeviceMemoryProperties phydev_mem_props;
     VkPhysicalDeviceLimits phydev_limits;
+    VkDeviceSize min_imported_host_pointer_alignment; /* 0 if host memory cannot be imported */
 
     VkSurfaceCapabilitiesKHR surface_caps;
     VkSurfaceFormatKHR *surface_formats;
@@ -91,6 +100,7 @@ struct vkcontext {
 #endif
     VK_DECLARE_FUNC(GetMemoryFdKHR);
     VK_DECLARE_FUNC(GetMemoryFdPropertiesKHR);
+    VK_DECLARE_FUNC(GetMemoryHostPointerPropertiesEXT);
     VK_DECLARE_FUNC(GetRefreshCycleDurationGOOGLE);
     VK_DECLARE_FUNC(GetPastPresentationTimingGOOGLE);
 };
@@ -102,6 +112,8 @@ int ngli_vkcontext_has_extension(const struct vkcontext *s, const char *name, in
 VkFormat ngli_vkcontext_find_supported_format(struct vkcontext *s, const VkFormat *formats,
                                               VkImageTiling tiling, VkFormatFeatureFlags features);
 int ngli_vkcontext_find_memory_type(struct vkcontext *s, uint32_t type, VkMemoryPropertyFlags props);
+void ngli_vkcontext_lock_queues(struct vkcontext *s);
+void ngli_vkcontext_unlock_queues(struct vkcontext *s);
 void ngli_vkcontext_freep(struct vkcontext **sp);
 
 #endif /* VKCONTEXT_H */
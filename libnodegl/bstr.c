@@ -19,6 +19,7 @@
  * under the License.
  */
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,27 @@ struct bstr {
     int state;
 };
 
+/*
+ * Grow the buffer geometrically so that building a large string through many
+ * small prints does not reallocate (and possibly copy) it at every print
+ */
+static int grow(struct bstr *b, size_t len)
+{
+    const size_t new_size = NGLI_MAX((size_t)b->bufsize * 2, b->len + len + 1 + BUFFER_PADDING);
+    if (new_size > INT_MAX) {
+        b->state = NGL_ERROR_LIMIT_EXCEEDED;
+        return b->state;
+    }
+    void *ptr = ngli_realloc(b->str, new_size);
+    if (!ptr) {
+        b->state = NGL_ERROR_MEMORY;
+        return b->state;
+    }
+    b->str = ptr;
+    b->bufsize = (int)new_size;
+    return 0;
+}
+
 struct bstr *ngli_bstr_create(void)
 {
     struct bstr *b = ngli_calloc(1, sizeof(*b));
@@ -56,16 +78,8 @@ void ngli_bstr_print(struct bstr *b, const char *str)
 {
     const size_t len = strlen(str);
     const size_t avail = b->bufsize - b->len;
-    if (len + 1 > avail) {
-        const int new_size = b->len + len + 1 + BUFFER_PADDING;
-        void *ptr = ngli_realloc(b->str, new_size);
-        if (!ptr) {
-            b->state = NGL_ERROR_MEMORY;
-            return;
-        }
-        b->str = ptr;
-        b->bufsize = new_size;
-    }
+    if (len + 1 > avail && grow(b, len) < 0)
+        return;
     memcpy(b->str + b->len, str, len + 1);
     b->len += len;
 }
@@ -85,14 +99,10 @@ void ngli_bstr_printf(struct bstr *b, const char *fmt, ...)
     }
 
     if (len + 1 > avail) {
-        const int new_size = b->len + len + 1 + BUFFER_PADDING;
-        void *ptr = ngli_realloc(b->str, new_size);
-        if (!ptr) {
-            b->state = NGL_ERROR_MEMORY;
+        if (grow(b, len) < 0) {
+            b->str[b->len] = 0;
             return;
         }
-        b->str = ptr;
-        b->bufsize = new_size;
         va_start(va, fmt);
         len = vsnprintf(b->str + b->len, len + 1, fmt, va);
         va_end(va);
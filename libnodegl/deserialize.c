@@ -19,16 +19,24 @@
  * under the License.
  */
 
+#include <errno.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "darray.h"
 #include "log.h"
 #include "memory.h"
 #include "nodegl.h"
 #include "internal.h"
 #include "params.h"
+#include "utils.h"
 
 static int parse_int(const char *s, int *valp)
 {
@@ -517,22 +525,89 @@ static int set_node_params(struct darray *nodes_array, char *str,
     return 0;
 }
 
-struct ngl_node *ngl_node_deserialize(const char *str)
+/* Size of the reads requested to the callback */
+#define READ_CHUNK_SIZE 4096
+
+struct line_reader {
+    ngl_read_callback_type read_cb;
+    void *read_arg;
+    char *buf;
+    size_t size;     /* number of bytes in buf */
+    size_t capacity;
+    size_t pos;      /* start of the next line in buf */
+    int eof;
+};
+
+/*
+ * Return the next line (nul-terminated, without its line feed), reading more
+ * data only when the pending input does not contain a full line yet. Only the
+ * current line is kept in memory.
+ */
+static int get_line(struct line_reader *r, char **linep)
+{
+    size_t scan = r->pos;
+    for (;;) {
+        char *eol = memchr(r->buf + scan, '\n', r->size - scan);
+        if (eol) {
+            *eol = 0;
+            *linep = r->buf + r->pos;
+            r->pos = eol - r->buf + 1;
+            return 1;
+        }
+
+        if (r->eof) {
+            if (r->pos == r->size)
+                return 0;
+            r->buf[r->size] = 0;
+            *linep = r->buf + r->pos;
+            r->pos = r->size;
+            return 1;
+        }
+
+        /* Drop the consumed lines before reading more data */
+        scan = r->size;
+        if (r->pos) {
+            memmove(r->buf, r->buf + r->pos, r->size - r->pos);
+            r->size -= r->pos;
+            scan -= r->pos;
+            r->pos = 0;
+        }
+
+        /* Keep room for a chunk and the nul terminator */
+        if (r->capacity - r->size < READ_CHUNK_SIZE + 1) {
+            const size_t capacity = NGLI_MAX(r->capacity * 2, r->size + READ_CHUNK_SIZE + 1);
+            char *buf = ngli_realloc(r->buf, capacity);
+            if (!buf)
+                return NGL_ERROR_MEMORY;
+            r->buf = buf;
+            r->capacity = capacity;
+        }
+
+        const int n = r->read_cb(r->read_arg, r->buf + r->size, READ_CHUNK_SIZE);
+        if (n < 0)
+            return n;
+        if (n > READ_CHUNK_SIZE)
+            return NGL_ERROR_INVALID_USAGE;
+        r->size += n;
+        r->eof = n == 0;
+    }
+}
+
+struct ngl_node *ngl_node_deserialize_from_callback(ngl_read_callback_type read_cb, void *read_arg)
 {
     struct ngl_node *node = NULL;
     struct darray nodes_array;
+    struct line_reader r = {.read_cb = read_cb, .read_arg = read_arg};
 
     ngli_darray_init(&nodes_array, sizeof(struct ngl_node *), 0);
 
-    char *s = ngli_strdup(str);
-    if (!s)
-        return NULL;
-
-    char *sstart = s;
-    char *send = s + strlen(s);
+    char *s;
+    int ret = get_line(&r, &s);
+    if (ret < 0)
+        goto end;
 
     int major, minor, micro;
-    int n = sscanf(s, "# Node.GL v%d.%d.%d", &major, &minor, &micro);
+    int n = ret ? sscanf(s, "# Node.GL v%d.%d.%d", &major, &minor, &micro) : 0;
     if (n != 3) {
         LOG(ERROR, "invalid serialized scene");
         goto end;
@@ -543,11 +618,28 @@ struct ngl_node *ngl_node_deserialize(const char *str)
             NGL_VERSION_MAJOR, NGL_VERSION_MINOR, NGL_VERSION_MICRO);
         goto end;
     }
-    s += strcspn(s, "\n");
-    if (*s == '\n')
-        s++;
 
-    while (s < send - 4) {
+    int nb_blank_lines = 0;
+    for (;;) {
+        ret = get_line(&r, &s);
+        if (ret < 0) {
+            node = NULL;
+            break;
+        }
+        if (!ret)
+            break;
+
+        /* Blank lines are tolerated, but only at the end of the stream */
+        if (!s[strspn(s, " \t\r")]) {
+            nb_blank_lines++;
+            continue;
+        }
+        if (nb_blank_lines || strlen(s) < 4) {
+            LOG(ERROR, "invalid serialized node: \"%s\"", s);
+            node = NULL;
+            break;
+        }
+
         const int type = NGLI_FOURCC(s[0], s[1], s[2], s[3]);
         s += 4;
         if (*s == ' ')
@@ -562,16 +654,11 @@ struct ngl_node *ngl_node_deserialize(const char *str)
             break;
         }
 
-        size_t eol = strcspn(s, "\n");
-        s[eol] = 0;
-
-        int ret = set_node_params(&nodes_array, s, node);
+        ret = set_node_params(&nodes_array, s, node);
         if (ret < 0) {
             node = NULL;
             break;
         }
-
-        s += eol + 1;
     }
 
     if (node)
@@ -583,6 +670,50 @@ struct ngl_node *ngl_node_deserialize(const char *str)
 
 end:
     ngli_darray_reset(&nodes_array);
-    ngli_free(sstart);
+    ngli_free(r.buf);
     return node;
 }
+
+struct string_reader {
+    const char *str;
+    size_t size;
+};
+
+static int read_string(void *arg, char *buf, int size)
+{
+    struct string_reader *r = arg;
+    const size_t n = NGLI_MIN(r->size, (size_t)size);
+    memcpy(buf, r->str, n);
+    r->str += n;
+    r->size -= n;
+    return (int)n;
+}
+
+struct ngl_node *ngl_node_deserialize(const char *str)
+{
+    struct string_reader r = {.str = str, .size = strlen(str)};
+    return ngl_node_deserialize_from_callback(read_string, &r);
+}
+
+static int read_fd(void *arg, char *buf, int size)
+{
+    const int fd = *(const int *)arg;
+    for (;;) {
+#ifdef _WIN32
+        const int n = _read(fd, buf, size);
+#else
+        const ssize_t n = read(fd, buf, size);
+#endif
+        if (n >= 0)
+            return (int)n;
+        if (errno != EINTR) {
+            LOG(ERROR, "unable to read serialized scene: %s", strerror(errno));
+            return NGL_ERROR_IO;
+        }
+    }
+}
+
+struct ngl_node *ngl_node_deserialize_from_fd(int fd)
+{
+    return ngl_node_deserialize_from_callback(read_fd, &fd);
+}
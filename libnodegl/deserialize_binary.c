@@ -0,0 +1,400 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "internal.h"
+#include "params.h"
+#include "serialize_binary.h"
+
+struct reader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+};
+
+struct deserializer {
+    const uint8_t *data_section;
+    size_t data_section_size;
+    struct ngl_node **nodes;
+    int nb_nodes; /* number of nodes created so far */
+};
+
+static uint32_t read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t read_u64(const uint8_t *p)
+{
+    return (uint64_t)read_u32(p) | (uint64_t)read_u32(p + 4) << 32;
+}
+
+static const uint8_t *get_bytes(struct reader *r, size_t size)
+{
+    if (size > r->size - r->pos)
+        return NULL;
+    const uint8_t *p = r->data + r->pos;
+    r->pos += size;
+    return p;
+}
+
+static int get_u8(struct reader *r, uint8_t *vp)
+{
+    const uint8_t *p = get_bytes(r, 1);
+    if (!p)
+        return NGL_ERROR_INVALID_DATA;
+    *vp = *p;
+    return 0;
+}
+
+static int get_u32(struct reader *r, uint32_t *vp)
+{
+    const uint8_t *p = get_bytes(r, 4);
+    if (!p)
+        return NGL_ERROR_INVALID_DATA;
+    *vp = read_u32(p);
+    return 0;
+}
+
+static int get_u64(struct reader *r, uint64_t *vp)
+{
+    const uint8_t *p = get_bytes(r, 8);
+    if (!p)
+        return NGL_ERROR_INVALID_DATA;
+    *vp = read_u64(p);
+    return 0;
+}
+
+static int get_u32s(struct reader *r, int n, uint32_t *v)
+{
+    for (int i = 0; i < n; i++) {
+        int ret = get_u32(r, &v[i]);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static int get_f32s(struct reader *r, int n, float *v)
+{
+    for (int i = 0; i < n; i++) {
+        uint32_t u;
+        int ret = get_u32(r, &u);
+        if (ret < 0)
+            return ret;
+        memcpy(&v[i], &u, sizeof(u));
+    }
+    return 0;
+}
+
+static int get_f64(struct reader *r, double *vp)
+{
+    uint64_t u;
+    int ret = get_u64(r, &u);
+    if (ret < 0)
+        return ret;
+    memcpy(vp, &u, sizeof(u));
+    return 0;
+}
+
+/* Read a key of at most 255 characters into a nul terminated buffer */
+static int get_key(struct reader *r, char *key)
+{
+    uint8_t len;
+    int ret = get_u8(r, &len);
+    if (ret < 0)
+        return ret;
+    const uint8_t *p = get_bytes(r, len);
+    if (!p)
+        return NGL_ERROR_INVALID_DATA;
+    memcpy(key, p, len);
+    key[len] = 0;
+    return 0;
+}
+
+static int get_node(struct deserializer *s, struct reader *r, struct ngl_node **nodep)
+{
+    uint32_t index;
+    int ret = get_u32(r, &index);
+    if (ret < 0)
+        return ret;
+    /* Only the nodes preceding the current one can be referenced */
+    if (index >= (uint32_t)s->nb_nodes - 1)
+        return NGL_ERROR_INVALID_DATA;
+    *nodep = s->nodes[index];
+    return 0;
+}
+
+static int set_string_param(uint8_t *dstp, const struct node_param *par, struct reader *r)
+{
+    const size_t len = r->size - r->pos;
+    char *str = ngli_malloc(len + 1);
+    if (!str)
+        return NGL_ERROR_MEMORY;
+    memcpy(str, get_bytes(r, len), len);
+    str[len] = 0;
+
+    int ret;
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_SELECT: ret = ngli_params_set_select(dstp, par, str); break;
+    case NGLI_PARAM_TYPE_FLAGS:  ret = ngli_params_set_flags(dstp, par, str);  break;
+    default:                     ret = ngli_params_set_str(dstp, par, str);    break;
+    }
+    ngli_free(str);
+    return ret;
+}
+
+static int set_data_param(struct deserializer *s, uint8_t *dstp,
+                          const struct node_param *par, struct reader *r)
+{
+    uint64_t offset, size;
+    int ret;
+    if ((ret = get_u64(r, &offset)) < 0 ||
+        (ret = get_u64(r, &size)) < 0)
+        return ret;
+    if (offset > s->data_section_size || size > s->data_section_size - offset || size > INT_MAX)
+        return NGL_ERROR_INVALID_DATA;
+    return ngli_params_set_data(dstp, par, (int)size, s->data_section + offset);
+}
+
+static int set_nodelist_param(struct deserializer *s, uint8_t *dstp,
+                              const struct node_param *par, struct reader *r)
+{
+    uint32_t count;
+    int ret = get_u32(r, &count);
+    if (ret < 0)
+        return ret;
+    for (uint32_t i = 0; i < count; i++) {
+        struct ngl_node *node;
+        ret = get_node(s, r, &node);
+        if (ret < 0)
+            return ret;
+        ret = ngli_params_add_nodes(dstp, par, 1, &node);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static int set_f64list_param(uint8_t *dstp, const struct node_param *par, struct reader *r)
+{
+    uint32_t count;
+    int ret = get_u32(r, &count);
+    if (ret < 0)
+        return ret;
+    if (count > (r->size - r->pos) / sizeof(double))
+        return NGL_ERROR_INVALID_DATA;
+    if (!count)
+        return 0;
+
+    double *elems = ngli_calloc(count, sizeof(*elems));
+    if (!elems)
+        return NGL_ERROR_MEMORY;
+    for (uint32_t i = 0; i < count; i++)
+        get_f64(r, &elems[i]);
+    ret = ngli_params_add_f64s(dstp, par, count, elems);
+    ngli_free(elems);
+    return ret;
+}
+
+static int set_nodedict_param(struct deserializer *s, uint8_t *dstp,
+                              const struct node_param *par, struct reader *r)
+{
+    uint32_t count;
+    int ret = get_u32(r, &count);
+    if (ret < 0)
+        return ret;
+    for (uint32_t i = 0; i < count; i++) {
+        char key[UINT8_MAX + 1];
+        struct ngl_node *node;
+        if ((ret = get_key(r, key)) < 0 ||
+            (ret = get_node(s, r, &node)) < 0 ||
+            (ret = ngli_params_set_dict(dstp, par, key, node)) < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static int set_param(struct deserializer *s, uint8_t *dstp, const struct node_param *par,
+                     int flags, struct reader *r)
+{
+    int ret;
+    uint32_t u[4];
+    float f[16];
+    double d;
+    struct ngl_node *node;
+
+    if (flags & NGLI_BINARY_PARAM_FLAG_NODE) {
+        if (!(par->flags & NGLI_PARAM_FLAG_ALLOW_NODE))
+            return NGL_ERROR_INVALID_DATA;
+        if ((ret = get_node(s, r, &node)) < 0)
+            return ret;
+        return ngli_params_set_node(dstp, par, node);
+    }
+
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_SELECT:
+    case NGLI_PARAM_TYPE_FLAGS:
+    case NGLI_PARAM_TYPE_STR:      return set_string_param(dstp, par, r);
+    case NGLI_PARAM_TYPE_BOOL:     if ((ret = get_u32s(r, 1, u)) < 0) return ret; return ngli_params_set_bool(dstp, par, (int)u[0]);
+    case NGLI_PARAM_TYPE_I32:      if ((ret = get_u32s(r, 1, u)) < 0) return ret; return ngli_params_set_i32(dstp, par, (int)u[0]);
+    case NGLI_PARAM_TYPE_U32:      if ((ret = get_u32s(r, 1, u)) < 0) return ret; return ngli_params_set_u32(dstp, par, u[0]);
+    case NGLI_PARAM_TYPE_F32:      if ((ret = get_f32s(r, 1, f)) < 0) return ret; return ngli_params_set_f32(dstp, par, f[0]);
+    case NGLI_PARAM_TYPE_F64:      if ((ret = get_f64(r, &d)) < 0)    return ret; return ngli_params_set_f64(dstp, par, d);
+    case NGLI_PARAM_TYPE_RATIONAL: if ((ret = get_u32s(r, 2, u)) < 0) return ret; return ngli_params_set_rational(dstp, par, (int)u[0], (int)u[1]);
+    case NGLI_PARAM_TYPE_IVEC2:    if ((ret = get_u32s(r, 2, u)) < 0) return ret; return ngli_params_set_ivec2(dstp, par, (const int *)u);
+    case NGLI_PARAM_TYPE_IVEC3:    if ((ret = get_u32s(r, 3, u)) < 0) return ret; return ngli_params_set_ivec3(dstp, par, (const int *)u);
+    case NGLI_PARAM_TYPE_IVEC4:    if ((ret = get_u32s(r, 4, u)) < 0) return ret; return ngli_params_set_ivec4(dstp, par, (const int *)u);
+    case NGLI_PARAM_TYPE_UVEC2:    if ((ret = get_u32s(r, 2, u)) < 0) return ret; return ngli_params_set_uvec2(dstp, par, u);
+    case NGLI_PARAM_TYPE_UVEC3:    if ((ret = get_u32s(r, 3, u)) < 0) return ret; return ngli_params_set_uvec3(dstp, par, u);
+    case NGLI_PARAM_TYPE_UVEC4:    if ((ret = get_u32s(r, 4, u)) < 0) return ret; return ngli_params_set_uvec4(dstp, par, u);
+    case NGLI_PARAM_TYPE_VEC2:     if ((ret = get_f32s(r, 2, f)) < 0) return ret; return ngli_params_set_vec2(dstp, par, f);
+    case NGLI_PARAM_TYPE_VEC3:     if ((ret = get_f32s(r, 3, f)) < 0) return ret; return ngli_params_set_vec3(dstp, par, f);
+    case NGLI_PARAM_TYPE_VEC4:     if ((ret = get_f32s(r, 4, f)) < 0) return ret; return ngli_params_set_vec4(dstp, par, f);
+    case NGLI_PARAM_TYPE_MAT4:     if ((ret = get_f32s(r, 16, f)) < 0) return ret; return ngli_params_set_mat4(dstp, par, f);
+    case NGLI_PARAM_TYPE_DATA:     return set_data_param(s, dstp, par, r);
+    case NGLI_PARAM_TYPE_NODE:     if ((ret = get_node(s, r, &node)) < 0) return ret; return ngli_params_set_node(dstp, par, node);
+    case NGLI_PARAM_TYPE_NODELIST: return set_nodelist_param(s, dstp, par, r);
+    case NGLI_PARAM_TYPE_F64LIST:  return set_f64list_param(dstp, par, r);
+    case NGLI_PARAM_TYPE_NODEDICT: return set_nodedict_param(s, dstp, par, r);
+    default:
+        LOG(ERROR, "cannot deserialize %s: unsupported parameter type", par->key);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+}
+
+static int set_node_params(struct deserializer *s, struct reader *r, struct ngl_node *node)
+{
+    uint32_t nb_params;
+    int ret = get_u32(r, &nb_params);
+    if (ret < 0)
+        return ret;
+
+    for (uint32_t i = 0; i < nb_params; i++) {
+        char key[UINT8_MAX + 1];
+        uint8_t flags;
+        uint32_t value_size;
+        if ((ret = get_key(r, key)) < 0 ||
+            (ret = get_u8(r, &flags)) < 0 ||
+            (ret = get_u32(r, &value_size)) < 0)
+            return ret;
+
+        const uint8_t *value = get_bytes(r, value_size);
+        if (!value)
+            return NGL_ERROR_INVALID_DATA;
+
+        uint8_t *base_ptr = node->opts;
+        const struct node_param *par = ngli_node_param_find(node, key, &base_ptr);
+        if (!par) {
+            LOG(ERROR, "unable to find parameter %s.%s", node->cls->name, key);
+            return NGL_ERROR_INVALID_DATA;
+        }
+
+        /* The value must be entirely consumed */
+        struct reader value_reader = {.data = value, .size = value_size};
+        ret = set_param(s, base_ptr + par->offset, par, flags, &value_reader);
+        if (ret >= 0 && value_reader.pos != value_reader.size)
+            ret = NGL_ERROR_INVALID_DATA;
+        if (ret < 0) {
+            LOG(ERROR, "unable to set node param %s.%s: %s",
+                node->cls->name, par->key, NGLI_RET_STR(ret));
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+struct ngl_node *ngl_node_deserialize_binary(const uint8_t *data, size_t size)
+{
+    if (size < NGLI_BINARY_HEADER_SIZE || memcmp(data, NGLI_BINARY_MAGIC, 4)) {
+        LOG(ERROR, "invalid binary serialized scene");
+        return NULL;
+    }
+
+    const uint32_t version = read_u32(data + 4);
+    if (version != NGLI_BINARY_VERSION) {
+        LOG(ERROR, "unsupported binary format version %u", version);
+        return NULL;
+    }
+
+    const uint32_t lib_version = read_u32(data + 8);
+    if (lib_version != NGL_VERSION_INT) {
+        LOG(ERROR, "mismatching version: %d.%d.%d != %d.%d.%d",
+            lib_version >> 16, lib_version >> 8 & 0xff, lib_version & 0xff,
+            NGL_VERSION_MAJOR, NGL_VERSION_MINOR, NGL_VERSION_MICRO);
+        return NULL;
+    }
+
+    const uint32_t nb_nodes = read_u32(data + 12);
+    const uint64_t data_offset = read_u64(data + 16);
+    const uint64_t data_size = read_u64(data + 24);
+    if (data_offset < NGLI_BINARY_HEADER_SIZE || data_offset > size ||
+        data_size > size - data_offset ||
+        !nb_nodes || nb_nodes > (data_offset - NGLI_BINARY_HEADER_SIZE) / 8) {
+        LOG(ERROR, "invalid binary serialized scene");
+        return NULL;
+    }
+
+    struct deserializer s = {
+        .data_section      = data + data_offset,
+        .data_section_size = data_size,
+    };
+    s.nodes = ngli_calloc(nb_nodes, sizeof(*s.nodes));
+    if (!s.nodes)
+        return NULL;
+
+    struct reader r = {
+        .data = data,
+        .size = data_offset,
+        .pos  = NGLI_BINARY_HEADER_SIZE,
+    };
+
+    struct ngl_node *root = NULL;
+    for (uint32_t i = 0; i < nb_nodes; i++) {
+        uint32_t type;
+        if (get_u32(&r, &type) < 0) {
+            LOG(ERROR, "invalid binary serialized scene");
+            goto end;
+        }
+
+        struct ngl_node *node = ngl_node_create(type);
+        if (!node)
+            goto end;
+        s.nodes[s.nb_nodes++] = node;
+
+        if (set_node_params(&s, &r, node) < 0)
+            goto end;
+    }
+    root = ngl_node_ref(s.nodes[nb_nodes - 1]);
+
+end:
+    for (int i = 0; i < s.nb_nodes; i++)
+        ngl_node_unrefp(&s.nodes[i]);
+    ngli_free(s.nodes);
+    return root;
+}
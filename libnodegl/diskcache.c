@@ -0,0 +1,227 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "diskcache.h"
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+#define DISKCACHE_MAGIC   NGLI_FOURCC('n','g','l','c')
+#define DISKCACHE_VERSION 1
+
+struct entry_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t data_size;
+};
+
+int ngli_diskcache_init(struct diskcache *s, const char *dir)
+{
+    memset(s, 0, sizeof(*s));
+    if (!dir)
+        return 0;
+    s->dir = ngli_strdup(dir);
+    if (!s->dir)
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+int ngli_diskcache_enabled(const struct diskcache *s)
+{
+    return s->dir != NULL;
+}
+
+static char *get_entry_path(const struct diskcache *s, const char *key)
+{
+    return ngli_asprintf("%s/%08x.bin", s->dir, ngli_crc32(key));
+}
+
+static int load_entry(FILE *fp, const char *key, void **datap, size_t *sizep)
+{
+    struct entry_header hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1)
+        return NGL_ERROR_IO;
+
+    const size_t key_size = strlen(key);
+    if (hdr.magic != DISKCACHE_MAGIC ||
+        hdr.version != DISKCACHE_VERSION ||
+        hdr.key_size != key_size)
+        return NGL_ERROR_NOT_FOUND;
+
+    char *stored_key = ngli_malloc(key_size);
+    if (!stored_key)
+        return NGL_ERROR_MEMORY;
+    if (fread(stored_key, 1, key_size, fp) != key_size) {
+        ngli_free(stored_key);
+        return NGL_ERROR_IO;
+    }
+    const int match = !memcmp(stored_key, key, key_size);
+    ngli_free(stored_key);
+    if (!match)
+        return NGL_ERROR_NOT_FOUND;
+
+    void *data = ngli_malloc(hdr.data_size ? hdr.data_size : 1);
+    if (!data)
+        return NGL_ERROR_MEMORY;
+    if (fread(data, 1, hdr.data_size, fp) != hdr.data_size) {
+        ngli_free(data);
+        return NGL_ERROR_IO;
+    }
+
+    *datap = data;
+    *sizep = hdr.data_size;
+    return 0;
+}
+
+int ngli_diskcache_load(struct diskcache *s, const char *key, void **datap, size_t *sizep)
+{
+    *datap = NULL;
+    *sizep = 0;
+
+    if (!s->dir)
+        return NGL_ERROR_NOT_FOUND;
+
+    char *path = get_entry_path(s, key);
+    if (!path)
+        return NGL_ERROR_MEMORY;
+
+    int ret = NGL_ERROR_NOT_FOUND;
+    FILE *fp = fopen(path, "rb");
+    if (fp) {
+        ret = load_entry(fp, key, datap, sizep);
+        fclose(fp);
+        if (ret == NGL_ERROR_IO)
+            LOG(WARNING, "could not read cache entry %s, ignoring it", path);
+    }
+    ngli_free(path);
+
+    if (ret == NGL_ERROR_MEMORY)
+        return ret;
+    if (ret < 0) {
+        s->nb_misses++;
+        return NGL_ERROR_NOT_FOUND;
+    }
+
+    s->nb_hits++;
+    return 0;
+}
+
+int ngli_diskcache_store(struct diskcache *s, const char *key, const void *data, size_t size)
+{
+    if (!s->dir)
+        return 0;
+
+    const size_t key_size = strlen(key);
+    if (key_size > UINT32_MAX || size > UINT32_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    char *path = get_entry_path(s, key);
+    if (!path)
+        return NGL_ERROR_MEMORY;
+
+    /*
+     * The entry is written into a temporary file which is then atomically
+     * renamed so that a concurrent reader (typically another process sharing
+     * the same cache directory) never observes a partially written entry.
+     * The temporary file name must be unique across the processes, and
+     * across the caches and successive stores within a process.
+     */
+    char *tmp_path = ngli_asprintf("%s.%d.%p.%d.tmp", path, (int)getpid(), (void *)s, s->nb_stores++);
+    if (!tmp_path) {
+        ngli_free(path);
+        return NGL_ERROR_MEMORY;
+    }
+
+    int ret = 0;
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        LOG(WARNING, "could not open %s for writing: %s", tmp_path, strerror(errno));
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+
+    const struct entry_header hdr = {
+        .magic     = DISKCACHE_MAGIC,
+        .version   = DISKCACHE_VERSION,
+        .key_size  = (uint32_t)key_size,
+        .data_size = (uint32_t)size,
+    };
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        fwrite(key, 1, key_size, fp) != key_size ||
+        fwrite(data, 1, size, fp) != size)
+        ret = NGL_ERROR_IO;
+    if (fclose(fp) != 0)
+        ret = NGL_ERROR_IO;
+
+    if (ret == 0) {
+#ifdef _WIN32
+        remove(path);
+#endif
+        if (rename(tmp_path, path) != 0)
+            ret = NGL_ERROR_IO;
+    }
+
+    if (ret < 0) {
+        LOG(WARNING, "could not write cache entry %s", path);
+        remove(tmp_path);
+    }
+
+end:
+    ngli_free(tmp_path);
+    ngli_free(path);
+    return ret;
+}
+
+void ngli_diskcache_reject(struct diskcache *s)
+{
+    ngli_assert(s->nb_hits > 0);
+    s->nb_hits--;
+    s->nb_misses++;
+}
+
+void ngli_diskcache_get_stats(const struct diskcache *s, int *nb_hitsp, int *nb_missesp)
+{
+    *nb_hitsp = s->nb_hits;
+    *nb_missesp = s->nb_misses;
+}
+
+void ngli_diskcache_reset(struct diskcache *s)
+{
+    if (s->dir && (s->nb_hits || s->nb_misses))
+        LOG(INFO, "program cache %s: %d hit(s), %d miss(es)",
+            s->dir, s->nb_hits, s->nb_misses);
+    ngli_freep(&s->dir);
+    memset(s, 0, sizeof(*s));
+}
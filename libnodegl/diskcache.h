@@ -0,0 +1,65 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <stddef.h>
+
+/*
+ * Key/value store backed by a directory, used to keep compiled programs
+ * around across runs. Each entry is stored in its own file named after the
+ * CRC32 of the key; the complete key is also written in the file and
+ * compared on load so a hash collision is reported as a miss.
+ *
+ * The cache is disabled (every lookup is a miss and stores are ignored) if
+ * no directory is specified at init.
+ */
+struct diskcache {
+    char *dir;
+    int nb_hits;
+    int nb_misses;
+    int nb_stores;
+};
+
+int ngli_diskcache_init(struct diskcache *s, const char *dir);
+int ngli_diskcache_enabled(const struct diskcache *s);
+
+/*
+ * Load the entry associated with key into a newly allocated buffer which
+ * must be released by the caller with ngli_free(). Return
+ * NGL_ERROR_NOT_FOUND on a miss.
+ */
+int ngli_diskcache_load(struct diskcache *s, const char *key, void **datap, size_t *sizep);
+int ngli_diskcache_store(struct diskcache *s, const char *key, const void *data, size_t size);
+
+/*
+ * Account the last successful load as a miss, for callers which end up not
+ * being able to use the loaded data (such as a program binary rejected by
+ * the driver)
+ */
+void ngli_diskcache_reject(struct diskcache *s);
+
+/* Number of lookups which hit and missed the cache since init */
+void ngli_diskcache_get_stats(const struct diskcache *s, int *nb_hitsp, int *nb_missesp);
+void ngli_diskcache_reset(struct diskcache *s);
+
+#endif
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "darray.h"
+#include "draw_list.h"
+#include "graphicstate.h"
+#include "memory.h"
+#include "nodegl.h"
+
+struct draw_list {
+    struct gpu_ctx *gpu_ctx;
+    struct darray packets; /* struct draw_packet */
+    struct draw_list_stats stats;
+    int64_t flush_count;
+};
+
+struct draw_list *ngli_draw_list_create(struct gpu_ctx *gpu_ctx)
+{
+    struct draw_list *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+    ngli_darray_init(&s->packets, sizeof(struct draw_packet), 0);
+    return s;
+}
+
+int ngli_draw_list_add(struct draw_list *s, const struct draw_packet *packet)
+{
+    struct draw_packet *dst = ngli_darray_push(&s->packets, packet);
+    if (!dst)
+        return NGL_ERROR_MEMORY;
+    dst->index = ngli_darray_count(&s->packets) - 1;
+    return 0;
+}
+
+/*
+ * With a strict depth test writing the depth, the fragment with the closest
+ * depth is kept whatever the order of the draws. The fragments with the exact
+ * same depth are the exception since the first one wins: reordering may
+ * change them, which is documented in ngl_config.sort_draws.
+ */
+static int is_reorderable(const struct draw_packet *packet)
+{
+    const struct graphicstate *state = &packet->pipeline->graphics.state;
+    return !state->blend &&
+           !state->stencil_test &&
+           state->depth_test && state->depth_write_mask &&
+           (state->depth_func == NGLI_COMPARE_OP_LESS || state->depth_func == NGLI_COMPARE_OP_GREATER);
+}
+
+static int cmp_ptr(const void *p0, const void *p1)
+{
+    const uintptr_t a = (uintptr_t)p0;
+    const uintptr_t b = (uintptr_t)p1;
+    return (a > b) - (a < b);
+}
+
+static int cmp_program(const void *a, const void *b)
+{
+    const struct draw_packet *p0 = a;
+    const struct draw_packet *p1 = b;
+    const int ret = cmp_ptr(p0->pipeline->program, p1->pipeline->program);
+    return ret ? ret : p0->index - p1->index;
+}
+
+static int cmp_pipeline(const void *a, const void *b)
+{
+    const struct draw_packet *p0 = a;
+    const struct draw_packet *p1 = b;
+    const int ret = cmp_ptr(p0->pipeline, p1->pipeline);
+    return ret ? ret : p0->index - p1->index;
+}
+
+static int cmp_packet(const void *a, const void *b)
+{
+    const struct draw_packet *p0 = a;
+    const struct draw_packet *p1 = b;
+
+    int ret = p0->program_rank - p1->program_rank;
+    if (ret)
+        return ret;
+
+    ret = p0->pipeline_rank - p1->pipeline_rank;
+    if (ret)
+        return ret;
+
+    ret = memcmp(p0->viewport, p1->viewport, sizeof(p0->viewport));
+    if (ret)
+        return ret;
+
+    ret = memcmp(p0->scissor, p1->scissor, sizeof(p0->scissor));
+    if (ret)
+        return ret;
+
+    /* Keep the recording order for the packets sharing the same states */
+    return p0->index - p1->index;
+}
+
+/*
+ * Group the packets with the comparison function and assign to each of them
+ * the recording order of the first packet of its group. The pointers are only
+ * used to gather the groups, never to order them.
+ */
+static void rank_packets(struct draw_packet *packets, int nb_packets,
+                         int (*cmp)(const void *a, const void *b), int is_program)
+{
+    qsort(packets, nb_packets, sizeof(*packets), cmp);
+
+    int rank = 0;
+    for (int i = 0; i < nb_packets; i++) {
+        struct draw_packet *packet = &packets[i];
+        const struct pipeline *pipeline = packet->pipeline;
+        const int new_group = !i || (is_program ? pipeline->program != packets[i - 1].pipeline->program
+                                                : pipeline != packets[i - 1].pipeline);
+        if (new_group)
+            rank = packet->index; /* the packets of a group are sorted by index */
+        if (is_program)
+            packet->program_rank = rank;
+        else
+            packet->pipeline_rank = rank;
+    }
+}
+
+static int has_same_states(const struct draw_packet *p0, const struct draw_packet *p1)
+{
+    const struct graphicstate *state0 = &p0->pipeline->graphics.state;
+    const struct graphicstate *state1 = &p1->pipeline->graphics.state;
+    return !memcmp(state0, state1, sizeof(*state0)) &&
+           !memcmp(p0->viewport, p1->viewport, sizeof(p0->viewport)) &&
+           !memcmp(p0->scissor, p1->scissor, sizeof(p0->scissor));
+}
+
+static void count_changes(const struct draw_packet *packets, int nb_packets,
+                          int *nb_pipeline_binds, int *nb_state_changes)
+{
+    *nb_pipeline_binds = 0;
+    *nb_state_changes = 0;
+    for (int i = 0; i < nb_packets; i++) {
+        if (!i || packets[i].pipeline != packets[i - 1].pipeline)
+            (*nb_pipeline_binds)++;
+        if (!i || !has_same_states(&packets[i], &packets[i - 1]))
+            (*nb_state_changes)++;
+    }
+}
+
+static void sort_packets(struct draw_packet *packets, int nb_packets)
+{
+    int start = 0;
+    while (start < nb_packets) {
+        if (!is_reorderable(&packets[start])) {
+            start++;
+            continue;
+        }
+
+        int end = start + 1;
+        while (end < nb_packets && is_reorderable(&packets[end]))
+            end++;
+
+        const int nb_reorderable = end - start;
+        rank_packets(packets + start, nb_reorderable, cmp_program, 1);
+        rank_packets(packets + start, nb_reorderable, cmp_pipeline, 0);
+        qsort(packets + start, nb_reorderable, sizeof(*packets), cmp_packet);
+        start = end;
+    }
+}
+
+static void submit_packet(struct draw_list *s, const struct draw_packet *packet)
+{
+    struct pipeline *pipeline = packet->pipeline;
+
+    ngli_gpu_ctx_set_viewport(s->gpu_ctx, packet->viewport);
+    ngli_gpu_ctx_set_scissor(s->gpu_ctx, packet->scissor);
+
+    for (int i = 0; i < packet->nb_buffers; i++) {
+        const struct draw_packet_buffer *buffer = &packet->buffers[i];
+        int ret = ngli_pipeline_update_buffer(pipeline, buffer->index, buffer->buffer, buffer->offset, buffer->size);
+        if (ret < 0)
+            return;
+    }
+
+    if (packet->indices)
+        ngli_pipeline_draw_indexed(pipeline, packet->indices, packet->indices_format,
+                                   packet->nb_indices, packet->nb_instances);
+    else
+        ngli_pipeline_draw(pipeline, packet->nb_vertices, packet->nb_instances);
+}
+
+void ngli_draw_list_flush(struct draw_list *s)
+{
+    struct draw_packet *packets = ngli_darray_data(&s->packets);
+    const int nb_packets = ngli_darray_count(&s->packets);
+    if (!nb_packets)
+        return;
+
+    int nb_pipeline_binds, nb_state_changes;
+    count_changes(packets, nb_packets, &nb_pipeline_binds, &nb_state_changes);
+
+    sort_packets(packets, nb_packets);
+
+    int nb_sorted_pipeline_binds, nb_sorted_state_changes;
+    count_changes(packets, nb_packets, &nb_sorted_pipeline_binds, &nb_sorted_state_changes);
+
+    struct draw_list_stats *stats = &s->stats;
+    stats->nb_packets += nb_packets;
+    stats->nb_pipeline_binds += nb_sorted_pipeline_binds;
+    stats->nb_state_changes += nb_sorted_state_changes;
+    stats->nb_pipeline_binds_saved += nb_pipeline_binds - nb_sorted_pipeline_binds;
+    stats->nb_state_changes_saved += nb_state_changes - nb_sorted_state_changes;
+
+    int viewport[4], scissor[4];
+    ngli_gpu_ctx_get_viewport(s->gpu_ctx, viewport);
+    ngli_gpu_ctx_get_scissor(s->gpu_ctx, scissor);
+
+    for (int i = 0; i < nb_packets; i++)
+        submit_packet(s, &packets[i]);
+
+    ngli_gpu_ctx_set_viewport(s->gpu_ctx, viewport);
+    ngli_gpu_ctx_set_scissor(s->gpu_ctx, scissor);
+
+    ngli_darray_clear(&s->packets);
+    s->flush_count++;
+}
+
+int64_t ngli_draw_list_get_flush_count(const struct draw_list *s)
+{
+    return s->flush_count;
+}
+
+void ngli_draw_list_reset_stats(struct draw_list *s)
+{
+    memset(&s->stats, 0, sizeof(s->stats));
+}
+
+const struct draw_list_stats *ngli_draw_list_get_stats(const struct draw_list *s)
+{
+    return &s->stats;
+}
+
+void ngli_draw_list_freep(struct draw_list **sp)
+{
+    struct draw_list *s = *sp;
+    if (!s)
+        return;
+    ngli_darray_reset(&s->packets);
+    ngli_freep(sp);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <stdint.h>
+
+#include "buffer.h"
+#include "gpu_ctx.h"
+#include "pipeline.h"
+#include "program.h"
+
+/*
+ * Deferred list of the draws of a render pass.
+ *
+ * Instead of being submitted right away, the draws are recorded as packets
+ * holding everything they depend on (pipeline, uniform data location in the
+ * uniform ring, viewport and scissor) and submitted when the render pass
+ * ends. Before the submission, the packets are sorted so the ones sharing
+ * the same program, pipeline and dynamic states are consecutive.
+ *
+ * Only the draws whose result does not depend on their order are moved: no
+ * blending, no stencil, and a strict depth test writing the depth. Any other
+ * draw acts as a barrier that the packets are never moved across. The order
+ * of the groups follows the first draw of each group, so the submission
+ * order does not depend on where the programs and pipelines are allocated.
+ *
+ * The packets only capture the uniform buffers: changing any other binding
+ * of a pipeline having packets pending requires flushing the list first
+ * (see ngli_draw_list_get_flush_count()).
+ */
+struct draw_list;
+
+struct draw_packet_buffer {
+    int index;
+    const struct buffer *buffer;
+    int offset;
+    int size;
+};
+
+struct draw_packet {
+    struct pipeline *pipeline;
+    int nb_vertices;
+    const struct buffer *indices;
+    int indices_format;
+    int nb_indices;
+    int nb_instances;
+    int viewport[4];
+    int scissor[4];
+    struct draw_packet_buffer buffers[NGLI_PROGRAM_SHADER_NB];
+    int nb_buffers;
+    int index; /* recording order */
+    int program_rank;  /* recording order of the first packet using the same program */
+    int pipeline_rank; /* recording order of the first packet using the same pipeline */
+};
+
+/* Statistics accumulated since the last ngli_draw_list_reset_stats() call */
+struct draw_list_stats {
+    int nb_packets;
+    int nb_pipeline_binds;
+    int nb_state_changes;
+    int nb_pipeline_binds_saved;
+    int nb_state_changes_saved;
+};
+
+struct draw_list *ngli_draw_list_create(struct gpu_ctx *gpu_ctx);
+int ngli_draw_list_add(struct draw_list *s, const struct draw_packet *packet);
+void ngli_draw_list_flush(struct draw_list *s);
+int64_t ngli_draw_list_get_flush_count(const struct draw_list *s);
+void ngli_draw_list_reset_stats(struct draw_list *s);
+const struct draw_list_stats *ngli_draw_list_get_stats(const struct draw_list *s);
+void ngli_draw_list_freep(struct draw_list **sp);
+
+#endif
@@ -43,7 +43,11 @@ struct rect {
 
 void ngli_drawutils_draw_rect(struct canvas *canvas, const struct rect *rect, uint32_t color);
 void ngli_drawutils_print(struct canvas *canvas, int x, int y, const char *str, uint32_t color);
-int ngli_drawutils_get_font_atlas(struct canvas *c_dst);
-void ngli_drawutils_get_atlas_uvcoords(uint8_t chr, float *dst);
+
+/*
+ * Return the NGLI_FONT_H rows of the bitmap of a character, where the bit x of
+ * each row is set if the pixel x is lit
+ */
+const uint8_t *ngli_drawutils_get_glyph(uint8_t chr);
 
 #endif
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "drawutils.h"
+#include "font_atlas.h"
+#include "format.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+#define FONT_OFFSET 32
+#define NB_GLYPHS (128 - FONT_OFFSET)
+
+#define ATLAS_COLS 16
+#define ATLAS_ROWS  6
+
+/* Number of texels per font pixel */
+#define GLYPH_SCALE 4
+
+/* Distance (in font pixels) encoded on each side of the glyph edges */
+#define GLYPH_SPREAD 1
+
+/* Padding around the glyphs so their distance fields do not overlap */
+#define GLYPH_PAD (GLYPH_SPREAD * GLYPH_SCALE)
+
+#define GLYPH_W (NGLI_FONT_W * GLYPH_SCALE + 2 * GLYPH_PAD)
+#define GLYPH_H (NGLI_FONT_H * GLYPH_SCALE + 2 * GLYPH_PAD)
+#define ATLAS_W (ATLAS_COLS * GLYPH_W)
+#define ATLAS_H (ATLAS_ROWS * GLYPH_H)
+
+struct font_atlas {
+    struct gpu_ctx *gpu_ctx;
+    struct texture *texture;
+    uint8_t *buf;
+    uint8_t rasterized[NB_GLYPHS];
+    int dirty;
+};
+
+struct font_atlas *ngli_font_atlas_create(struct gpu_ctx *gpu_ctx)
+{
+    struct font_atlas *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+    return s;
+}
+
+int ngli_font_atlas_init(struct font_atlas *s)
+{
+    s->buf = ngli_calloc(ATLAS_W * ATLAS_H, 1);
+    if (!s->buf)
+        return NGL_ERROR_MEMORY;
+
+    const struct texture_params tex_params = {
+        .type          = NGLI_TEXTURE_TYPE_2D,
+        .width         = ATLAS_W,
+        .height        = ATLAS_H,
+        .format        = NGLI_FORMAT_R8_UNORM,
+        .min_filter    = NGLI_FILTER_LINEAR,
+        .mag_filter    = NGLI_FILTER_LINEAR,
+        .mipmap_filter = NGLI_MIPMAP_FILTER_LINEAR,
+        .usage         = NGLI_TEXTURE_USAGE_TRANSFER_SRC_BIT
+                       | NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT
+                       | NGLI_TEXTURE_USAGE_SAMPLED_BIT,
+    };
+
+    s->texture = ngli_texture_create(s->gpu_ctx);
+    if (!s->texture)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_texture_init(s->texture, &tex_params);
+    if (ret < 0)
+        return ret;
+
+    /* The texture content is defined even if no glyph is ever requested */
+    s->dirty = 1;
+    return 0;
+}
+
+static int is_lit(const uint8_t *glyph, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= NGLI_FONT_W || y >= NGLI_FONT_H)
+        return 0;
+    return glyph[y] >> x & 1;
+}
+
+/* Distance from a point to the font pixel (x,y), all in font pixel units */
+static float get_pixel_distance(float px, float py, int x, int y)
+{
+    const float dx = NGLI_MAX(NGLI_MAX(x - px, px - (x + 1)), 0.f);
+    const float dy = NGLI_MAX(NGLI_MAX(y - py, py - (y + 1)), 0.f);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+/*
+ * The distance of a point to the glyph edges is the distance to the closest
+ * pixel of the other kind (unlit if the point is inside the glyph, lit
+ * otherwise). The glyphs being tiny, all the pixels are simply checked.
+ */
+static float get_signed_distance(const uint8_t *glyph, float px, float py)
+{
+    const int inside = is_lit(glyph, (int)floorf(px), (int)floorf(py));
+
+    /* The surroundings of the bitmap are unlit */
+    float dist = inside ? NGLI_MIN(NGLI_MIN(px, NGLI_FONT_W - px), NGLI_MIN(py, NGLI_FONT_H - py))
+                        : GLYPH_SPREAD;
+
+    for (int y = 0; y < NGLI_FONT_H; y++)
+        for (int x = 0; x < NGLI_FONT_W; x++)
+            if (is_lit(glyph, x, y) != inside)
+                dist = NGLI_MIN(dist, get_pixel_distance(px, py, x, y));
+
+    return inside ? dist : -dist;
+}
+
+static void rasterize_glyph(struct font_atlas *s, int glyph_id)
+{
+    const uint8_t *glyph = ngli_drawutils_get_glyph(glyph_id + FONT_OFFSET);
+    const int col = glyph_id % ATLAS_COLS;
+    const int row = glyph_id / ATLAS_COLS;
+    uint8_t *dst = s->buf + row * GLYPH_H * ATLAS_W + col * GLYPH_W;
+
+    for (int y = 0; y < GLYPH_H; y++) {
+        for (int x = 0; x < GLYPH_W; x++) {
+            const float px = (x - GLYPH_PAD + .5f) / GLYPH_SCALE;
+            const float py = (y - GLYPH_PAD + .5f) / GLYPH_SCALE;
+            const float d = get_signed_distance(glyph, px, py);
+
+            /* The edges are at 0.5, [-spread,spread] being mapped to [0,1] */
+            const float v = NGLI_CLAMP(.5f + d / (2.f * GLYPH_SPREAD), 0.f, 1.f);
+            dst[y * ATLAS_W + x] = (uint8_t)lrintf(v * 255.f);
+        }
+    }
+}
+
+void ngli_font_atlas_get_glyph(struct font_atlas *s, uint8_t chr, float *uvrect)
+{
+    const int glyph_id = chr < FONT_OFFSET || chr > 127 ? 0 : chr - FONT_OFFSET;
+    if (!s->rasterized[glyph_id]) {
+        rasterize_glyph(s, glyph_id);
+        s->rasterized[glyph_id] = 1;
+        s->dirty = 1;
+    }
+
+    /* The texture rows are stored from the top of the glyphs */
+    const int col = glyph_id % ATLAS_COLS;
+    const int row = glyph_id / ATLAS_COLS;
+    const float u0 = (col * GLYPH_W + GLYPH_PAD) / (float)ATLAS_W;
+    const float v0 = (row * GLYPH_H + GLYPH_PAD) / (float)ATLAS_H;
+    const float u1 = u0 + NGLI_FONT_W * GLYPH_SCALE / (float)ATLAS_W;
+    const float v1 = v0 + NGLI_FONT_H * GLYPH_SCALE / (float)ATLAS_H;
+    const float glyph_uvrect[] = {u0, v1, u1, v0};
+    memcpy(uvrect, glyph_uvrect, sizeof(glyph_uvrect));
+}
+
+int ngli_font_atlas_upload(struct font_atlas *s)
+{
+    if (!s->dirty)
+        return 0;
+
+    /* The atlas is small enough to be uploaded entirely */
+    int ret = ngli_texture_upload(s->texture, s->buf, 0);
+    if (ret < 0)
+        return ret;
+
+    s->dirty = 0;
+    return 0;
+}
+
+struct texture *ngli_font_atlas_get_texture(const struct font_atlas *s)
+{
+    return s->texture;
+}
+
+void ngli_font_atlas_freep(struct font_atlas **sp)
+{
+    struct font_atlas *s = *sp;
+    if (!s)
+        return;
+    ngli_texture_freep(&s->texture);
+    ngli_free(s->buf);
+    ngli_freep(sp);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef FONT_ATLAS_H
+#define FONT_ATLAS_H
+
+#include <stdint.h>
+
+#include "gpu_ctx.h"
+#include "texture.h"
+
+/*
+ * Signed distance field atlas of the characters of the builtin font, shared
+ * by all the Text nodes of a context.
+ *
+ * Each glyph is stored as the distance to the edges of its bitmap, sampled at
+ * a higher resolution than the font itself, so that the shading can
+ * reconstruct sharp edges at any scale. The glyphs are rasterized on demand,
+ * the first time they are requested, and uploaded with
+ * ngli_font_atlas_upload().
+ */
+struct font_atlas;
+
+struct font_atlas *ngli_font_atlas_create(struct gpu_ctx *gpu_ctx);
+int ngli_font_atlas_init(struct font_atlas *s);
+
+/*
+ * Get the texture coordinates rectangle of the glyph of a character, as the
+ * coordinates of its bottom-left corner followed by its top-right corner.
+ */
+void ngli_font_atlas_get_glyph(struct font_atlas *s, uint8_t chr, float *uvrect);
+
+/* Upload the glyphs rasterized since the last upload, if any */
+int ngli_font_atlas_upload(struct font_atlas *s);
+
+struct texture *ngli_font_atlas_get_texture(const struct font_atlas *s);
+void ngli_font_atlas_freep(struct font_atlas **sp);
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+
+#include "darray.h"
+#include "format.h"
+#include "frame_cache.h"
+#include "gpu_ctx.h"
+#include "hwconv.h"
+#include "internal.h"
+#include "log.h"
+#include "memory.h"
+#include "texture.h"
+#include "utils.h"
+
+/* Maximum interval between two linked frames, in estimated frame durations */
+#define MAX_FRAME_GAP 1.5
+
+struct cache_entry {
+    double ts;
+    double end_ts;  /* timestamp of the next decoded frame */
+    int has_end_ts;
+    int64_t last_use;
+    struct texture *texture;
+    struct image image;
+    struct hwconv hwconv;
+};
+
+struct frame_cache {
+    struct ngl_ctx *ctx;
+    struct hwmap_params params;
+    int64_t max_size;
+    int64_t entry_size;
+    struct image_params src_params;
+    struct darray entries; /* struct cache_entry */
+    int64_t clock;
+    double last_ts; /* timestamp of the last added frame */
+    int has_last_ts;
+    double frame_duration; /* smallest interval between two added frames */
+    int64_t nb_intervals;
+};
+
+struct frame_cache *ngli_frame_cache_create(struct ngl_ctx *ctx)
+{
+    struct frame_cache *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->ctx = ctx;
+    return s;
+}
+
+int ngli_frame_cache_init(struct frame_cache *s, const struct hwmap_params *params, int64_t max_size)
+{
+    s->params = *params;
+    s->max_size = max_size;
+    ngli_darray_init(&s->entries, sizeof(struct cache_entry), 1);
+    return 0;
+}
+
+static void reset_entry(struct cache_entry *entry)
+{
+    ngli_hwconv_reset(&entry->hwconv);
+    ngli_image_reset(&entry->image);
+    ngli_texture_freep(&entry->texture);
+}
+
+static void clear_entries(struct frame_cache *s)
+{
+    struct cache_entry *entries = ngli_darray_data(&s->entries);
+    for (int i = 0; i < ngli_darray_count(&s->entries); i++)
+        reset_entry(&entries[i]);
+    ngli_darray_clear(&s->entries);
+    s->has_last_ts = 0;
+    s->nb_intervals = 0;
+}
+
+static int init_entry(struct frame_cache *s, struct cache_entry *entry, const struct image *image)
+{
+    struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+    const struct hwmap_params *params = &s->params;
+
+    const struct texture_params texture_params = {
+        .type          = NGLI_TEXTURE_TYPE_2D,
+        .format        = NGLI_FORMAT_R8G8B8A8_UNORM,
+        .width         = image->params.width,
+        .height        = image->params.height,
+        .min_filter    = params->texture_min_filter,
+        .mag_filter    = params->texture_mag_filter,
+        .mipmap_filter = params->texture_mipmap_filter,
+        .wrap_s        = params->texture_wrap_s,
+        .wrap_t        = params->texture_wrap_t,
+        .usage         = params->texture_usage | ngli_hwconv_get_dst_usage(s->ctx, &image->params),
+    };
+
+    entry->texture = ngli_texture_create(gpu_ctx);
+    if (!entry->texture)
+        return NGL_ERROR_MEMORY;
+    int ret = ngli_texture_init(entry->texture, &texture_params);
+    if (ret < 0)
+        return ret;
+
+    const struct image_params image_params = {
+        .width = image->params.width,
+        .height = image->params.height,
+        .layout = NGLI_IMAGE_LAYOUT_DEFAULT,
+        .color_scale = 1.f,
+        .color_info = {
+            .space     = SXPLAYER_COL_SPC_BT709,
+            .range     = SXPLAYER_COL_RNG_UNSPECIFIED,
+            .primaries = SXPLAYER_COL_PRI_BT709,
+            .transfer  = SXPLAYER_COL_TRC_IEC61966_2_1, // sRGB
+        },
+    };
+    ngli_image_init(&entry->image, &image_params, &entry->texture);
+
+    return ngli_hwconv_init(&entry->hwconv, s->ctx, &entry->image, &image->params);
+}
+
+static int is_same_source(const struct image_params *a, const struct image_params *b)
+{
+    return a->width == b->width &&
+           a->height == b->height &&
+           a->layout == b->layout &&
+           a->color_scale == b->color_scale &&
+           !memcmp(&a->color_info, &b->color_info, sizeof(a->color_info));
+}
+
+static int entry_contains(const struct frame_cache *s, const struct cache_entry *entry, double t)
+{
+    if (t == entry->ts)
+        return 1;
+    if (t < entry->ts || !entry->has_end_ts || t >= entry->end_ts)
+        return 0;
+
+    /*
+     * The frame is only extended up to the next one if they are consecutive.
+     * A single interval is not enough to estimate the frame duration since
+     * it could be a gap itself.
+     */
+    return s->nb_intervals > 1 && entry->end_ts - entry->ts <= s->frame_duration * MAX_FRAME_GAP;
+}
+
+const struct image *ngli_frame_cache_get(struct frame_cache *s, double t)
+{
+    struct cache_entry *entries = ngli_darray_data(&s->entries);
+    for (int i = 0; i < ngli_darray_count(&s->entries); i++) {
+        struct cache_entry *entry = &entries[i];
+        if (!entry_contains(s, entry, t))
+            continue;
+        entry->last_use = ++s->clock;
+        return &entry->image;
+    }
+    return NULL;
+}
+
+int ngli_frame_cache_add(struct frame_cache *s, double ts, const struct image *image)
+{
+    /* The cached frames must all be converted the same way */
+    if (!is_same_source(&s->src_params, &image->params)) {
+        clear_entries(s);
+        s->src_params = image->params;
+        s->entry_size = (int64_t)image->params.width * image->params.height
+                      * ngli_format_get_bytes_per_pixel(NGLI_FORMAT_R8G8B8A8_UNORM);
+    }
+
+    if (s->entry_size > s->max_size)
+        return 0;
+
+    if (s->has_last_ts && ts > s->last_ts) {
+        const double interval = ts - s->last_ts;
+        if (!s->nb_intervals || interval < s->frame_duration)
+            s->frame_duration = interval;
+        s->nb_intervals++;
+    }
+
+    /*
+     * Link the previously decoded frame to this one and look for a copy. A
+     * frame decoded again (after a seek) keeps its closest known successor.
+     */
+    struct cache_entry *entries = ngli_darray_data(&s->entries);
+    const int nb_entries = ngli_darray_count(&s->entries);
+    int index = -1;
+    for (int i = 0; i < nb_entries; i++) {
+        struct cache_entry *entry = &entries[i];
+        if (s->has_last_ts && entry->ts == s->last_ts && ts > entry->ts &&
+            (!entry->has_end_ts || ts < entry->end_ts)) {
+            entry->end_ts = ts;
+            entry->has_end_ts = 1;
+        }
+        if (entry->ts == ts)
+            index = i;
+    }
+    s->last_ts = ts;
+    s->has_last_ts = 1;
+
+    if (index >= 0) {
+        entries[index].last_use = ++s->clock;
+        return 0;
+    }
+
+    if ((nb_entries + 1) * s->entry_size > s->max_size) {
+        /* Recycle the least recently used frame */
+        index = 0;
+        for (int i = 1; i < nb_entries; i++)
+            if (entries[i].last_use < entries[index].last_use)
+                index = i;
+    } else {
+        const struct cache_entry new_entry = {0};
+        struct cache_entry *entry = ngli_darray_push(&s->entries, &new_entry);
+        if (!entry)
+            return NGL_ERROR_MEMORY;
+        index = nb_entries;
+        int ret = init_entry(s, entry, image);
+        if (ret < 0) {
+            reset_entry(entry);
+            ngli_darray_pop(&s->entries);
+            return ret;
+        }
+    }
+
+    struct cache_entry *entry = ngli_darray_get(&s->entries, index);
+    entry->ts = ts;
+    entry->has_end_ts = 0;
+    entry->last_use = ++s->clock;
+    entry->image.ts = ts;
+
+    int ret = ngli_hwconv_convert_image(&entry->hwconv, image);
+    if (ret < 0) {
+        reset_entry(entry);
+        ngli_darray_remove(&s->entries, index);
+        return ret;
+    }
+
+    struct texture *texture = entry->texture;
+    if (texture->params.mipmap_filter != NGLI_MIPMAP_FILTER_NONE)
+        ngli_texture_generate_mipmap(texture);
+
+    return 0;
+}
+
+void ngli_frame_cache_freep(struct frame_cache **sp)
+{
+    struct frame_cache *s = *sp;
+    if (!s)
+        return;
+    clear_entries(s);
+    ngli_darray_reset(&s->entries);
+    ngli_freep(sp);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stdint.h>
+
+#include "hwmap.h"
+#include "image.h"
+
+struct ngl_ctx;
+
+/*
+ * Least recently used cache of the media frames, bounded by a memory budget
+ * in bytes.
+ *
+ * The mapped frames are converted into RGBA textures so the cached copies
+ * outlive the decoder buffers they come from, whatever the mapping method.
+ * A cached frame is displayed from its timestamp up to the timestamp of the
+ * frame that followed it in the decoding order, as long as both frames are
+ * consecutive: the frame duration is estimated from the smallest interval
+ * between two decoded frames, and a larger gap (seek, dropped frames) only
+ * matches the exact timestamp of the frame, leaving the times in between to
+ * the decoder. The interval of the most recent frame is not known yet so it
+ * only matches its exact timestamp as well.
+ *
+ * When the budget is reached, the least recently used frame is evicted and
+ * its resources are recycled for the incoming frame.
+ */
+struct frame_cache;
+
+struct frame_cache *ngli_frame_cache_create(struct ngl_ctx *ctx);
+int ngli_frame_cache_init(struct frame_cache *s, const struct hwmap_params *params, int64_t max_size);
+
+/* Return the cached image to display at time t, or NULL if there is none */
+const struct image *ngli_frame_cache_get(struct frame_cache *s, double t);
+
+/* Store a copy of the image mapped from the frame with timestamp ts */
+int ngli_frame_cache_add(struct frame_cache *s, double ts, const struct image *image);
+void ngli_frame_cache_freep(struct frame_cache **sp);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "glsl_scan.h"
+
+#define WHITESPACES     "\r\n\t "
+#define TOKEN_ID_CHARS  "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_"
+
+int ngli_glsl_scan_is_texvideo_only(const char *src, const char *name)
+{
+    if (!src)
+        return 1;
+
+    static const char texvideo[] = "ngl_texvideo";
+    const size_t texvideo_len = strlen(texvideo);
+    const size_t name_len = strlen(name);
+
+    const char *p = src;
+    while ((p = strstr(p, name))) {
+        const char *start = p;
+        p += name_len;
+
+        /* Only consider the identifier itself, not the ones it prefixes */
+        if ((start > src && strchr(TOKEN_ID_CHARS, start[-1])) || (*p && strchr(TOKEN_ID_CHARS, *p)))
+            continue;
+
+        /* Walk back to the function call this identifier is the first argument of */
+        const char *q = start;
+        while (q > src && strchr(WHITESPACES, q[-1]))
+            q--;
+        if (q == src || q[-1] != '(')
+            return 0;
+        q--;
+        while (q > src && strchr(WHITESPACES, q[-1]))
+            q--;
+        if ((size_t)(q - src) < texvideo_len || strncmp(q - texvideo_len, texvideo, texvideo_len))
+            return 0;
+        q -= texvideo_len;
+        if (q > src && strchr(TOKEN_ID_CHARS, q[-1]))
+            return 0;
+    }
+
+    return 1;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef GLSL_SCAN_H
+#define GLSL_SCAN_H
+
+/*
+ * Return whether every reference to the texture name in the shader source is
+ * a ngl_texvideo() call, in which case the multi-plane image layouts can be
+ * sampled directly. Any other access (or a reference in a comment) requires
+ * the frames to be converted to the default layout.
+ */
+int ngli_glsl_scan_is_texvideo_only(const char *src, const char *name);
+
+#endif
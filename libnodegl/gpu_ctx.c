@@ -21,6 +21,7 @@
 
 #include <string.h>
 
+#include "draw_list.h"
 #include "gpu_ctx.h"
 #include "log.h"
 #include "memory.h"
@@ -82,12 +83,36 @@ struct gpu_ctx *ngli_gpu_ctx_create(const struct ngl_config *config)
     s->config = ctx_config;
     s->backend_str = backend_map[config->backend].string_id;
     s->cls = cls;
+    s->shared_ctx = config->shared_ctx ? config->shared_ctx->gpu_ctx : NULL;
+
+    ret = ngli_diskcache_init(&s->program_cache, s->config.program_cache_dir);
+    if (ret < 0) {
+        ngli_gpu_ctx_freep(&s);
+        return NULL;
+    }
+
     return s;
 }
 
 int ngli_gpu_ctx_init(struct gpu_ctx *s)
 {
-    return s->cls->init(s);
+    int ret = s->cls->init(s);
+    if (ret < 0)
+        return ret;
+
+    if (s->config.sort_draws) {
+        /* The draws can only be deferred if their uniforms are in the uniform ring */
+        if (!s->uniform_ring) {
+            LOG(WARNING, "draws sorting is not supported by the %s backend", s->backend_str);
+            return 0;
+        }
+
+        s->draw_list = ngli_draw_list_create(s);
+        if (!s->draw_list)
+            return NGL_ERROR_MEMORY;
+    }
+
+    return 0;
 }
 
 int ngli_gpu_ctx_resize(struct gpu_ctx *s, int width, int height, const int *viewport)
@@ -102,6 +127,11 @@ int ngli_gpu_ctx_set_capture_buffer(struct gpu_ctx *s, void *capture_buffer)
     return cls->set_capture_buffer(s, capture_buffer);
 }
 
+int ngli_gpu_ctx_flush_capture(struct gpu_ctx *s)
+{
+    return s->cls->flush_capture(s);
+}
+
 int ngli_gpu_ctx_begin_update(struct gpu_ctx *s, double t)
 {
     return s->cls->begin_update(s, t);
@@ -114,6 +144,8 @@ int ngli_gpu_ctx_end_update(struct gpu_ctx *s, double t)
 
 int ngli_gpu_ctx_begin_draw(struct gpu_ctx *s, double t)
 {
+    if (s->draw_list)
+        ngli_draw_list_reset_stats(s->draw_list);
     return s->cls->begin_draw(s, t);
 }
 
@@ -127,6 +159,15 @@ int ngli_gpu_ctx_query_draw_time(struct gpu_ctx *s, int64_t *time)
     return s->cls->query_draw_time(s, time);
 }
 
+void ngli_gpu_ctx_get_memory_stats(struct gpu_ctx *s, struct gpu_memory_stats *stats)
+{
+    if (!s->cls->get_memory_stats) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    s->cls->get_memory_stats(s, stats);
+}
+
 void ngli_gpu_ctx_wait_idle(struct gpu_ctx *s)
 {
     s->cls->wait_idle(s);
@@ -138,10 +179,13 @@ void ngli_gpu_ctx_freep(struct gpu_ctx **sp)
         return;
 
     struct gpu_ctx *s = *sp;
+    ngli_draw_list_freep(&s->draw_list);
+
     const struct gpu_ctx_class *cls = s->cls;
     if (cls)
         cls->destroy(s);
 
+    ngli_diskcache_reset(&s->program_cache);
     ngli_config_reset(&s->config);
     ngli_freep(sp);
 }
@@ -163,6 +207,8 @@ void ngli_gpu_ctx_begin_render_pass(struct gpu_ctx *s, struct rendertarget *rt)
 
 void ngli_gpu_ctx_end_render_pass(struct gpu_ctx *s)
 {
+    if (s->draw_list)
+        ngli_draw_list_flush(s->draw_list);
     s->cls->end_render_pass(s);
 }
 
@@ -25,6 +25,7 @@
 #include <stdint.h>
 
 #include "buffer.h"
+#include "diskcache.h"
 #include "gpu_limits.h"
 #include "nodegl.h"
 #include "pipeline.h"
@@ -47,6 +48,21 @@
 #define NGLI_FEATURE_TEXTURE_HALF_FLOAT_RENDERABLE     (1 << 13)
 #define NGLI_FEATURE_BUFFER_MAP                        (1 << 14)
 
+/*
+ * Device memory statistics, only filled by the backends managing the device
+ * memory themselves
+ */
+struct gpu_memory_stats {
+    int64_t nb_blocks;        /* number of device memory objects */
+    int64_t nb_allocations;   /* number of resources sub-allocated from the blocks */
+    uint64_t reserved_size;   /* total size of the blocks */
+    uint64_t used_size;       /* size used by the resources */
+    uint64_t fragmented_size; /* free size not part of the largest free range of each block */
+};
+
+struct uniform_ring;
+struct draw_list;
+
 struct gpu_ctx_class {
     const char *name;
 
@@ -54,11 +70,13 @@ struct gpu_ctx_class {
     int (*init)(struct gpu_ctx *s);
     int (*resize)(struct gpu_ctx *s, int width, int height, const int *viewport);
     int (*set_capture_buffer)(struct gpu_ctx *s, void *capture_buffer);
+    int (*flush_capture)(struct gpu_ctx *s);
     int (*begin_update)(struct gpu_ctx *s, double t);
     int (*end_update)(struct gpu_ctx *s, double t);
     int (*begin_draw)(struct gpu_ctx *s, double t);
     int (*end_draw)(struct gpu_ctx *s, double t);
     int (*query_draw_time)(struct gpu_ctx *s, int64_t *time);
+    void (*get_memory_stats)(struct gpu_ctx *s, struct gpu_memory_stats *stats);
     void (*wait_idle)(struct gpu_ctx *s);
     void (*destroy)(struct gpu_ctx *s);
 
@@ -109,6 +127,8 @@ struct gpu_ctx_class {
     struct texture *(*texture_create)(struct gpu_ctx *ctx);
     int (*texture_init)(struct texture *s, const struct texture_params *params);
     int (*texture_upload)(struct texture *s, const uint8_t *data, int linesize);
+    int (*texture_upload_borrowed)(struct texture *s, const uint8_t *data, int linesize,
+                                   void (*release)(void *arg), void *arg); /* optional */
     int (*texture_generate_mipmap)(struct texture *s);
     void (*texture_freep)(struct texture **sp);
 };
@@ -121,6 +141,13 @@ struct gpu_ctx {
     int language_version;
     uint64_t features;
     struct gpu_limits limits;
+    struct diskcache program_cache;
+    /* GPU context sharing its device with this one, NULL if not shared */
+    struct gpu_ctx *shared_ctx;
+    /* Uniform data ring used by the pipelines, for the backends requiring uniform blocks */
+    struct uniform_ring *uniform_ring;
+    /* Deferred draws of the current render pass, NULL if the draws are not sorted */
+    struct draw_list *draw_list;
 #if DEBUG_GPU_CAPTURE
     struct gpu_capture_ctx *gpu_capture_ctx;
     int gpu_capture;
@@ -131,10 +158,12 @@ struct gpu_ctx *ngli_gpu_ctx_create(const struct ngl_config *config);
 int ngli_gpu_ctx_init(struct gpu_ctx *s);
 int ngli_gpu_ctx_resize(struct gpu_ctx *s, int width, int height, const int *viewport);
 int ngli_gpu_ctx_set_capture_buffer(struct gpu_ctx *s, void *capture_buffer);
+int ngli_gpu_ctx_flush_capture(struct gpu_ctx *s);
 int ngli_gpu_ctx_begin_update(struct gpu_ctx *s, double t);
 int ngli_gpu_ctx_end_update(struct gpu_ctx *s, double t);
 int ngli_gpu_ctx_begin_draw(struct gpu_ctx *s, double t);
 int ngli_gpu_ctx_query_draw_time(struct gpu_ctx *s, int64_t *time);
+void ngli_gpu_ctx_get_memory_stats(struct gpu_ctx *s, struct gpu_memory_stats *stats);
 int ngli_gpu_ctx_end_draw(struct gpu_ctx *s, double t);
 void ngli_gpu_ctx_wait_idle(struct gpu_ctx *s);
 void ngli_gpu_ctx_freep(struct gpu_ctx **sp);
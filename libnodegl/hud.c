@@ -26,8 +26,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "draw_list.h"
 #include "gpu_ctx.h"
 #include "hmap.h"
+#include "media_scheduler.h"
 #include "memory.h"
 #include "nodegl.h"
 #include "internal.h"
@@ -80,6 +82,7 @@ enum {
     LATENCY_DRAW_CPU,
     LATENCY_TOTAL_CPU,
     LATENCY_DRAW_GPU,
+    LATENCY_UPDATE_SEQ,
     NB_LATENCY
 };
 
@@ -89,6 +92,9 @@ enum {
     MEMORY_BLOCKS_CPU,
     MEMORY_BLOCKS_GPU,
     MEMORY_TEXTURES,
+    MEMORY_HEAP_TOTAL,
+    MEMORY_HEAP_USED,
+    MEMORY_HEAP_FRAG,
     NB_MEMORY
 };
 
@@ -105,6 +111,13 @@ enum {
     DRAWCALL_GRAPHICCONFIGS,
     DRAWCALL_RENDERS,
     DRAWCALL_RTTS,
+    DRAWCALL_BINDS_SAVED,
+    DRAWCALL_STATES_SAVED,
+    DRAWCALL_PROGRAM_HITS,
+    DRAWCALL_PROGRAM_MISSES,
+    DRAWCALL_MEDIA_MISSES,
+    DRAWCALL_MEDIA_DECODERS,
+    DRAWCALL_MEDIA_PENDING,
     NB_DRAWCALL
 };
 
@@ -152,6 +165,7 @@ static const struct {
     [LATENCY_DRAW_CPU]   = {"draw   CPU", 0x3DF4F4FF, 'u'},
     [LATENCY_TOTAL_CPU]  = {"total  CPU", 0xF4F43DFF, 'u'},
     [LATENCY_DRAW_GPU]   = {"draw   GPU", 0x3DF43DFF, 'n'},
+    [LATENCY_UPDATE_SEQ] = {"update seq", 0xF4983DFF, 'u'},
 };
 
 static const struct {
@@ -184,6 +198,22 @@ static const struct {
         .node_types=(const int[]){NGL_NODE_TEXTURE2D, NGL_NODE_TEXTURE3D, -1},
         .color=0xFF3232FF,
     },
+    /* Device memory managed by the backend allocator (Vulkan only) */
+    [MEMORY_HEAP_TOTAL] = {
+        .label="Heap total",
+        .node_types=(const int[]){-1},
+        .color=0xFF9632FF,
+    },
+    [MEMORY_HEAP_USED] = {
+        .label="Heap used",
+        .node_types=(const int[]){-1},
+        .color=0x32FFFFFF,
+    },
+    [MEMORY_HEAP_FRAG] = {
+        .label="Heap frag",
+        .node_types=(const int[]){-1},
+        .color=0xFF32D6FF,
+    },
 };
 
 static const struct activity_spec {
@@ -235,6 +265,38 @@ static const struct drawcall_spec {
         .label="RTTs",
         .node_types=(const int[]){NGL_NODE_RENDERTOTEXTURE, -1},
     },
+    /* Pipeline binds and state changes saved by the draws sorting (see sort_draws) */
+    [DRAWCALL_BINDS_SAVED] = {
+        .label="Binds saved",
+        .node_types=(const int[]){-1},
+    },
+    [DRAWCALL_STATES_SAVED] = {
+        .label="States saved",
+        .node_types=(const int[]){-1},
+    },
+    /* Lookups in the on-disk program cache (see program_cache_dir) */
+    [DRAWCALL_PROGRAM_HITS] = {
+        .label="Prog. hits",
+        .node_types=(const int[]){-1},
+    },
+    [DRAWCALL_PROGRAM_MISSES] = {
+        .label="Prog. misses",
+        .node_types=(const int[]){-1},
+    },
+    /* Media frame requests which had to wait for the decoder (see media_scheduler) */
+    [DRAWCALL_MEDIA_MISSES] = {
+        .label="Media misses",
+        .node_types=(const int[]){-1},
+    },
+    /* Media decoders running, and waiting for a startup or decoder slot (see media_scheduler) */
+    [DRAWCALL_MEDIA_DECODERS] = {
+        .label="Media decoders",
+        .node_types=(const int[]){-1},
+    },
+    [DRAWCALL_MEDIA_PENDING] = {
+        .label="Media pending",
+        .node_types=(const int[]){-1},
+    },
 };
 
 NGLI_STATIC_ASSERT(hud_nb_latency,  NGLI_ARRAY_NB(latency_specs)  == NB_LATENCY);
@@ -438,6 +500,12 @@ static void widget_latency_make_stats(struct hud *s, struct widget *widget)
     register_time(s, &priv->measures[LATENCY_DRAW_CPU],   ctx->cpu_draw_time);
     register_time(s, &priv->measures[LATENCY_TOTAL_CPU],  ctx->cpu_update_time + ctx->cpu_draw_time);
     register_time(s, &priv->measures[LATENCY_DRAW_GPU],   ctx->gpu_draw_time);
+
+    /*
+     * Estimated single-threaded update time, the ratio with the CPU update
+     * time is the speedup of the parallel update (see nb_update_threads)
+     */
+    register_time(s, &priv->measures[LATENCY_UPDATE_SEQ], ctx->cpu_update_seq_time);
 }
 
 static void widget_memory_make_stats(struct hud *s, struct widget *widget)
@@ -477,6 +545,12 @@ static void widget_memory_make_stats(struct hud *s, struct widget *widget)
         priv->sizes[MEMORY_TEXTURES] += ngli_image_get_memory_size(&texture->image)
                                       * tex_node->is_active;
     }
+
+    struct gpu_memory_stats stats;
+    ngli_gpu_ctx_get_memory_stats(s->ctx->gpu_ctx, &stats);
+    priv->sizes[MEMORY_HEAP_TOTAL] = stats.reserved_size;
+    priv->sizes[MEMORY_HEAP_USED]  = stats.used_size;
+    priv->sizes[MEMORY_HEAP_FRAG]  = stats.fragmented_size;
 }
 
 static void widget_activity_make_stats(struct hud *s, struct widget *widget)
@@ -492,6 +566,37 @@ static void widget_activity_make_stats(struct hud *s, struct widget *widget)
 static void widget_drawcall_make_stats(struct hud *s, struct widget *widget)
 {
     struct widget_drawcall *priv = widget->priv_data;
+    const struct drawcall_spec *spec = widget->user_data;
+    const struct draw_list *draw_list = s->ctx->gpu_ctx->draw_list;
+    const struct draw_list_stats *stats = draw_list ? ngli_draw_list_get_stats(draw_list) : NULL;
+
+    int nb_program_hits, nb_program_misses;
+    ngli_diskcache_get_stats(&s->ctx->gpu_ctx->program_cache, &nb_program_hits, &nb_program_misses);
+
+    switch (spec - drawcall_specs) {
+    case DRAWCALL_BINDS_SAVED:
+        priv->nb_draws = stats ? stats->nb_pipeline_binds_saved : 0;
+        return;
+    case DRAWCALL_STATES_SAVED:
+        priv->nb_draws = stats ? stats->nb_state_changes_saved : 0;
+        return;
+    case DRAWCALL_PROGRAM_HITS:
+        priv->nb_draws = nb_program_hits;
+        return;
+    case DRAWCALL_PROGRAM_MISSES:
+        priv->nb_draws = nb_program_misses;
+        return;
+    case DRAWCALL_MEDIA_MISSES:
+        priv->nb_draws = ngli_media_scheduler_get_nb_misses(s->ctx->media_scheduler);
+        return;
+    case DRAWCALL_MEDIA_DECODERS:
+        priv->nb_draws = ngli_media_scheduler_get_nb_decoders(s->ctx->media_scheduler);
+        return;
+    case DRAWCALL_MEDIA_PENDING:
+        priv->nb_draws = ngli_media_scheduler_get_nb_pending(s->ctx->media_scheduler);
+        return;
+    }
+
     struct darray *nodes_array = &priv->nodes;
     struct ngl_node **nodes = ngli_darray_data(nodes_array);
     priv->nb_draws = 0;
@@ -23,6 +23,7 @@
 
 #include "buffer.h"
 #include "hwconv.h"
+#include "hwmap.h"
 #include "gpu_ctx.h"
 #include "image.h"
 #include "log.h"
@@ -51,23 +52,148 @@ static const char *default_frag_base =
     "    ngl_out_color = ngl_texvideo(tex, var_tex_coord);"                     "\n"
     "}";
 
+static const char *default_comp_base =
+    "void main()"                                                               "\n"
+    "{"                                                                         "\n"
+    "    ivec2 size = imageSize(dst);"                                          "\n"
+    "    ivec2 pos = ivec2(gl_GlobalInvocationID.xy);"                          "\n"
+    "    if (pos.x >= size.x || pos.y >= size.y)"                               "\n"
+    "        return;"                                                           "\n"
+    "    vec2 uv = (vec2(pos) + 0.5) / vec2(size);"                             "\n"
+    "    vec2 tex_coord = (tex_coord_matrix * vec4(uv, 0.0, 1.0)).xy;"          "\n"
+    "    imageStore(dst, pos, ngl_texvideo(tex, tex_coord));"                   "\n"
+    "}";
+
 static const struct pgcraft_iovar vert_out_vars[] = {
     {.name = "var_tex_coord", .type = NGLI_TYPE_VEC2},
 };
 
-int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
-                     const struct image *dst_image,
-                     const struct image_params *src_params)
+#define WORKGROUP_SIZE 8
+
+static const char *get_frag_base(const struct image_params *src_params)
+{
+    const struct color_info *src_color_info = &src_params->color_info;
+    if (src_color_info->space == SXPLAYER_COL_SPC_BT2020_NCL) {
+        if (src_color_info->transfer == SXPLAYER_COL_TRC_ARIB_STD_B67) { // HLG
+            return hdr_hlg2sdr_frag;
+        } else if (src_color_info->transfer == SXPLAYER_COL_TRC_SMPTE2084)  { // PQ
+            return hdr_pq2sdr_frag;
+        }
+    }
+    return default_frag_base;
+}
+
+/*
+ * The conversion is dispatched as a compute shader when possible, saving the
+ * render pass setup. The HDR tone mapping shaders are fragment only, and the
+ * external (MediaCodec) samplers are not declared in compute shaders.
+ */
+static int use_compute(struct ngl_ctx *ctx, const struct image_params *src_params)
 {
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
-    hwconv->ctx = ctx;
-    hwconv->src_params = *src_params;
+    const struct ngl_config *config = &ctx->config;
 
-    if (dst_image->params.layout != NGLI_IMAGE_LAYOUT_DEFAULT) {
-        LOG(ERROR, "unsupported output image layout: 0x%x", dst_image->params.layout);
-        return NGL_ERROR_UNSUPPORTED;
+    if (!(gpu_ctx->features & NGLI_FEATURE_COMPUTE))
+        return 0;
+
+    if (ngli_hwmap_is_image_layout_supported(config->backend, NGLI_IMAGE_LAYOUT_MEDIACODEC))
+        return 0;
+
+    const enum image_layout src_layout = src_params->layout;
+    if (src_layout != NGLI_IMAGE_LAYOUT_DEFAULT &&
+        src_layout != NGLI_IMAGE_LAYOUT_NV12 &&
+        src_layout != NGLI_IMAGE_LAYOUT_YUV)
+        return 0;
+
+    return get_frag_base(src_params) == default_frag_base;
+}
+
+int ngli_hwconv_get_dst_usage(struct ngl_ctx *ctx, const struct image_params *src_params)
+{
+    return use_compute(ctx, src_params) ? NGLI_TEXTURE_USAGE_STORAGE_BIT
+                                        : NGLI_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+}
+
+static int init_pipeline(struct hwconv *hwconv, const struct pgcraft_params *crafter_params,
+                         const struct pipeline_params *pipeline_params)
+{
+    struct ngl_ctx *ctx = hwconv->ctx;
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
+
+    hwconv->crafter = ngli_pgcraft_create(ctx);
+    if (!hwconv->crafter)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_pgcraft_craft(hwconv->crafter, crafter_params);
+    if (ret < 0)
+        return ret;
+
+    hwconv->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
+    if (!hwconv->pipeline_compat)
+        return NGL_ERROR_MEMORY;
+
+    struct pipeline_params params = *pipeline_params;
+    params.program = ngli_pgcraft_get_program(hwconv->crafter);
+    params.layout  = ngli_pgcraft_get_pipeline_layout(hwconv->crafter);
+
+    const struct pipeline_resources pipeline_resources = ngli_pgcraft_get_pipeline_resources(hwconv->crafter);
+    const struct pgcraft_compat_info *compat_info = ngli_pgcraft_get_compat_info(hwconv->crafter);
+
+    const struct pipeline_compat_params compat_params = {
+        .params = &params,
+        .resources = &pipeline_resources,
+        .compat_info = compat_info,
+    };
+
+    return ngli_pipeline_compat_init(hwconv->pipeline_compat, &compat_params);
+}
+
+static int init_compute(struct hwconv *hwconv, const struct image *dst_image)
+{
+    struct texture *texture = dst_image->planes[0];
+
+    if (!(texture->params.usage & NGLI_TEXTURE_USAGE_STORAGE_BIT)) {
+        LOG(ERROR, "destination texture must be created with the storage usage");
+        return NGL_ERROR_INVALID_USAGE;
     }
 
+    const struct pgcraft_texture textures[] = {
+        {.name = "tex", .type = NGLI_PGCRAFT_SHADER_TEX_TYPE_VIDEO, .stage = NGLI_PROGRAM_SHADER_COMP},
+        {
+            .name     = "dst",
+            .type     = NGLI_PGCRAFT_SHADER_TEX_TYPE_IMAGE_2D,
+            .stage    = NGLI_PROGRAM_SHADER_COMP,
+            .writable = 1,
+            .format   = texture->params.format,
+            .texture  = texture,
+        },
+    };
+
+    const struct pgcraft_params crafter_params = {
+        .program_label    = "nodegl/hwconv",
+        .comp_base        = default_comp_base,
+        .textures         = textures,
+        .nb_textures      = NGLI_ARRAY_NB(textures),
+        .workgroup_size   = {WORKGROUP_SIZE, WORKGROUP_SIZE, 1},
+    };
+
+    const struct pipeline_params pipeline_params = {
+        .type = NGLI_PIPELINE_TYPE_COMPUTE,
+    };
+
+    hwconv->workgroup_count[0] = (dst_image->params.width  + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    hwconv->workgroup_count[1] = (dst_image->params.height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    hwconv->workgroup_count[2] = 1;
+
+    return init_pipeline(hwconv, &crafter_params, &pipeline_params);
+}
+
+static int init_graphics(struct hwconv *hwconv, const struct image *dst_image)
+{
+    struct ngl_ctx *ctx = hwconv->ctx;
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    const struct image_params *src_params = &hwconv->src_params;
+
     struct texture *texture = dst_image->planes[0];
     const struct texture_params *texture_params = &texture->params;
 
@@ -92,16 +218,6 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
     if (ret < 0)
         return ret;
 
-    const enum image_layout src_layout = src_params->layout;
-    if (src_layout != NGLI_IMAGE_LAYOUT_DEFAULT &&
-        src_layout != NGLI_IMAGE_LAYOUT_NV12 &&
-        src_layout != NGLI_IMAGE_LAYOUT_YUV &&
-        src_layout != NGLI_IMAGE_LAYOUT_NV12_RECTANGLE &&
-        src_layout != NGLI_IMAGE_LAYOUT_MEDIACODEC) {
-        LOG(ERROR, "unsupported texture layout: 0x%x", src_layout);
-        return NGL_ERROR_UNSUPPORTED;
-    }
-
     static const float vertices[] = {
         -1.0f, -1.0f, 0.0f, 0.0f,
          1.0f, -1.0f, 1.0f, 0.0f,
@@ -134,22 +250,10 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
         },
     };
 
-    const char *vert_base = default_vert_base;
-    const char *frag_base = default_frag_base;
-
-    const struct color_info *src_color_info = &src_params->color_info;
-    if (src_color_info->space == SXPLAYER_COL_SPC_BT2020_NCL) {
-        if (src_color_info->transfer == SXPLAYER_COL_TRC_ARIB_STD_B67) { // HLG
-            frag_base = hdr_hlg2sdr_frag;
-        } else if (src_color_info->transfer == SXPLAYER_COL_TRC_SMPTE2084)  { // PQ
-            frag_base = hdr_pq2sdr_frag;
-        }
-    }
-
     const struct pgcraft_params crafter_params = {
         .program_label    = "nodegl/hwconv",
-        .vert_base        = vert_base,
-        .frag_base        = frag_base,
+        .vert_base        = default_vert_base,
+        .frag_base        = get_frag_base(src_params),
         .textures         = textures,
         .nb_textures      = NGLI_ARRAY_NB(textures),
         .attributes       = attributes,
@@ -158,18 +262,6 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
         .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
     };
 
-    hwconv->crafter = ngli_pgcraft_create(ctx);
-    if (!hwconv->crafter)
-        return NGL_ERROR_MEMORY;
-
-    ret = ngli_pgcraft_craft(hwconv->crafter, &crafter_params);
-    if (ret < 0)
-        return ret;
-
-    hwconv->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
-    if (!hwconv->pipeline_compat)
-        return NGL_ERROR_MEMORY;
-
     const struct pipeline_params pipeline_params = {
         .type         = NGLI_PIPELINE_TYPE_GRAPHICS,
         .graphics     = {
@@ -177,24 +269,37 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
             .state    = NGLI_GRAPHICSTATE_DEFAULTS,
             .rt_desc  = rt_desc,
         },
-        .program      = ngli_pgcraft_get_program(hwconv->crafter),
-        .layout       = ngli_pgcraft_get_pipeline_layout(hwconv->crafter),
     };
 
-    const struct pipeline_resources pipeline_resources = ngli_pgcraft_get_pipeline_resources(hwconv->crafter);
-    const struct pgcraft_compat_info *compat_info = ngli_pgcraft_get_compat_info(hwconv->crafter);
+    return init_pipeline(hwconv, &crafter_params, &pipeline_params);
+}
 
-    const struct pipeline_compat_params params = {
-        .params = &pipeline_params,
-        .resources = &pipeline_resources,
-        .compat_info = compat_info,
-    };
+int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
+                     const struct image *dst_image,
+                     const struct image_params *src_params)
+{
+    hwconv->ctx = ctx;
+    hwconv->src_params = *src_params;
 
-    ret = ngli_pipeline_compat_init(hwconv->pipeline_compat, &params);
-    if (ret < 0)
-        return ret;
+    if (dst_image->params.layout != NGLI_IMAGE_LAYOUT_DEFAULT) {
+        LOG(ERROR, "unsupported output image layout: 0x%x", dst_image->params.layout);
+        return NGL_ERROR_UNSUPPORTED;
+    }
 
-    return 0;
+    const enum image_layout src_layout = src_params->layout;
+    if (src_layout != NGLI_IMAGE_LAYOUT_DEFAULT &&
+        src_layout != NGLI_IMAGE_LAYOUT_NV12 &&
+        src_layout != NGLI_IMAGE_LAYOUT_YUV &&
+        src_layout != NGLI_IMAGE_LAYOUT_NV12_RECTANGLE &&
+        src_layout != NGLI_IMAGE_LAYOUT_MEDIACODEC) {
+        LOG(ERROR, "unsupported texture layout: 0x%x", src_layout);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    hwconv->use_compute = use_compute(ctx, src_params);
+    if (hwconv->use_compute)
+        return init_compute(hwconv, dst_image);
+    return init_graphics(hwconv, dst_image);
 }
 
 int ngli_hwconv_convert_image(struct hwconv *hwconv, const struct image *image)
@@ -203,20 +308,12 @@ int ngli_hwconv_convert_image(struct hwconv *hwconv, const struct image *image)
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
     ngli_assert(hwconv->src_params.layout == image->params.layout);
 
-    struct rendertarget *rt = hwconv->rt;
-    ngli_gpu_ctx_begin_render_pass(gpu_ctx, rt);
-
-    int prev_vp[4] = {0};
-    ngli_gpu_ctx_get_viewport(gpu_ctx, prev_vp);
-
-    const int vp[4] = {0, 0, rt->width, rt->height};
-    ngli_gpu_ctx_set_viewport(gpu_ctx, vp);
-
     struct pipeline_compat *pipeline = hwconv->pipeline_compat;
 
+    /* The source texture is always the first one, followed by the destination image in compute */
     const struct darray *texture_infos_array = ngli_pgcraft_get_texture_infos(hwconv->crafter);
     const struct pgcraft_texture_info *info = ngli_darray_data(texture_infos_array);
-    ngli_assert(ngli_darray_count(texture_infos_array) == 1);
+    ngli_assert(ngli_darray_count(texture_infos_array) == (hwconv->use_compute ? 2 : 1));
 
     const struct pgcraft_texture_info_field *fields = info->fields;
 
@@ -254,6 +351,20 @@ int ngli_hwconv_convert_image(struct hwconv *hwconv, const struct image *image)
     ngli_pipeline_compat_update_uniform(pipeline, fields[NGLI_INFO_FIELD_COORDINATE_MATRIX].index, image->coordinates_matrix);
     ngli_pipeline_compat_update_uniform(pipeline, fields[NGLI_INFO_FIELD_COLOR_MATRIX].index, image->color_matrix);
 
+    if (hwconv->use_compute) {
+        ngli_pipeline_compat_dispatch(pipeline, NGLI_ARG_VEC3(hwconv->workgroup_count));
+        return 0;
+    }
+
+    struct rendertarget *rt = hwconv->rt;
+    ngli_gpu_ctx_begin_render_pass(gpu_ctx, rt);
+
+    int prev_vp[4] = {0};
+    ngli_gpu_ctx_get_viewport(gpu_ctx, prev_vp);
+
+    const int vp[4] = {0, 0, rt->width, rt->height};
+    ngli_gpu_ctx_set_viewport(gpu_ctx, vp);
+
     ngli_pipeline_compat_draw(pipeline, 4, 1);
 
     ngli_gpu_ctx_end_render_pass(gpu_ctx);
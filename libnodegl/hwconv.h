@@ -34,6 +34,8 @@ struct ngl_ctx;
 struct hwconv {
     struct ngl_ctx *ctx;
     struct image_params src_params;
+    int use_compute;
+    int workgroup_count[3];
 
     struct rendertarget *rt;
     struct buffer *vertices;
@@ -41,6 +43,14 @@ struct hwconv {
     struct pipeline_compat *pipeline_compat;
 };
 
+/*
+ * Return the usage the destination texture needs for the conversion of the
+ * images described by src_params: the conversion is dispatched as a compute
+ * shader writing into a storage image when the context supports it, and
+ * drawn into a color attachment otherwise
+ */
+int ngli_hwconv_get_dst_usage(struct ngl_ctx *ctx, const struct image_params *src_params);
+
 int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
                      const struct image *dst_image,
                      const struct image_params *src_params);
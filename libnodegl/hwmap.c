@@ -77,7 +77,7 @@ static int init_hwconv(struct hwmap *hwmap)
         .mipmap_filter = params->texture_mipmap_filter,
         .wrap_s        = params->texture_wrap_s,
         .wrap_t        = params->texture_wrap_t,
-        .usage         = params->texture_usage | NGLI_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT,
+        .usage         = params->texture_usage | ngli_hwconv_get_dst_usage(ctx, &mapped_image->params),
     };
 
     hwmap->hwconv_texture = ngli_texture_create(gpu_ctx);
@@ -197,9 +197,9 @@ static void hwmap_reset(struct hwmap *hwmap)
     hwmap->height = 0;
 }
 
-static int is_hdr(int trc)
+int ngli_hwmap_is_hdr(int color_trc)
 {
-    switch (trc) {
+    switch (color_trc) {
     case SXPLAYER_COL_TRC_ARIB_STD_B67: // HLG
     case SXPLAYER_COL_TRC_SMPTE2084:    // PQ
         return 1;
@@ -242,7 +242,7 @@ int ngli_hwmap_map_frame(struct hwmap *hwmap, struct sxplayer_frame *frame, stru
     if (ret < 0)
         goto end;
 
-    if (is_hdr(frame->color_trc))
+    if (ngli_hwmap_is_hdr(frame->color_trc))
         hwmap->require_hwconv = 1;
 
     if (hwmap->require_hwconv) {
@@ -76,6 +76,7 @@ struct hwmap_class {
 };
 
 int ngli_hwmap_is_image_layout_supported(int backend, int image_layout);
+int ngli_hwmap_is_hdr(int color_trc);
 
 int ngli_hwmap_init(struct hwmap *hwmap, struct ngl_ctx *ctx, const struct hwmap_params *params);
 int ngli_hwmap_map_frame(struct hwmap *hwmap, struct sxplayer_frame *frame, struct image *image);
@@ -29,14 +29,44 @@
 #include "image.h"
 #include "log.h"
 #include "math_utils.h"
+#include "memory.h"
 #include "nodegl.h"
 #include "internal.h"
 
+/*
+ * Number of plane texture sets the frames are uploaded into, in turns: the
+ * upload of a frame does not target the textures still sampled by the draws
+ * of the previous one, so it does not have to wait for them to complete
+ */
+#define MAX_SLOTS 2
+
+/*
+ * Reference counted sxplayer frame: the plane uploads may read the frame data
+ * in place until the GPU is done with them, so the frame is only released once
+ * every upload and the hwmap itself have given their reference back
+ */
+struct frame_ref {
+    struct sxplayer_frame *frame;
+    int refcount;
+};
+
+static void frame_ref_unref(void *arg)
+{
+    struct frame_ref *ref = arg;
+    if (--ref->refcount)
+        return;
+    sxplayer_release_frame(ref->frame);
+    ngli_free(ref);
+}
+
 struct hwmap_common {
     int width;
     int height;
     int nb_planes;
-    struct texture *planes[4];
+    int nb_slots;
+    int slot; /* slot of the last uploaded frame */
+    struct texture *planes[MAX_SLOTS][4];
+    struct frame_ref *frame_ref; /* last mapped frame, still accessed by the hwmap after map_frame */
 };
 
 static const struct format_desc {
@@ -169,38 +199,49 @@ static const struct format_desc *common_get_format_desc(int pix_fmt)
     return desc;
 }
 
-static int support_direct_rendering(struct hwmap *hwmap, const struct format_desc *desc)
+/*
+ * The planes are mipmapped individually, ngl_texvideo() sampling each of them
+ * at its own level. The 16-bit planes are only mipmapped with OpenGL, where
+ * the R16 formats are always renderable and thus support the mipmap
+ * generation; Vulkan does not guarantee the blit features on these formats.
+ */
+static int support_plane_mipmaps(struct hwmap *hwmap, const struct format_desc *desc)
+{
+    const struct ngl_ctx *ctx = hwmap->ctx;
+    const struct ngl_config *config = &ctx->config;
+
+    if (desc->layout == NGLI_IMAGE_LAYOUT_DEFAULT || desc->format_depth == 8)
+        return 1;
+    return config->backend == NGL_BACKEND_OPENGL || config->backend == NGL_BACKEND_OPENGLES;
+}
+
+static int support_direct_rendering(struct hwmap *hwmap, const struct format_desc *desc,
+                                    const struct sxplayer_frame *frame)
 {
     const struct hwmap_params *params = &hwmap->params;
 
+    /* The HDR frames are tone mapped by the conversion */
+    if (ngli_hwmap_is_hdr(frame->color_trc))
+        return 0;
+
     int direct_rendering = 1;
     if (desc->layout != NGLI_IMAGE_LAYOUT_DEFAULT) {
         direct_rendering = (params->image_layouts & (1 << desc->layout));
-        if (params->texture_mipmap_filter)
+        if (params->texture_mipmap_filter && !support_plane_mipmaps(hwmap, desc))
             direct_rendering = 0;
     }
 
     return direct_rendering;
 }
 
-static int common_init(struct hwmap *hwmap, struct sxplayer_frame *frame)
+static int init_planes(struct hwmap *hwmap, const struct format_desc *desc,
+                       const struct sxplayer_frame *frame, struct texture **planes)
 {
     struct ngl_ctx *ctx = hwmap->ctx;
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
     const struct hwmap_params *params = &hwmap->params;
-    struct hwmap_common *common = hwmap->hwmap_priv_data;
 
-    const struct format_desc *desc = common_get_format_desc(frame->pix_fmt);
-    if (!desc) {
-        LOG(ERROR, "unsupported sxplayer pixel format (%d)", frame->pix_fmt);
-        return NGL_ERROR_UNSUPPORTED;
-    }
-
-    common->width = frame->width;
-    common->height = frame->height;
-    common->nb_planes = desc->nb_planes;
-
-    for (int i = 0; i < common->nb_planes; i++) {
+    for (int i = 0; i < desc->nb_planes; i++) {
         const struct texture_params plane_params = {
             .type          = NGLI_TEXTURE_TYPE_2D,
             .format        = desc->formats[i],
@@ -208,17 +249,51 @@ static int common_init(struct hwmap *hwmap, struct sxplayer_frame *frame)
             .height        = i == 0 ? frame->height : NGLI_CEIL_RSHIFT(frame->height, desc->log2_chroma_height),
             .min_filter    = params->texture_min_filter,
             .mag_filter    = params->texture_mag_filter,
-            .mipmap_filter = desc->layout == NGLI_IMAGE_LAYOUT_DEFAULT ? params->texture_mipmap_filter : NGLI_MIPMAP_FILTER_NONE,
+            .mipmap_filter = hwmap->require_hwconv ? NGLI_MIPMAP_FILTER_NONE : params->texture_mipmap_filter,
             .wrap_s        = params->texture_wrap_s,
             .wrap_t        = params->texture_wrap_t,
             .usage         = params->texture_usage,
         };
 
-        common->planes[i] = ngli_texture_create(gpu_ctx);
-        if (!common->planes[i])
+        planes[i] = ngli_texture_create(gpu_ctx);
+        if (!planes[i])
             return NGL_ERROR_MEMORY;
 
-        int ret = ngli_texture_init(common->planes[i], &plane_params);
+        int ret = ngli_texture_init(planes[i], &plane_params);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int common_init(struct hwmap *hwmap, struct sxplayer_frame *frame)
+{
+    struct ngl_ctx *ctx = hwmap->ctx;
+    struct hwmap_common *common = hwmap->hwmap_priv_data;
+
+    const struct format_desc *desc = common_get_format_desc(frame->pix_fmt);
+    if (!desc) {
+        LOG(ERROR, "unsupported sxplayer pixel format (%d)", frame->pix_fmt);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    common->width = frame->width;
+    common->height = frame->height;
+    common->nb_planes = desc->nb_planes;
+
+    /* The planes only need mipmaps if they are sampled directly */
+    hwmap->require_hwconv = !support_direct_rendering(hwmap, desc, frame);
+
+    /*
+     * The Vulkan uploads are recorded in the frame command buffer and ordered
+     * with the previous draws by the GPU itself, they never block the CPU
+     */
+    common->nb_slots = ctx->config.backend == NGL_BACKEND_VULKAN ? 1 : MAX_SLOTS;
+    common->slot = common->nb_slots - 1;
+
+    for (int i = 0; i < common->nb_slots; i++) {
+        int ret = init_planes(hwmap, desc, frame, common->planes[i]);
         if (ret < 0)
             return ret;
     }
@@ -234,9 +309,7 @@ static int common_init(struct hwmap *hwmap, struct sxplayer_frame *frame)
         .color_scale = color_scale,
         .color_info = ngli_color_info_from_sxplayer_frame(frame),
     };
-    ngli_image_init(&hwmap->mapped_image, &image_params, common->planes);
-
-    hwmap->require_hwconv = !support_direct_rendering(hwmap, desc);
+    ngli_image_init(&hwmap->mapped_image, &image_params, common->planes[common->slot]);
 
     return 0;
 }
@@ -245,23 +318,53 @@ static void common_uninit(struct hwmap *hwmap)
 {
     struct hwmap_common *common = hwmap->hwmap_priv_data;
 
-    for (int i = 0; i < NGLI_ARRAY_NB(common->planes); i++)
-        ngli_texture_freep(&common->planes[i]);
+    for (int i = 0; i < MAX_SLOTS; i++)
+        for (int j = 0; j < NGLI_ARRAY_NB(common->planes[i]); j++)
+            ngli_texture_freep(&common->planes[i][j]);
+
+    if (common->frame_ref) {
+        frame_ref_unref(common->frame_ref);
+        common->frame_ref = NULL;
+    }
 }
 
 static int common_map_frame(struct hwmap *hwmap, struct sxplayer_frame *frame)
 {
     struct hwmap_common *common = hwmap->hwmap_priv_data;
 
+    struct frame_ref *ref = ngli_calloc(1, sizeof(*ref));
+    if (!ref) {
+        sxplayer_release_frame(frame);
+        return NGL_ERROR_MEMORY;
+    }
+    ref->frame = frame;
+    ref->refcount = 1;
+
+    if (common->frame_ref)
+        frame_ref_unref(common->frame_ref);
+    common->frame_ref = ref;
+
+    /*
+     * The planes are uploaded straight from the frame data when the backend
+     * supports it, saving a full copy of the frame into the staging memory
+     */
+    const int slot = (common->slot + 1) % common->nb_slots;
+    struct texture **planes = common->planes[slot];
     for (int i = 0; i < common->nb_planes; i++) {
-        struct texture *plane = common->planes[i];
+        struct texture *plane = planes[i];
         struct texture_params *params = &plane->params;
         const int linesize = frame->linesizep[i] / ngli_format_get_bytes_per_pixel(params->format);
-        int ret = ngli_texture_upload(plane, frame->datap[i], linesize);
+        ref->refcount++;
+        int ret = ngli_texture_upload_borrowed(plane, frame->datap[i], linesize, frame_ref_unref, ref);
         if (ret < 0)
             return ret;
     }
 
+    /* The mapped image now points to the newest frame */
+    common->slot = slot;
+    for (int i = 0; i < common->nb_planes; i++)
+        hwmap->mapped_image.planes[i] = planes[i];
+
     return 0;
 }
 
@@ -274,6 +377,7 @@ const struct hwmap_class ngli_hwmap_common_class = {
         NGLI_IMAGE_LAYOUT_YUV,
         NGLI_IMAGE_LAYOUT_NONE
     },
+    .flags     = HWMAP_FLAG_FRAME_OWNER,
     .priv_size = sizeof(struct hwmap_common),
     .init      = common_init,
     .map_frame = common_map_frame,
@@ -0,0 +1,460 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define _POSIX_C_SOURCE 200112L /* posix_madvise() */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include "imgseq_reader.h"
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "pthread_compat.h"
+#include "utils.h"
+
+#define SLOT_FREE    0
+#define SLOT_QUEUED  1
+#define SLOT_LOADING 2
+#define SLOT_READY   3
+#define SLOT_ERROR   4
+
+/* Stride used to fault in the mapped pages, smaller than any page size */
+#define PAGE_STRIDE 4096
+
+#define MAX_NUMBER_WIDTH 16
+
+struct slot {
+    int index;
+    int state;
+    void *data; /* mapped frame */
+};
+
+struct worker {
+    struct imgseq_reader *reader;
+    pthread_t tid;
+};
+
+struct imgseq_reader {
+    struct imgseq_reader_params params;
+    char *prefix;
+    char *suffix;
+    int zero_pad;
+    int number_width;
+
+    struct slot *slots;
+    int nb_slots;
+
+    struct worker *workers;
+    int nb_workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond_work;
+    pthread_cond_t cond_done;
+    int has_sync;
+    int stop;
+};
+
+static char *unescape_percents(const char *s, size_t len)
+{
+    char *dst = ngli_malloc(len + 1);
+    if (!dst)
+        return NULL;
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        dst[n++] = s[i];
+        if (s[i] == '%')
+            i++; /* skip the second % of the escape sequence */
+    }
+    dst[n] = 0;
+    return dst;
+}
+
+/*
+ * Split the pattern around its integer conversion, which is then formatted
+ * separately: the pattern is never used as a format string itself.
+ */
+static int parse_pattern(struct imgseq_reader *s, const char *pattern)
+{
+    const char *conv_start = NULL;
+    const char *conv_end = NULL;
+
+    for (const char *p = pattern; *p; p++) {
+        if (*p != '%')
+            continue;
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+
+        if (conv_start) {
+            LOG(ERROR, "pattern \"%s\" has more than one conversion", pattern);
+            return NGL_ERROR_INVALID_ARG;
+        }
+        conv_start = p++;
+
+        if (*p == '0') {
+            s->zero_pad = 1;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9')
+            s->number_width = s->number_width * 10 + *p++ - '0';
+        if (*p != 'd' || s->number_width > MAX_NUMBER_WIDTH) {
+            LOG(ERROR, "pattern \"%s\" has an unsupported conversion, "
+                "only %%d with an optional width is allowed", pattern);
+            return NGL_ERROR_INVALID_ARG;
+        }
+        conv_end = p + 1;
+    }
+
+    if (!conv_start) {
+        LOG(ERROR, "pattern \"%s\" has no frame number conversion", pattern);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    s->prefix = unescape_percents(pattern, conv_start - pattern);
+    s->suffix = unescape_percents(conv_end, strlen(conv_end));
+    if (!s->prefix || !s->suffix)
+        return NGL_ERROR_MEMORY;
+
+    return 0;
+}
+
+static char *get_filename(const struct imgseq_reader *s, int index)
+{
+    const int number = s->params.start_number + index;
+    if (s->zero_pad)
+        return ngli_asprintf("%s%0*d%s", s->prefix, s->number_width, number, s->suffix);
+    return ngli_asprintf("%s%*d%s", s->prefix, s->number_width, number, s->suffix);
+}
+
+#ifdef _WIN32
+static int map_file(const char *filename, size_t size, void **datap)
+{
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NGL_ERROR_IO;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || (uint64_t)file_size.QuadPart < size) {
+        CloseHandle(file);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+        return NGL_ERROR_IO;
+
+    /* The view keeps a reference on the mapping */
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    CloseHandle(mapping);
+    if (!data)
+        return NGL_ERROR_IO;
+
+    *datap = data;
+    return 0;
+}
+
+static void unmap_file(void *data, size_t size)
+{
+    UnmapViewOfFile(data);
+}
+#else
+static int map_file(const char *filename, size_t size, void **datap)
+{
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return NGL_ERROR_IO;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (uint64_t)st.st_size < size) {
+        close(fd);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    /* The mapping remains valid after the file is closed */
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NGL_ERROR_IO;
+
+    posix_madvise(data, size, POSIX_MADV_WILLNEED);
+
+    *datap = data;
+    return 0;
+}
+
+static void unmap_file(void *data, size_t size)
+{
+    munmap(data, size);
+}
+#endif
+
+static int load_frame(struct imgseq_reader *s, int index, void **datap)
+{
+    char *filename = get_filename(s, index);
+    if (!filename)
+        return NGL_ERROR_MEMORY;
+
+    const size_t size = s->params.frame_size;
+    int ret = map_file(filename, size, datap);
+    if (ret == NGL_ERROR_INVALID_DATA)
+        LOG(ERROR, "frame file %s is smaller than the expected %zu bytes", filename, size);
+    else if (ret < 0)
+        LOG(ERROR, "could not map frame file %s", filename);
+    ngli_free(filename);
+    if (ret < 0)
+        return ret;
+
+    /* Fault in the pages so the upload never waits for the disk */
+    const volatile uint8_t *data = *datap;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < size; i += PAGE_STRIDE)
+        sum += data[i];
+    sum += data[size - 1];
+    (void)sum;
+
+    return 0;
+}
+
+/* Must be called with the lock held */
+static struct slot *get_queued_slot(struct imgseq_reader *s)
+{
+    struct slot *next = NULL;
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct slot *slot = &s->slots[i];
+        if (slot->state == SLOT_QUEUED && (!next || slot->index < next->index))
+            next = slot;
+    }
+    return next;
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *worker = arg;
+    struct imgseq_reader *s = worker->reader;
+
+    ngli_thread_set_name("ngl-imgseq");
+
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        struct slot *slot = NULL;
+        while (!s->stop && !(slot = get_queued_slot(s)))
+            pthread_cond_wait(&s->cond_work, &s->lock);
+        if (s->stop)
+            break;
+
+        slot->state = SLOT_LOADING;
+        const int index = slot->index;
+        pthread_mutex_unlock(&s->lock);
+
+        void *data = NULL;
+        const int ret = load_frame(s, index, &data);
+
+        pthread_mutex_lock(&s->lock);
+        slot->data = data;
+        slot->state = ret < 0 ? SLOT_ERROR : SLOT_READY;
+        pthread_cond_broadcast(&s->cond_done);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+struct imgseq_reader *ngli_imgseq_reader_create(void)
+{
+    struct imgseq_reader *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+int ngli_imgseq_reader_init(struct imgseq_reader *s, const struct imgseq_reader_params *params)
+{
+    ngli_assert(params->nb_frames > 0 && params->frame_size > 0);
+    ngli_assert(params->nb_threads > 0 && params->read_ahead >= 0);
+
+    s->params = *params;
+
+    int ret = parse_pattern(s, params->pattern);
+    if (ret < 0)
+        return ret;
+    s->params.pattern = NULL;
+
+    s->nb_slots = NGLI_MIN(params->read_ahead + 1, params->nb_frames);
+    s->slots = ngli_calloc(s->nb_slots, sizeof(*s->slots));
+    if (!s->slots)
+        return NGL_ERROR_MEMORY;
+
+    if (pthread_mutex_init(&s->lock, NULL))
+        return NGL_ERROR_EXTERNAL;
+    if (pthread_cond_init(&s->cond_work, NULL)) {
+        pthread_mutex_destroy(&s->lock);
+        return NGL_ERROR_EXTERNAL;
+    }
+    if (pthread_cond_init(&s->cond_done, NULL)) {
+        pthread_cond_destroy(&s->cond_work);
+        pthread_mutex_destroy(&s->lock);
+        return NGL_ERROR_EXTERNAL;
+    }
+    s->has_sync = 1;
+
+    s->workers = ngli_calloc(params->nb_threads, sizeof(*s->workers));
+    if (!s->workers)
+        return NGL_ERROR_MEMORY;
+
+    for (int i = 0; i < params->nb_threads; i++) {
+        struct worker *worker = &s->workers[i];
+        worker->reader = s;
+        if (pthread_create(&worker->tid, NULL, worker_thread, worker))
+            return NGL_ERROR_EXTERNAL;
+        s->nb_workers++;
+    }
+
+    return 0;
+}
+
+/* Must be called with the lock held */
+static struct slot *find_slot(struct imgseq_reader *s, int index)
+{
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct slot *slot = &s->slots[i];
+        if (slot->state != SLOT_FREE && slot->index == index)
+            return slot;
+    }
+    return NULL;
+}
+
+/* Must be called with the lock held */
+static struct slot *get_free_slot(struct imgseq_reader *s, int start, int end)
+{
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct slot *slot = &s->slots[i];
+        if (slot->state == SLOT_FREE)
+            return slot;
+    }
+
+    /* Recycle a slot out of the read-ahead window, the loading ones are kept until they complete */
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct slot *slot = &s->slots[i];
+        if (slot->state == SLOT_LOADING || (slot->index >= start && slot->index < end))
+            continue;
+        if (slot->data)
+            unmap_file(slot->data, s->params.frame_size);
+        slot->data = NULL;
+        slot->state = SLOT_FREE;
+        return slot;
+    }
+
+    return NULL;
+}
+
+/* Must be called with the lock held */
+static void queue_window(struct imgseq_reader *s, int index)
+{
+    const int end = NGLI_MIN(index + s->nb_slots, s->params.nb_frames);
+
+    int nb_queued = 0;
+    for (int i = index; i < end; i++) {
+        if (find_slot(s, i))
+            continue;
+        struct slot *slot = get_free_slot(s, index, end);
+        if (!slot)
+            break;
+        slot->index = i;
+        slot->state = SLOT_QUEUED;
+        nb_queued++;
+    }
+
+    if (nb_queued)
+        pthread_cond_broadcast(&s->cond_work);
+}
+
+int ngli_imgseq_reader_get_frame(struct imgseq_reader *s, int index, const uint8_t **datap)
+{
+    ngli_assert(index >= 0 && index < s->params.nb_frames);
+
+    int ret = 0;
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        queue_window(s, index);
+
+        struct slot *slot = find_slot(s, index);
+        if (slot && slot->state == SLOT_READY) {
+            *datap = slot->data;
+            break;
+        }
+        if (slot && slot->state == SLOT_ERROR) {
+            /* Give the slot back so the next request retries the frame */
+            slot->state = SLOT_FREE;
+            ret = NGL_ERROR_IO;
+            break;
+        }
+
+        /* Wait for the frame or for a slot to be given back */
+        pthread_cond_wait(&s->cond_done, &s->lock);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return ret;
+}
+
+void ngli_imgseq_reader_freep(struct imgseq_reader **sp)
+{
+    struct imgseq_reader *s = *sp;
+    if (!s)
+        return;
+
+    if (s->nb_workers) {
+        pthread_mutex_lock(&s->lock);
+        s->stop = 1;
+        pthread_cond_broadcast(&s->cond_work);
+        pthread_mutex_unlock(&s->lock);
+
+        for (int i = 0; i < s->nb_workers; i++)
+            pthread_join(s->workers[i].tid, NULL);
+    }
+    ngli_freep(&s->workers);
+
+    if (s->has_sync) {
+        pthread_cond_destroy(&s->cond_done);
+        pthread_cond_destroy(&s->cond_work);
+        pthread_mutex_destroy(&s->lock);
+    }
+
+    for (int i = 0; i < s->nb_slots; i++)
+        if (s->slots[i].data)
+            unmap_file(s->slots[i].data, s->params.frame_size);
+    ngli_freep(&s->slots);
+
+    ngli_freep(&s->prefix);
+    ngli_freep(&s->suffix);
+    ngli_freep(sp);
+}
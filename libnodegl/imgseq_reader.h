@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef IMGSEQ_READER_H
+#define IMGSEQ_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct imgseq_reader_params {
+    const char *pattern;  /* path with a single integer conversion (%d, %04d, ...) */
+    int start_number;     /* number of the first frame file */
+    int nb_frames;
+    size_t frame_size;    /* size in bytes of a raw frame */
+    int nb_threads;       /* number of worker threads loading the frames */
+    int read_ahead;       /* number of frames loaded ahead of the requested one */
+};
+
+/*
+ * Reader of a sequence of raw frame files.
+ *
+ * The files are memory-mapped and their pages faulted in by a pool of worker
+ * threads, so the frames are resident by the time they are uploaded. When a
+ * frame is requested, the read_ahead following frames are queued for loading,
+ * nearest first; the frames out of this window are unmapped and their slots
+ * recycled. A request for a frame which is not loaded yet waits for it.
+ */
+struct imgseq_reader;
+
+struct imgseq_reader *ngli_imgseq_reader_create(void);
+int ngli_imgseq_reader_init(struct imgseq_reader *s, const struct imgseq_reader_params *params);
+
+/*
+ * Get the data of the frame at index (in [0, nb_frames)), waiting for its
+ * loading if needed. The data remains valid until the next call.
+ */
+int ngli_imgseq_reader_get_frame(struct imgseq_reader *s, int index, const uint8_t **datap);
+void ngli_imgseq_reader_freep(struct imgseq_reader **sp);
+
+#endif
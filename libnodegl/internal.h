@@ -41,13 +41,18 @@
 #include "animation.h"
 #include "block.h"
 #include "drawutils.h"
+#include "font_atlas.h"
+#include "frame_cache.h"
 #include "graphicstate.h"
 #include "hmap.h"
 #include "hud.h"
 #include "hwconv.h"
 #include "hwmap.h"
 #include "image.h"
+#include "imgseq_reader.h"
+#include "media_scheduler.h"
 #include "nodegl.h"
+#include "parallel_update.h"
 #include "params.h"
 #include "pgcache.h"
 #include "program.h"
@@ -58,6 +63,7 @@
 #include "rendertarget.h"
 #include "rnode.h"
 #include "texture.h"
+#include "threadpool.h"
 
 struct node_class;
 
@@ -67,9 +73,12 @@ struct api_impl {
     int (*configure)(struct ngl_ctx *s, const struct ngl_config *config);
     int (*resize)(struct ngl_ctx *s, int width, int height, const int *viewport);
     int (*set_capture_buffer)(struct ngl_ctx *s, void *capture_buffer);
+    int (*flush_capture)(struct ngl_ctx *s);
     int (*set_scene)(struct ngl_ctx *s, struct ngl_node *scene);
     int (*prepare_draw)(struct ngl_ctx *s, double t);
     int (*draw)(struct ngl_ctx *s, double t);
+    int (*draw_times)(struct ngl_ctx *s, const double *times, int nb_times,
+                      ngl_draw_callback_type callback, void *arg);
     void (*reset)(struct ngl_ctx *s, int action);
 
     /* OpenGL */
@@ -101,7 +110,7 @@ struct ngl_ctx {
      */
     struct darray activitycheck_nodes;
 
-    struct texture *font_atlas;
+    struct font_atlas *font_atlas;
     struct pgcache pgcache;
 #if defined(HAVE_VAAPI)
     struct vaapi_ctx vaapi_ctx;
@@ -109,8 +118,12 @@ struct ngl_ctx {
 #if defined(TARGET_ANDROID)
     struct android_ctx android_ctx;
 #endif
+    struct threadpool *threadpool;
+    struct parallel_update parallel_update;
+    struct media_scheduler *media_scheduler;
     struct hud *hud;
     int64_t cpu_update_time;
+    int64_t cpu_update_seq_time;
     int64_t cpu_draw_time;
     int64_t gpu_draw_time;
 
@@ -130,9 +143,12 @@ int ngli_ctx_dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg);
 int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config);
 int ngli_ctx_resize(struct ngl_ctx *s, int width, int height, const int *viewport);
 int ngli_ctx_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer);
+int ngli_ctx_flush_capture(struct ngl_ctx *s);
 int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_node *node);
 int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t);
 int ngli_ctx_draw(struct ngl_ctx *s, double t);
+int ngli_ctx_draw_times(struct ngl_ctx *s, const double *times, int nb_times,
+                        ngl_draw_callback_type callback, void *arg);
 void ngli_ctx_reset(struct ngl_ctx *s, int action);
 
 struct ngl_node {
@@ -147,6 +163,9 @@ struct ngl_node {
     double visit_time;
     double last_update_time;
 
+    int is_static;      /* the update output does not depend on the time */
+    int static_updated; /* the static node update has been honored */
+
     int draw_count;
 
     int refcount;
@@ -275,6 +294,8 @@ struct texture_priv {
     struct texture *texture;
     struct image image;
     struct hwmap hwmap;
+    struct image media_image; /* last image mapped from the media */
+    int imgseq_index;         /* index of the last uploaded image sequence frame */
 };
 
 struct media_priv {
@@ -282,6 +303,26 @@ struct media_priv {
     struct sxplayer_frame *frame;
     int nb_parents;
 
+    /* Decoder startup, driven by the media scheduler */
+    const char *filename;
+    int startup_state;          /* any of NGLI_MEDIA_STARTUP_* */
+    int64_t start_time;         /* wall time of the decoder start, in microseconds */
+    double deadline;            /* scene time at which the first frame is needed */
+    double deadline_visit_time; /* visit time for which the deadline was set */
+    int64_t use_index;          /* index of the last scheduler run the media was used in */
+
+    /* Decoded frames cache, owned by the Texture node using the media */
+    int frame_cache_size;
+    struct frame_cache *frame_cache;
+    const struct image *cached_image; /* cached image to display instead of frame */
+
+    /* Audio frames mapping, shared by all the Texture nodes using the media */
+    int audio_tex;
+    int nb_audio_users;
+    struct hwmap_params audio_hwmap_params; /* parameters of the first user */
+    struct hwmap audio_hwmap;
+    struct image audio_image;
+
 #if defined(TARGET_ANDROID)
     struct android_surface *android_surface;
     struct android_handlerthread *android_handlerthread;
@@ -289,6 +330,19 @@ struct media_priv {
 #endif
 };
 
+void ngli_node_media_set_deadline(struct ngl_node *node, double t, double deadline);
+void ngli_node_media_start(struct ngl_node *node);
+void ngli_node_media_stop(struct ngl_node *node);
+
+struct imagesequence_priv {
+    struct imgseq_reader *reader;
+    int format;
+    int width;
+    int height;
+    int index;           /* index of the current frame, -1 if none */
+    const uint8_t *data; /* data of the current frame, owned by the reader */
+};
+
 struct timerangemode_opts {
     double start_time;
     double render_time;
@@ -441,6 +495,26 @@ enum {
  */
 #define NGLI_NODE_FLAG_LIVECTL (1 << 0)
 
+/*
+ * Node update only computes CPU data from the time and from its children,
+ * and may be executed concurrently with the update of other nodes.
+ *
+ * The update callback must not perform any GPU operation nor touch any state
+ * shared with other nodes, and the node class must not implement the
+ * prefetch and release callbacks. The node is only updated in parallel if
+ * all its children with an update callback are flagged as well.
+ */
+#define NGLI_NODE_FLAG_PARALLEL_UPDATE (1 << 1)
+
+/*
+ * Node update depends directly on the time (and not only on its children).
+ *
+ * A node is considered static if its class is not flagged with this and all
+ * its children are static: its update is then only honored once, until the
+ * node is released or its branch is invalidated by a live change.
+ */
+#define NGLI_NODE_FLAG_TIME_DEPENDENT (1 << 2)
+
 /*
  * Specifications of a node.
  *
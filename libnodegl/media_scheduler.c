@@ -0,0 +1,345 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <stdlib.h>
+
+#include "darray.h"
+#include "hmap.h"
+#include "internal.h"
+#include "log.h"
+#include "media_scheduler.h"
+#include "memory.h"
+#include "utils.h"
+
+/* Startup latency assumed until it is measured, in microseconds */
+#define DEFAULT_STARTUP_LATENCY 250000
+
+/* A frame request blocking longer than this is accounted as a miss, in microseconds */
+#define MISS_THRESHOLD 2000
+
+/*
+ * Safety factor applied to the startup latency when computing how early a
+ * decoder must be started, since the latency varies from one start to another
+ */
+#define LEAD_TIME_FACTOR 1.5
+
+struct media_scheduler {
+    int max_startups;
+    int max_decoders;
+    struct hmap *latencies; /* filename -> int64_t startup latency, in microseconds */
+    struct darray pending;  /* struct ngl_node * */
+    struct darray starting; /* struct ngl_node * holding a startup slot */
+    struct darray running;  /* struct ngl_node * with a started decoder */
+    struct darray paused;   /* struct ngl_node * paused by the current run */
+    int64_t frame_index;
+    int nb_misses;
+};
+
+static void free_latency(void *user_arg, void *data)
+{
+    ngli_free(data);
+}
+
+struct media_scheduler *ngli_media_scheduler_create(int max_startups, int max_decoders)
+{
+    struct media_scheduler *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->latencies = ngli_hmap_create();
+    if (!s->latencies) {
+        ngli_free(s);
+        return NULL;
+    }
+    ngli_hmap_set_free(s->latencies, free_latency, NULL);
+
+    ngli_darray_init(&s->pending, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->starting, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->running, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->paused, sizeof(struct ngl_node *), 0);
+    s->max_startups = max_startups;
+    s->max_decoders = max_decoders;
+
+    return s;
+}
+
+static int64_t get_latency(const struct media_scheduler *s, const char *filename)
+{
+    const int64_t *latency = ngli_hmap_get(s->latencies, filename);
+    return latency ? *latency : DEFAULT_STARTUP_LATENCY;
+}
+
+static void remove_node(struct darray *nodes_array, const struct ngl_node *node)
+{
+    struct ngl_node **nodes = ngli_darray_data(nodes_array);
+    for (int i = 0; i < ngli_darray_count(nodes_array); i++) {
+        if (nodes[i] == node) {
+            ngli_darray_remove(nodes_array, i);
+            return;
+        }
+    }
+}
+
+static int start_decoder(struct media_scheduler *s, struct ngl_node *node)
+{
+    struct media_priv *priv = node->priv_data;
+
+    if (!ngli_darray_push(&s->starting, &node))
+        return NGL_ERROR_MEMORY;
+
+    if (!ngli_darray_push(&s->running, &node)) {
+        ngli_darray_pop(&s->starting);
+        return NGL_ERROR_MEMORY;
+    }
+
+    priv->startup_state = NGLI_MEDIA_STARTUP_STARTING;
+    priv->start_time = ngli_gettime_relative();
+    ngli_node_media_start(node);
+
+    return 0;
+}
+
+int ngli_media_scheduler_start(struct media_scheduler *s, struct ngl_node *node, int force)
+{
+    struct media_priv *priv = node->priv_data;
+
+    if (priv->startup_state == NGLI_MEDIA_STARTUP_PENDING)
+        remove_node(&s->pending, node);
+
+    if (!force && ((s->max_startups && ngli_darray_count(&s->starting) >= s->max_startups) ||
+                   (s->max_decoders && ngli_darray_count(&s->running) >= s->max_decoders))) {
+        if (!ngli_darray_push(&s->pending, &node))
+            return NGL_ERROR_MEMORY;
+        priv->startup_state = NGLI_MEDIA_STARTUP_PENDING;
+        return 0;
+    }
+
+    return start_decoder(s, node);
+}
+
+void ngli_media_scheduler_cancel(struct media_scheduler *s, struct ngl_node *node)
+{
+    struct media_priv *priv = node->priv_data;
+
+    if (priv->startup_state == NGLI_MEDIA_STARTUP_PENDING)
+        remove_node(&s->pending, node);
+    else if (priv->startup_state == NGLI_MEDIA_STARTUP_STARTING)
+        remove_node(&s->starting, node);
+    if (priv->startup_state >= NGLI_MEDIA_STARTUP_STARTING)
+        remove_node(&s->running, node);
+    priv->startup_state = NGLI_MEDIA_STARTUP_IDLE;
+}
+
+void ngli_media_scheduler_use(struct media_scheduler *s, struct ngl_node *node)
+{
+    struct media_priv *priv = node->priv_data;
+    priv->use_index = s->frame_index;
+}
+
+static int cmp_deadline(const void *a, const void *b)
+{
+    const struct media_priv *p0 = (*(struct ngl_node * const *)a)->priv_data;
+    const struct media_priv *p1 = (*(struct ngl_node * const *)b)->priv_data;
+    return (p0->deadline > p1->deadline) - (p0->deadline < p1->deadline);
+}
+
+/*
+ * Select the decoder to pause in favor of a pending one with the given
+ * deadline: among the decoders which were not used by the previous frame
+ * (only prefetched), the one needed the latest, if later than the deadline
+ */
+static int get_pause_candidate(const struct media_scheduler *s, double deadline)
+{
+    int index = -1;
+    double max_deadline = deadline;
+    struct ngl_node **running = ngli_darray_data(&s->running);
+    for (int i = 0; i < ngli_darray_count(&s->running); i++) {
+        const struct media_priv *priv = running[i]->priv_data;
+        if (priv->use_index >= s->frame_index - 1 || priv->deadline <= max_deadline)
+            continue;
+        max_deadline = priv->deadline;
+        index = i;
+    }
+    return index;
+}
+
+static int pause_decoder(struct media_scheduler *s, int index)
+{
+    struct ngl_node **running = ngli_darray_data(&s->running);
+    struct ngl_node *node = running[index];
+    struct media_priv *priv = node->priv_data;
+
+    if (!ngli_darray_push(&s->paused, &node))
+        return NGL_ERROR_MEMORY;
+
+    if (priv->startup_state == NGLI_MEDIA_STARTUP_STARTING)
+        remove_node(&s->starting, node);
+    ngli_darray_remove(&s->running, index);
+    priv->startup_state = NGLI_MEDIA_STARTUP_PENDING;
+    ngli_node_media_stop(node);
+
+    LOG(DEBUG, "pausing %s decoder until its deadline %g gets closer", priv->filename, priv->deadline);
+    return 0;
+}
+
+int ngli_media_scheduler_run(struct media_scheduler *s)
+{
+    s->nb_misses = 0;
+    s->frame_index++;
+
+    /* Give back the slots of the decoders past their estimated startup latency */
+    const int64_t now = ngli_gettime_relative();
+    int i = 0;
+    while (i < ngli_darray_count(&s->starting)) {
+        struct ngl_node **starting = ngli_darray_data(&s->starting);
+        const struct media_priv *priv = starting[i]->priv_data;
+        if (now - priv->start_time >= get_latency(s, priv->filename))
+            ngli_darray_remove(&s->starting, i);
+        else
+            i++;
+    }
+
+    const int nb_pending = ngli_darray_count(&s->pending);
+    if (!nb_pending)
+        return 0;
+
+    /* The decoders whose first frame is needed the soonest are started first */
+    struct ngl_node **pending = ngli_darray_data(&s->pending);
+    qsort(pending, nb_pending, sizeof(*pending), cmp_deadline);
+
+    /*
+     * When the decoders budget is exhausted, a pending decoder takes the place
+     * of a running one which is only prefetched and needed later
+     */
+    int ret = 0;
+    int nb_started = 0;
+    while (nb_started < nb_pending &&
+           (!s->max_startups || ngli_darray_count(&s->starting) < s->max_startups)) {
+        struct ngl_node *node = pending[nb_started];
+        if (s->max_decoders && ngli_darray_count(&s->running) >= s->max_decoders) {
+            const struct media_priv *priv = node->priv_data;
+            const int index = get_pause_candidate(s, priv->deadline);
+            if (index < 0)
+                break;
+            ret = pause_decoder(s, index);
+            if (ret < 0)
+                break;
+        }
+        ret = start_decoder(s, node);
+        if (ret < 0)
+            break;
+        nb_started++;
+    }
+    ngli_darray_remove_range(&s->pending, 0, nb_started);
+
+    /* The paused decoders are started again once a slot is available */
+    struct ngl_node **paused = ngli_darray_data(&s->paused);
+    for (int i = 0; i < ngli_darray_count(&s->paused); i++) {
+        if (!ngli_darray_push(&s->pending, &paused[i])) {
+            ret = NGL_ERROR_MEMORY;
+            break;
+        }
+    }
+    ngli_darray_clear(&s->paused);
+
+    return ret;
+}
+
+int ngli_media_scheduler_register_frame(struct media_scheduler *s, struct ngl_node *node,
+                                        int64_t request_time, int64_t end_time)
+{
+    struct media_priv *priv = node->priv_data;
+
+    const int missed = end_time - request_time > MISS_THRESHOLD;
+    s->nb_misses += missed;
+
+    if (priv->startup_state != NGLI_MEDIA_STARTUP_STARTING)
+        return 0;
+
+    priv->startup_state = NGLI_MEDIA_STARTUP_RUNNING;
+    remove_node(&s->starting, node);
+
+    /*
+     * If the request blocked, the decoder has just become ready and the
+     * elapsed time is its startup latency: the estimation grows right away
+     * and only decays slowly. Otherwise, the decoder was ready earlier and the
+     * elapsed time is an upper bound of its latency.
+     */
+    const int64_t elapsed = end_time - priv->start_time;
+    int64_t *latency = ngli_hmap_get(s->latencies, priv->filename);
+    if (latency) {
+        if (missed)
+            *latency = elapsed > *latency ? elapsed : (*latency + elapsed) / 2;
+        else
+            *latency = NGLI_MIN(*latency, elapsed);
+        return 0;
+    }
+
+    latency = ngli_malloc(sizeof(*latency));
+    if (!latency)
+        return NGL_ERROR_MEMORY;
+    *latency = missed ? elapsed : NGLI_MIN(elapsed, DEFAULT_STARTUP_LATENCY);
+
+    int ret = ngli_hmap_set(s->latencies, priv->filename, latency);
+    if (ret < 0) {
+        ngli_free(latency);
+        return ret;
+    }
+
+    LOG(DEBUG, "%s startup latency: %gms", priv->filename, *latency / 1000.);
+    return 0;
+}
+
+double ngli_media_scheduler_get_lead_time(const struct media_scheduler *s, const char *filename)
+{
+    const int64_t *latency = ngli_hmap_get(s->latencies, filename);
+    return latency ? *latency * LEAD_TIME_FACTOR / 1000000. : 0.;
+}
+
+int ngli_media_scheduler_get_nb_misses(const struct media_scheduler *s)
+{
+    return s->nb_misses;
+}
+
+int ngli_media_scheduler_get_nb_decoders(const struct media_scheduler *s)
+{
+    return ngli_darray_count(&s->running);
+}
+
+int ngli_media_scheduler_get_nb_pending(const struct media_scheduler *s)
+{
+    return ngli_darray_count(&s->pending);
+}
+
+void ngli_media_scheduler_freep(struct media_scheduler **sp)
+{
+    struct media_scheduler *s = *sp;
+    if (!s)
+        return;
+
+    ngli_hmap_freep(&s->latencies);
+    ngli_darray_reset(&s->pending);
+    ngli_darray_reset(&s->starting);
+    ngli_darray_reset(&s->running);
+    ngli_darray_reset(&s->paused);
+    ngli_freep(sp);
+}
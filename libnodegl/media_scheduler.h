@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef MEDIA_SCHEDULER_H
+#define MEDIA_SCHEDULER_H
+
+#include <stdint.h>
+
+struct ngl_node;
+
+/* Startup states of a media decoder */
+#define NGLI_MEDIA_STARTUP_IDLE     0 /* stopped */
+#define NGLI_MEDIA_STARTUP_PENDING  1 /* prefetched, waiting for a startup or decoder slot */
+#define NGLI_MEDIA_STARTUP_STARTING 2 /* started, first frame not obtained yet */
+#define NGLI_MEDIA_STARTUP_RUNNING  3
+
+/*
+ * Scheduler of the media decoders startup, shared by all the Media nodes of
+ * a context.
+ *
+ * The prefetched decoders are started in order of deadline (the scene time at
+ * which their first frame is needed), with at most max_startups of them
+ * spinning up concurrently (0 for no limit). A decoder holds its startup slot
+ * until its first frame is obtained, or until its estimated startup latency
+ * has elapsed.
+ *
+ * The number of decoders running at once can also be limited with
+ * max_decoders (0 for no limit). When the limit is reached, a pending decoder
+ * pauses (stops) a running one which was not used by the previous frame and
+ * is needed later than itself; the paused decoder gets back in the queue. The
+ * decoders whose frame is needed right away are always started.
+ *
+ * The startup latency is measured per file, from the decoder start to its
+ * first frame, and is used by the TimeRangeFilter nodes to prefetch the media
+ * early enough. The frame requests blocking the update because the decoder is
+ * not ready are accounted as misses.
+ */
+struct media_scheduler;
+
+struct media_scheduler *ngli_media_scheduler_create(int max_startups, int max_decoders);
+
+/*
+ * Start the media decoder if a startup slot is available, queue it otherwise.
+ * If force is set, the decoder is started regardless of the slots.
+ */
+int ngli_media_scheduler_start(struct media_scheduler *s, struct ngl_node *node, int force);
+void ngli_media_scheduler_cancel(struct media_scheduler *s, struct ngl_node *node);
+
+/* Mark the media as used by the current frame, must be called by its update */
+void ngli_media_scheduler_use(struct media_scheduler *s, struct ngl_node *node);
+
+/* Start the queued decoders as the slots are given back, must be called once per frame */
+int ngli_media_scheduler_run(struct media_scheduler *s);
+
+/* Account a frame request which started at request_time and returned at end_time */
+int ngli_media_scheduler_register_frame(struct media_scheduler *s, struct ngl_node *node,
+                                        int64_t request_time, int64_t end_time);
+
+/* Time in seconds the decoder of the file should be started ahead of its use */
+double ngli_media_scheduler_get_lead_time(const struct media_scheduler *s, const char *filename);
+int ngli_media_scheduler_get_nb_misses(const struct media_scheduler *s);
+int ngli_media_scheduler_get_nb_decoders(const struct media_scheduler *s);
+int ngli_media_scheduler_get_nb_pending(const struct media_scheduler *s);
+void ngli_media_scheduler_freep(struct media_scheduler **sp);
+
+#endif
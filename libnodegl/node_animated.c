@@ -283,7 +283,8 @@ int ngl_anim_evaluate(struct ngl_node *node, void *dst, double t)
         node->cls->id == NGL_NODE_VELOCITYVEC4)
         return ngli_velocity_evaluate(node, dst, t);
 
-    if (node->cls->id != NGL_NODE_ANIMATEDFLOAT &&
+    if (node->cls->id != NGL_NODE_ANIMATEDTIME &&
+        node->cls->id != NGL_NODE_ANIMATEDFLOAT &&
         node->cls->id != NGL_NODE_ANIMATEDVEC2 &&
         node->cls->id != NGL_NODE_ANIMATEDVEC3 &&
         node->cls->id != NGL_NODE_ANIMATEDVEC4 &&
@@ -427,24 +428,28 @@ static int animatedquat_update(struct ngl_node *node, double t)
     return 0;
 }
 
-#define DEFINE_ANIMATED_CLASS(class_id, class_name, type)       \
-const struct node_class ngli_animated##type##_class = {         \
-    .id        = class_id,                                      \
-    .category  = NGLI_NODE_CATEGORY_VARIABLE,                   \
-    .name      = class_name,                                    \
-    .init      = animated##type##_init,                         \
-    .update    = animated##type##_update,                       \
-    .opts_size = sizeof(struct variable_opts),                  \
-    .priv_size = sizeof(struct animated_priv),                  \
-    .params    = animated##type##_params,                       \
-    .file      = __FILE__,                                      \
+#define DEFINE_ANIMATED_CLASS(class_id, class_name, type, class_flags) \
+const struct node_class ngli_animated##type##_class = {                \
+    .id        = class_id,                                             \
+    .category  = NGLI_NODE_CATEGORY_VARIABLE,                          \
+    .name      = class_name,                                           \
+    .init      = animated##type##_init,                                \
+    .update    = animated##type##_update,                              \
+    .opts_size = sizeof(struct variable_opts),                         \
+    .priv_size = sizeof(struct animated_priv),                         \
+    .params    = animated##type##_params,                              \
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT | class_flags,          \
+    .file      = __FILE__,                                             \
 };
 
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDTIME,  "AnimatedTime",  time)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDFLOAT, "AnimatedFloat", float)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC2,  "AnimatedVec2",  vec2)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC3,  "AnimatedVec3",  vec3)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC4,  "AnimatedVec4",  vec4)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDQUAT,  "AnimatedQuat",  quat)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDPATH,  "AnimatedPath",  path)
-DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDCOLOR, "AnimatedColor", color)
+#define PARALLEL NGLI_NODE_FLAG_PARALLEL_UPDATE
+
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDTIME,  "AnimatedTime",  time,  PARALLEL)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDFLOAT, "AnimatedFloat", float, PARALLEL)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC2,  "AnimatedVec2",  vec2,  PARALLEL)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC3,  "AnimatedVec3",  vec3,  PARALLEL)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDVEC4,  "AnimatedVec4",  vec4,  PARALLEL)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDQUAT,  "AnimatedQuat",  quat,  PARALLEL)
+/* The path evaluation caches its position in the Path node which can be shared */
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDPATH,  "AnimatedPath",  path,  0)
+DEFINE_ANIMATED_CLASS(NGL_NODE_ANIMATEDCOLOR, "AnimatedColor", color, PARALLEL)
@@ -108,6 +108,7 @@ static const struct param_choices layout_choices = {
 
 struct block_priv {
     struct block_info blk;
+    uint8_t *scratch; /* staging area used to detect the changing fields */
     int force_update;
 };
 
@@ -207,23 +208,44 @@ static const uint8_t *get_data_ptr(const struct ngl_node *node, const struct blo
     return fi->count ? get_buffer_data_ptr(node) : get_variable_data_ptr(node);
 }
 
-static int update_block_data(struct ngl_node *node, int forced)
+/*
+ * Refresh the block CPU data and return the byte range [*startp, *endp)
+ * covering all the fields that have changed (empty if start >= end).
+ */
+static void update_block_data(struct ngl_node *node, int forced, int *startp, int *endp)
 {
-    int has_changed = 0;
     struct block_priv *s = node->priv_data;
     struct block_info *info = &s->blk;
     const struct block_opts *o = node->opts;
     const struct block_field *field_info = ngli_darray_data(&info->block.fields);
+
+    int start = info->data_size;
+    int end = 0;
     for (int i = 0; i < o->nb_fields; i++) {
         const struct ngl_node *field_node = o->fields[i];
         const struct block_field *fi = &field_info[i];
         if (!forced && !field_is_dynamic(field_node, fi))
             continue;
         const uint8_t *src = get_data_ptr(field_node, fi);
-        ngli_block_field_copy(fi, info->data + fi->offset, src);
-        has_changed = 1; // TODO: only re-upload the changing data segments
+        if (forced) {
+            ngli_block_field_copy(fi, info->data + fi->offset, src);
+        } else {
+            ngli_block_field_copy(fi, s->scratch + fi->offset, src);
+            if (!memcmp(info->data + fi->offset, s->scratch + fi->offset, fi->size))
+                continue;
+            memcpy(info->data + fi->offset, s->scratch + fi->offset, fi->size);
+        }
+        start = NGLI_MIN(start, fi->offset);
+        end = NGLI_MAX(end, fi->offset + fi->size);
     }
-    return has_changed;
+
+    if (forced) {
+        start = 0;
+        end = info->data_size;
+    }
+
+    *startp = start;
+    *endp = end;
 }
 
 static int cmp_str(const void *a, const void *b)
@@ -322,10 +344,12 @@ static int block_init(struct ngl_node *node)
     info->data_size = info->block.size;
     LOG(DEBUG, "total %s size: %d", node->label, info->data_size);
     info->data = ngli_calloc(1, info->data_size);
-    if (!info->data)
+    s->scratch = ngli_calloc(1, info->data_size);
+    if (!info->data || !s->scratch)
         return NGL_ERROR_MEMORY;
 
-    update_block_data(node, 1);
+    int start, end;
+    update_block_data(node, 1, &start, &end);
     s->force_update = 1; /* First update will need an upload */
 
     info->buffer = ngli_buffer_create(gpu_ctx);
@@ -370,11 +394,12 @@ static int block_update(struct ngl_node *node, double t)
     if (ret < 0)
         return ret;
 
-    const int has_changed = update_block_data(node, s->force_update);
+    int start, end;
+    update_block_data(node, s->force_update, &start, &end);
     s->force_update = 0;
 
-    if (has_changed) {
-        ret = ngli_buffer_upload(info->buffer, info->data, info->data_size, 0);
+    if (start < end) {
+        ret = ngli_buffer_upload(info->buffer, info->data + start, end - start, start);
         if (ret < 0)
             return ret;
     }
@@ -390,6 +415,7 @@ static void block_uninit(struct ngl_node *node)
     ngli_buffer_freep(&info->buffer);
     ngli_block_reset(&info->block);
     ngli_free(info->data);
+    ngli_free(s->scratch);
 }
 
 const struct node_class ngli_block_class = {
@@ -200,6 +200,7 @@ const struct node_class ngli_eval##type##_class = {                 \
     .opts_size = sizeof(struct eval_opts),                          \
     .priv_size = sizeof(struct eval_priv),                          \
     .params    = eval_##type##_params,                              \
+    .flags     = NGLI_NODE_FLAG_PARALLEL_UPDATE,                    \
     .file      = __FILE__,                                          \
 };
 
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2016-2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "format.h"
+#include "imgseq_reader.h"
+#include "log.h"
+#include "nodegl.h"
+#include "internal.h"
+#include "utils.h"
+
+struct imagesequence_opts {
+    const char *pattern;
+    int start_number;
+    int nb_frames;
+    int framerate[2];
+    struct ngl_node *time_anim;
+    int width;
+    int height;
+    int format;
+    int nb_threads;
+    int read_ahead;
+};
+
+static const struct param_choices format_choices = {
+    .name = "imgseq_format",
+    .consts = {
+        {"r8_unorm",            NGLI_FORMAT_R8_UNORM,            .desc=NGLI_DOCSTRING("8-bit unsigned normalized R component")},
+        {"r8g8_unorm",          NGLI_FORMAT_R8G8_UNORM,          .desc=NGLI_DOCSTRING("8-bit unsigned normalized RG components")},
+        {"r8g8b8a8_unorm",      NGLI_FORMAT_R8G8B8A8_UNORM,      .desc=NGLI_DOCSTRING("8-bit unsigned normalized RGBA components")},
+        {"r8g8b8a8_srgb",       NGLI_FORMAT_R8G8B8A8_SRGB,       .desc=NGLI_DOCSTRING("8-bit unsigned normalized RGBA components")},
+        {"b8g8r8a8_unorm",      NGLI_FORMAT_B8G8R8A8_UNORM,      .desc=NGLI_DOCSTRING("8-bit unsigned normalized BGRA components")},
+        {"r16_unorm",           NGLI_FORMAT_R16_UNORM,           .desc=NGLI_DOCSTRING("16-bit unsigned normalized R component")},
+        {"r16g16b16a16_unorm",  NGLI_FORMAT_R16G16B16A16_UNORM,  .desc=NGLI_DOCSTRING("16-bit unsigned normalized RGBA components")},
+        {"r16g16b16a16_sfloat", NGLI_FORMAT_R16G16B16A16_SFLOAT, .desc=NGLI_DOCSTRING("16-bit signed float RGBA components")},
+        {"r32_sfloat",          NGLI_FORMAT_R32_SFLOAT,          .desc=NGLI_DOCSTRING("32-bit signed float R component")},
+        {"r32g32b32a32_sfloat", NGLI_FORMAT_R32G32B32A32_SFLOAT, .desc=NGLI_DOCSTRING("32-bit signed float RGBA components")},
+        {NULL}
+    }
+};
+
+#define OFFSET(x) offsetof(struct imagesequence_opts, x)
+static const struct node_param imagesequence_params[] = {
+    {"pattern",      NGLI_PARAM_TYPE_STR, OFFSET(pattern), {.str=NULL}, NGLI_PARAM_FLAG_NON_NULL,
+                     .desc=NGLI_DOCSTRING("path to the raw frame files, with a single frame number conversion "
+                                          "(`%d` with an optional zero padded width such as `%04d`)")},
+    {"start_number", NGLI_PARAM_TYPE_I32, OFFSET(start_number), {.i32=0},
+                     .desc=NGLI_DOCSTRING("frame number of the first file")},
+    {"nb_frames",    NGLI_PARAM_TYPE_I32, OFFSET(nb_frames), {.i32=0},
+                     .desc=NGLI_DOCSTRING("number of frames in the sequence")},
+    {"framerate",    NGLI_PARAM_TYPE_RATIONAL, OFFSET(framerate), {.r={25, 1}},
+                     .desc=NGLI_DOCSTRING("number of frames per second")},
+    {"time_anim",    NGLI_PARAM_TYPE_NODE, OFFSET(time_anim),
+                     .node_types=(const int[]){NGL_NODE_ANIMATEDTIME, -1},
+                     .desc=NGLI_DOCSTRING("time remapping animation (must use a `linear` interpolation)")},
+    {"width",        NGLI_PARAM_TYPE_I32, OFFSET(width), {.i32=0},
+                     .desc=NGLI_DOCSTRING("width of the frames")},
+    {"height",       NGLI_PARAM_TYPE_I32, OFFSET(height), {.i32=0},
+                     .desc=NGLI_DOCSTRING("height of the frames")},
+    {"format",       NGLI_PARAM_TYPE_SELECT, OFFSET(format), {.i32=NGLI_FORMAT_R8G8B8A8_UNORM},
+                     .choices=&format_choices,
+                     .desc=NGLI_DOCSTRING("pixel format of the raw frames, tightly packed")},
+    {"nb_threads",   NGLI_PARAM_TYPE_I32, OFFSET(nb_threads), {.i32=2},
+                     .desc=NGLI_DOCSTRING("number of threads loading the frames")},
+    {"read_ahead",   NGLI_PARAM_TYPE_I32, OFFSET(read_ahead), {.i32=4},
+                     .desc=NGLI_DOCSTRING("number of frames loaded ahead of the current one")},
+    {NULL}
+};
+
+static int imagesequence_init(struct ngl_node *node)
+{
+    struct imagesequence_priv *s = node->priv_data;
+    const struct imagesequence_opts *o = node->opts;
+
+    if (o->nb_frames <= 0) {
+        LOG(ERROR, "the number of frames must be strictly positive");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (o->framerate[0] <= 0 || o->framerate[1] <= 0) {
+        LOG(ERROR, "invalid framerate: %d/%d", o->framerate[0], o->framerate[1]);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (o->width <= 0 || o->height <= 0) {
+        LOG(ERROR, "invalid frame dimensions: %dx%d", o->width, o->height);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (o->nb_threads < 1 || o->read_ahead < 0) {
+        LOG(ERROR, "the number of threads must be at least 1 and the read-ahead cannot be negative");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    s->format = o->format;
+    s->width = o->width;
+    s->height = o->height;
+    s->index = -1;
+
+    return 0;
+}
+
+static int imagesequence_prefetch(struct ngl_node *node)
+{
+    struct imagesequence_priv *s = node->priv_data;
+    const struct imagesequence_opts *o = node->opts;
+
+    const struct imgseq_reader_params params = {
+        .pattern      = o->pattern,
+        .start_number = o->start_number,
+        .nb_frames    = o->nb_frames,
+        .frame_size   = (size_t)o->width * o->height * ngli_format_get_bytes_per_pixel(o->format),
+        .nb_threads   = o->nb_threads,
+        .read_ahead   = o->read_ahead,
+    };
+
+    s->reader = ngli_imgseq_reader_create();
+    if (!s->reader)
+        return NGL_ERROR_MEMORY;
+
+    return ngli_imgseq_reader_init(s->reader, &params);
+}
+
+static int imagesequence_update(struct ngl_node *node, double t)
+{
+    struct imagesequence_priv *s = node->priv_data;
+    const struct imagesequence_opts *o = node->opts;
+    struct ngl_node *time_anim = o->time_anim;
+
+    double seq_time = t;
+    if (time_anim) {
+        struct variable_info *anim = time_anim->priv_data;
+
+        int ret = ngli_node_update(time_anim, t);
+        if (ret < 0)
+            return ret;
+        seq_time = *(double *)anim->data;
+
+        TRACE("remapped time f(%g)=%g", t, seq_time);
+    }
+
+    /* The sequence holds its first and last frames outside of its time range */
+    const double frame_pos = floor(seq_time * o->framerate[0] / o->framerate[1]);
+    const int index = (int)NGLI_MAX(0., NGLI_MIN(frame_pos, (double)(o->nb_frames - 1)));
+    if (index == s->index)
+        return 0;
+
+    TRACE("get frame %d from %s at t=%g", index, node->label, seq_time);
+    int ret = ngli_imgseq_reader_get_frame(s->reader, index, &s->data);
+    if (ret < 0) {
+        LOG(ERROR, "could not load frame %d of %s", index, node->label);
+        s->index = -1;
+        s->data = NULL;
+        return ret;
+    }
+    s->index = index;
+
+    return 0;
+}
+
+static void imagesequence_release(struct ngl_node *node)
+{
+    struct imagesequence_priv *s = node->priv_data;
+    ngli_imgseq_reader_freep(&s->reader);
+    s->index = -1;
+    s->data = NULL;
+}
+
+const struct node_class ngli_imagesequence_class = {
+    .id        = NGL_NODE_IMAGESEQUENCE,
+    .name      = "ImageSequence",
+    .init      = imagesequence_init,
+    .prefetch  = imagesequence_prefetch,
+    .update    = imagesequence_update,
+    .release   = imagesequence_release,
+    .opts_size = sizeof(struct imagesequence_opts),
+    .priv_size = sizeof(struct imagesequence_priv),
+    .params    = imagesequence_params,
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,
+    .file      = __FILE__,
+};
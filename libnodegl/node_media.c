@@ -32,8 +32,10 @@
 #endif
 
 #include "log.h"
+#include "media_scheduler.h"
 #include "nodegl.h"
 #include "internal.h"
+#include "utils.h"
 
 #if defined(TARGET_ANDROID)
 #include "gpu_ctx.h"
@@ -53,6 +55,7 @@ struct media_opts {
     int hwaccel;
     char *filters;
     char *vt_pix_fmt;
+    int frame_cache_size;
 };
 
 static const struct param_choices sxplayer_log_level_choices = {
@@ -108,6 +111,9 @@ static const struct node_param media_params[] = {
                        .desc=NGLI_DOCSTRING("filters to apply on the media (sxplayer/libavfilter)")},
     {"vt_pix_fmt",     NGLI_PARAM_TYPE_STR, OFFSET(vt_pix_fmt),  {.str="auto"},
                        .desc=NGLI_DOCSTRING("auto or a comma or space separated list of VideoToolbox (Apple) allowed output pixel formats")},
+    {"frame_cache_size", NGLI_PARAM_TYPE_I32, OFFSET(frame_cache_size), {.i32=0},
+                       .desc=NGLI_DOCSTRING("maximum memory size in bytes of the frames kept on the GPU to serve repeated and backward time accesses "
+                                            "without decoding (0 disables the cache, ignored for `audio_tex`)")},
     {NULL}
 };
 
@@ -159,6 +165,9 @@ static int media_init(struct ngl_node *node)
 
     sxplayer_set_log_callback(s->player, node->opts, callback_sxplayer_log);
 
+    s->filename = o->filename;
+    s->deadline_visit_time = -1.;
+
     struct ngl_node *anim_node = o->anim;
     if (anim_node) {
         const struct variable_opts *anim = anim_node->opts;
@@ -198,11 +207,18 @@ static int media_init(struct ngl_node *node)
 #endif
 
     if (o->audio_tex) {
+        s->audio_tex = 1;
         sxplayer_set_option(s->player, "avselect", SXPLAYER_SELECT_AUDIO);
         sxplayer_set_option(s->player, "audio_texture", 1);
         return 0;
     }
 
+    if (o->frame_cache_size < 0) {
+        LOG(ERROR, "invalid frame cache size: %d", o->frame_cache_size);
+        return NGL_ERROR_INVALID_ARG;
+    }
+    s->frame_cache_size = o->frame_cache_size;
+
 #if defined(TARGET_ANDROID)
     struct ngl_ctx *ctx = node->ctx;
     struct android_ctx *android_ctx = &ctx->android_ctx;
@@ -245,11 +261,78 @@ static int media_init(struct ngl_node *node)
     return 0;
 }
 
-static int media_prefetch(struct ngl_node *node)
+void ngli_node_media_set_deadline(struct ngl_node *node, double t, double deadline)
 {
     struct media_priv *s = node->priv_data;
+
+    /* The media may be reached through multiple paths, the earliest use wins */
+    if (s->deadline_visit_time != t) {
+        s->deadline = deadline;
+        s->deadline_visit_time = t;
+    } else {
+        s->deadline = NGLI_MIN(s->deadline, deadline);
+    }
+}
+
+static double get_deadline(const struct ngl_node *node)
+{
+    const struct media_priv *s = node->priv_data;
+    const double t = node->visit_time;
+    return s->deadline_visit_time == t ? s->deadline : t;
+}
+
+static double get_initial_seek(const struct media_opts *o)
+{
+    const struct variable_opts *anim = o->anim->opts;
+    const struct animkeyframe_opts *kf0 = anim->animkf[0]->opts;
+    return kf0->scalar;
+}
+
+void ngli_node_media_start(struct ngl_node *node)
+{
+    struct media_priv *s = node->priv_data;
+    const struct media_opts *o = node->opts;
+
     sxplayer_start(s->player);
-    return 0;
+
+    /*
+     * The decoder is started ahead of its first use: seek it straight to the
+     * media time needed at that point, so the first frame request does not
+     * have to wait for another seek
+     */
+    const double t = node->visit_time;
+    const double deadline = get_deadline(node);
+    if (deadline <= t || o->audio_tex)
+        return;
+
+    double media_time = deadline;
+    if (o->anim) {
+        double dval;
+        if (ngl_anim_evaluate(o->anim, &dval, deadline) < 0)
+            return;
+        media_time = NGLI_MAX(0, dval - get_initial_seek(o));
+    }
+
+    if (media_time > 0) {
+        TRACE("seek %s to %g ahead of its use at t=%g", node->label, media_time, deadline);
+        sxplayer_seek(s->player, media_time);
+    }
+}
+
+void ngli_node_media_stop(struct ngl_node *node)
+{
+    struct media_priv *s = node->priv_data;
+    sxplayer_release_frame(s->frame);
+    s->frame = NULL;
+    sxplayer_stop(s->player);
+}
+
+static int media_prefetch(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct media_priv *s = node->priv_data;
+    s->deadline = get_deadline(node);
+    return ngli_media_scheduler_start(ctx->media_scheduler, node, 0);
 }
 
 static const char * const pix_fmt_names[] = {
@@ -270,29 +353,54 @@ static const char * const pix_fmt_names[] = {
 
 static int media_update(struct ngl_node *node, double t)
 {
+    struct ngl_ctx *ctx = node->ctx;
     struct media_priv *s = node->priv_data;
     const struct media_opts *o = node->opts;
     struct ngl_node *anim_node = o->anim;
     double media_time = t;
 
+    ngli_media_scheduler_use(ctx->media_scheduler, node);
+
     if (anim_node) {
         struct variable_info *anim = anim_node->priv_data;
-        const struct variable_opts *anim_o = anim_node->opts;
-        const struct animkeyframe_opts *kf0 = anim_o->animkf[0]->opts;
-        const double initial_seek = kf0->scalar;
         int ret = ngli_node_update(anim_node, t);
         if (ret < 0)
             return ret;
         const double dval = *(double *)anim->data;
-        media_time = NGLI_MAX(0, dval - initial_seek);
+        media_time = NGLI_MAX(0, dval - get_initial_seek(o));
 
         TRACE("remapped time f(%g)=%g", t, media_time);
     }
 
     sxplayer_release_frame(s->frame);
+    s->frame = NULL;
+
+    s->cached_image = NULL;
+    if (s->frame_cache) {
+        s->cached_image = ngli_frame_cache_get(s->frame_cache, media_time);
+        if (s->cached_image) {
+            TRACE("got cached frame from %s at t=%g", node->label, media_time);
+            return 0;
+        }
+    }
+
+    /* The frame is needed now, the decoder cannot wait for a startup slot anymore */
+    if (s->startup_state == NGLI_MEDIA_STARTUP_PENDING) {
+        int ret = ngli_media_scheduler_start(ctx->media_scheduler, node, 1);
+        if (ret < 0)
+            return ret;
+    }
 
     TRACE("get frame from %s at t=%g", node->label, media_time);
+    const int64_t request_time = ngli_gettime_relative();
     struct sxplayer_frame *frame = sxplayer_get_frame(s->player, media_time);
+    int ret = ngli_media_scheduler_register_frame(ctx->media_scheduler, node,
+                                                  request_time, ngli_gettime_relative());
+    if (ret < 0) {
+        sxplayer_release_frame(frame);
+        s->frame = NULL;
+        return ret;
+    }
     if (frame) {
         const char *pix_fmt_str = frame->pix_fmt >= 0 &&
                                   frame->pix_fmt < NGLI_ARRAY_NB(pix_fmt_names) ? pix_fmt_names[frame->pix_fmt]
@@ -317,9 +425,12 @@ static int media_update(struct ngl_node *node, double t)
 
 static void media_release(struct ngl_node *node)
 {
+    struct ngl_ctx *ctx = node->ctx;
     struct media_priv *s = node->priv_data;
     sxplayer_release_frame(s->frame);
     s->frame = NULL;
+    s->cached_image = NULL;
+    ngli_media_scheduler_cancel(ctx->media_scheduler, node);
     sxplayer_stop(s->player);
 }
 
@@ -351,5 +462,6 @@ const struct node_class ngli_media_class = {
     .opts_size = sizeof(struct media_opts),
     .priv_size = sizeof(struct media_priv),
     .params    = media_params,
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -147,6 +147,7 @@ const struct node_class ngli_noise##type##_class = {                        \
     .priv_size = sizeof(struct noise_priv),                                 \
     .params    = noise_params,                                              \
     .params_id = "Noise",                                                   \
+    .flags     = NGLI_NODE_FLAG_PARALLEL_UPDATE | NGLI_NODE_FLAG_TIME_DEPENDENT, \
     .file      = __FILE__,                                                  \
 };
 
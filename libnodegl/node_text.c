@@ -26,6 +26,7 @@
 #include "internal.h"
 #include "darray.h"
 #include "drawutils.h"
+#include "font_atlas.h"
 #include "gpu_ctx.h"
 #include "log.h"
 #include "math_utils.h"
@@ -40,24 +41,51 @@
 #define VERTEX_USAGE_FLAGS (NGLI_BUFFER_USAGE_TRANSFER_DST_BIT | \
                             NGLI_BUFFER_USAGE_VERTEX_BUFFER_BIT) \
 
-#define INDEX_USAGE_FLAGS (NGLI_BUFFER_USAGE_TRANSFER_DST_BIT | \
-                           NGLI_BUFFER_USAGE_INDEX_BUFFER_BIT)  \
-
 #define DYNAMIC_VERTEX_USAGE_FLAGS (NGLI_BUFFER_USAGE_DYNAMIC_BIT | VERTEX_USAGE_FLAGS)
-#define DYNAMIC_INDEX_USAGE_FLAGS  (NGLI_BUFFER_USAGE_DYNAMIC_BIT | INDEX_USAGE_FLAGS)
 
-struct pipeline_subdesc {
+/* Initial number of quads the quads buffer can hold */
+#define MIN_QUADS_CAPACITY 16
+
+/*
+ * A quad is either the background box or a character. All the quads of a
+ * text are drawn with a single draw call, one instance per quad, the
+ * background being the first one so the characters are blended onto it.
+ */
+struct text_quad {
+    float corner[4]; /* w is 1 for the background and 0 for the characters */
+    float width[3];
+    float height[3];
+    float uvrect[4];
+};
+
+/*
+ * Without instanced drawing, every quad is expanded into the 2 triangles
+ * composing it, each vertex carrying its own copy of the quad
+ */
+struct text_vertex {
+    struct text_quad quad;
+    float quad_coord[2];
+};
+
+#define NB_QUAD_VERTICES 6
+
+/* quad_coord followed by the 4 fields of the quads */
+#define NB_ATTRIBUTES 5
+
+static const float quad_coords[NB_QUAD_VERTICES][2] = {
+    {0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f},
+    {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f},
+};
+
+struct pipeline_desc {
     struct pgcraft *crafter;
     struct pipeline_compat *pipeline_compat;
     int modelview_matrix_index;
     int projection_matrix_index;
-    int color_index;
-    int opacity_index;
-};
-
-struct pipeline_desc {
-    struct pipeline_subdesc bg; /* Background (bounding box) */
-    struct pipeline_subdesc fg; /* Foreground (characters) */
+    int fg_color_index;
+    int fg_opacity_index;
+    int bg_color_index;
+    int bg_opacity_index;
 };
 
 struct text_opts {
@@ -76,12 +104,14 @@ struct text_opts {
 };
 
 struct text_priv {
-    struct buffer *vertices;
-    struct buffer *uvcoords;
-    struct buffer *indices;
-    int nb_indices;
-
-    struct buffer *bg_vertices;
+    int instanced;
+    int quad_size;        /* size of the data of a quad in the quads buffer */
+    int quads_capacity;   /* number of quads the quads buffer can hold */
+    int nb_quads;         /* number of quads to draw */
+    int nb_uploaded;      /* number of quads whose data is uploaded */
+    uint8_t *quads_data;  /* CPU copy of the quads buffer */
+    struct buffer *quads;
+    struct buffer *quad_coords; /* unit quad, only used with instanced drawing */
 
     struct darray pipeline_descs;
     int live_changed;
@@ -165,41 +195,39 @@ static const struct node_param text_params[] = {
     {NULL}
 };
 
-static const char * const bg_vertex_data =
-    "void main()"                                                                       "\n"
-    "{"                                                                                 "\n"
-    "    ngl_out_pos = projection_matrix * modelview_matrix * vec4(position, 1.0);"     "\n"
-    "}";
-
-static const char * const bg_fragment_data =
-    "void main()"                                                                       "\n"
-    "{"                                                                                 "\n"
-    "    ngl_out_color = vec4(color, 1.0) * opacity;"                                   "\n"
-    "}";
-
 static const char * const vertex_data =
     "void main()"                                                                       "\n"
     "{"                                                                                 "\n"
+    "    vec3 position = corner.xyz + width * quad_coord.x + height * quad_coord.y;"    "\n"
     "    ngl_out_pos = projection_matrix * modelview_matrix * vec4(position, 1.0);"     "\n"
-    "    var_tex_coord = uvcoord;"                                                      "\n"
+    "    var_tex_coord = mix(uvrect.xy, uvrect.zw, quad_coord);"                        "\n"
+    "    var_bg = corner.w;"                                                            "\n"
     "}";
 
+/*
+ * The atlas contains the distance to the glyph edges (at 0.5), which is
+ * turned into a coverage antialiased over about one pixel whatever the scale
+ */
 static const char * const fragment_data =
     "void main()"                                                                       "\n"
     "{"                                                                                 "\n"
-    "    float v = ngl_tex2d(tex, var_tex_coord).r;"                                    "\n"
-    "    ngl_out_color = vec4(color, 1.0) * opacity * v;"                               "\n"
+    "    float dist = ngl_tex2d(tex, var_tex_coord).r;"                                 "\n"
+    "    float aa = max(fwidth(dist) * 0.5, 0.001);"                                    "\n"
+    "    float v = smoothstep(0.5 - aa, 0.5 + aa, dist);"                               "\n"
+    "    vec4 fg = vec4(fg_color, 1.0) * fg_opacity * v;"                               "\n"
+    "    vec4 bg = vec4(bg_color, 1.0) * bg_opacity;"                                   "\n"
+    "    ngl_out_color = mix(fg, bg, var_bg);"                                          "\n"
     "}";
 
 static const struct pgcraft_iovar vert_out_vars[] = {
     {.name = "var_tex_coord", .type = NGLI_TYPE_VEC2},
+    {.name = "var_bg",        .type = NGLI_TYPE_FLOAT},
 };
 
 #define BC(index) o->box_corner[index]
 #define BW(index) o->box_width[index]
 #define BH(index) o->box_height[index]
 
-#define C(index) chr_corner[index]
 #define W(index) chr_width[index]
 #define H(index) chr_height[index]
 
@@ -223,196 +251,241 @@ static void get_char_box_dim(const char *s, int *wp, int *hp, int *np)
     *np = n;
 }
 
-static int update_character_geometries(struct ngl_node *node)
+static int reserve_quads(struct ngl_node *node, int nb_quads)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
     struct text_priv *s = node->priv_data;
-    struct text_opts *o = node->opts;
-
-    int ret = 0;
-    const char *str = o->live.val.s;
 
-    int text_cols, text_rows, text_nbchr;
-    get_char_box_dim(str, &text_cols, &text_rows, &text_nbchr);
-    if (!text_nbchr) {
-        ngli_buffer_freep(&s->vertices);
-        ngli_buffer_freep(&s->uvcoords);
-        ngli_buffer_freep(&s->indices);
-        s->nb_indices = 0;
+    if (nb_quads <= s->quads_capacity)
         return 0;
-    }
 
-    const int nb_vertices = text_nbchr * 4;
-    const int nb_uvcoords = text_nbchr * 4;
-    const int nb_indices  = text_nbchr * 6;
-    float *vertices = ngli_calloc(nb_vertices, 3 * sizeof(*vertices));
-    float *uvcoords = ngli_calloc(nb_uvcoords, 2 * sizeof(*uvcoords));
-    short *indices  = ngli_calloc(nb_indices, sizeof(*indices));
-    if (!vertices || !uvcoords || !indices) {
-        ret = NGL_ERROR_MEMORY;
-        goto end;
+    const int capacity = NGLI_MAX(nb_quads, NGLI_MAX(s->quads_capacity * 2, MIN_QUADS_CAPACITY));
+    uint8_t *quads_data = ngli_realloc(s->quads_data, capacity * s->quad_size);
+    if (!quads_data)
+        return NGL_ERROR_MEMORY;
+    s->quads_data = quads_data;
+
+    struct buffer *quads = ngli_buffer_create(gpu_ctx);
+    if (!quads)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_buffer_init(quads, capacity * s->quad_size, DYNAMIC_VERTEX_USAGE_FLAGS);
+    if (ret < 0) {
+        ngli_buffer_freep(&quads);
+        return ret;
     }
 
-    /* Text/Box ratio */
-    const float box_width_len  = ngli_vec3_length(o->box_width);
-    const float box_height_len = ngli_vec3_length(o->box_height);
-    static const int default_ar[2] = {1, 1};
-    const int *ar = o->aspect_ratio[1] ? o->aspect_ratio : default_ar;
-    const float box_ratio = ar[0] * box_width_len / (float)(ar[1] * box_height_len);
-
-    const int text_width   = text_cols * NGLI_FONT_W + 2 * o->padding;
-    const int text_height  = text_rows * NGLI_FONT_H + 2 * o->padding;
-    const float text_ratio = text_width / (float)(text_height);
-
-    float ratio_w, ratio_h;
-    if (text_ratio < box_ratio) {
-        ratio_w = text_ratio / box_ratio;
-        ratio_h = 1.0;
-    } else {
-        ratio_w = 1.0;
-        ratio_h = box_ratio / text_ratio;
+    /* The new buffer content is undefined so every quad has to be uploaded again */
+    ngli_buffer_freep(&s->quads);
+    s->quads = quads;
+    s->quads_capacity = capacity;
+    s->nb_uploaded = 0;
+
+    /* With instanced drawing, the first attribute is the unit quad */
+    const int start = s->instanced ? 1 : 0;
+    struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
+    const int nb_descs = ngli_darray_count(&s->pipeline_descs);
+    for (int i = 0; i < nb_descs; i++) {
+        struct pipeline_desc *desc = &descs[i];
+        for (int j = start; j < NB_ATTRIBUTES; j++)
+            ngli_pipeline_compat_update_attribute(desc->pipeline_compat, j, s->quads);
     }
 
-    /* Apply aspect ratio and font scaling */
-    float width[3];
-    float height[3];
-    ngli_vec3_scale(width, o->box_width, ratio_w * o->font_scale);
-    ngli_vec3_scale(height, o->box_height, ratio_h * o->font_scale);
-
-    /* User padding */
-    float padw[3];
-    float padh[3];
-    ngli_vec3_scale(padw, width,  o->padding / (float)text_width);
-    ngli_vec3_scale(padh, height, o->padding / (float)text_height);
-
-    /* Width and height of 1 character */
-    const float chr_width[3] = {
-        (width[0] - 2 * padw[0]) / (float)text_cols,
-        (width[1] - 2 * padw[1]) / (float)text_cols,
-        (width[2] - 2 * padw[2]) / (float)text_cols,
-    };
-    const float chr_height[3] = {
-        (height[0] - 2 * padh[0]) / (float)text_rows,
-        (height[1] - 2 * padh[1]) / (float)text_rows,
-        (height[2] - 2 * padh[2]) / (float)text_rows,
-    };
+    return 0;
+}
 
-    /* Adjust text position according to alignment settings */
-    const float align_padw[3] = NGLI_VEC3_SUB(o->box_width, width);
-    const float align_padh[3] = NGLI_VEC3_SUB(o->box_height, height);
-
-    const float spx = (o->halign == HALIGN_CENTER ? .5f :
-                       o->halign == HALIGN_RIGHT  ? 1.f :
-                       0.f);
-    const float spy = (o->valign == VALIGN_CENTER ? .5f :
-                       o->valign == VALIGN_TOP    ? 1.f :
-                       0.f);
-
-    float corner[3] = {
-        BC(0) + align_padw[0] * spx + align_padh[0] * spy + padw[0] + padh[0],
-        BC(1) + align_padw[1] * spx + align_padh[1] * spy + padw[1] + padh[1],
-        BC(2) + align_padw[2] * spx + align_padh[2] * spy + padw[2] + padh[2],
-    };
+/*
+ * Write the data of a quad in the CPU copy of the quads buffer, and return
+ * whether it differs from what has been uploaded previously
+ */
+static int set_quad(struct text_priv *s, int index, const struct text_quad *quad)
+{
+    uint8_t *dst = s->quads_data + index * s->quad_size;
 
-    int px = 0, py = 0;
-    int n = 0;
+    if (s->instanced) {
+        if (index < s->nb_uploaded && !memcmp(dst, quad, sizeof(*quad)))
+            return 0;
+        memcpy(dst, quad, sizeof(*quad));
+        return 1;
+    }
 
-    for (int i = 0; str[i]; i++) {
-        if (str[i] == '\n') {
-            py++;
-            px = 0;
-            continue;
-        }
+    struct text_vertex *vertices = (struct text_vertex *)dst;
+    if (index < s->nb_uploaded && !memcmp(&vertices[0].quad, quad, sizeof(*quad)))
+        return 0;
+    for (int i = 0; i < NB_QUAD_VERTICES; i++) {
+        vertices[i].quad = *quad;
+        memcpy(vertices[i].quad_coord, quad_coords[i], sizeof(quad_coords[i]));
+    }
+    return 1;
+}
 
-        /* quad vertices */
-        const float chr_corner[3] = {
-            corner[0] + chr_width[0] * px + chr_height[0] * (text_rows - py - 1),
-            corner[1] + chr_width[1] * px + chr_height[1] * (text_rows - py - 1),
-            corner[2] + chr_width[2] * px + chr_height[2] * (text_rows - py - 1),
-        };
-        const float chr_vertices[] = {
-            C(0),               C(1),               C(2),
-            C(0) + W(0),        C(1) + W(1),        C(2) + W(2),
-            C(0) + H(0),        C(1) + H(1),        C(2) + H(2),
-            C(0) + H(0) + W(0), C(1) + H(1) + W(1), C(2) + H(2) + W(2),
-        };
-        memcpy(vertices + 4 * 3 * n, chr_vertices, sizeof(chr_vertices));
+static int update_character_geometries(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct text_priv *s = node->priv_data;
+    struct text_opts *o = node->opts;
 
-        /* focus uvcoords on the character in the atlas texture */
-        ngli_drawutils_get_atlas_uvcoords(str[i], uvcoords + 4 * 2 * n);
+    const char *str = o->live.val.s;
+
+    int text_cols, text_rows, text_nbchr;
+    get_char_box_dim(str, &text_cols, &text_rows, &text_nbchr);
+
+    /* The background box is always the first quad */
+    const int nb_quads = 1 + text_nbchr;
+    int ret = reserve_quads(node, nb_quads);
+    if (ret < 0)
+        return ret;
 
-        /* quad for each character is made of 2 triangles */
-        const short chr_indices[] = { n*4 + 0, n*4 + 1, n*4 + 2, n*4 + 1, n*4 + 3, n*4 + 2 };
-        memcpy(indices + n * NGLI_ARRAY_NB(chr_indices), chr_indices, sizeof(chr_indices));
+    /* Range of the quads to upload */
+    int upload_start = nb_quads;
+    int upload_end = 0;
 
-        n++;
-        px++;
+    const struct text_quad bg_quad = {
+        .corner = {BC(0), BC(1), BC(2), 1.f},
+        .width  = {BW(0), BW(1), BW(2)},
+        .height = {BH(0), BH(1), BH(2)},
+    };
+    if (set_quad(s, 0, &bg_quad)) {
+        upload_start = 0;
+        upload_end = 1;
     }
 
-    if (nb_indices > s->nb_indices) { // need re-alloc
-        ngli_buffer_freep(&s->vertices);
-        ngli_buffer_freep(&s->uvcoords);
-        ngli_buffer_freep(&s->indices);
-
-        s->vertices = ngli_buffer_create(gpu_ctx);
-        s->uvcoords = ngli_buffer_create(gpu_ctx);
-        s->indices  = ngli_buffer_create(gpu_ctx);
-        if (!s->vertices || !s->uvcoords || !s->indices) {
-            ret = NGL_ERROR_MEMORY;
-            goto end;
+    if (text_nbchr) {
+        /* Text/Box ratio */
+        const float box_width_len  = ngli_vec3_length(o->box_width);
+        const float box_height_len = ngli_vec3_length(o->box_height);
+        static const int default_ar[2] = {1, 1};
+        const int *ar = o->aspect_ratio[1] ? o->aspect_ratio : default_ar;
+        const float box_ratio = ar[0] * box_width_len / (float)(ar[1] * box_height_len);
+
+        const int text_width   = text_cols * NGLI_FONT_W + 2 * o->padding;
+        const int text_height  = text_rows * NGLI_FONT_H + 2 * o->padding;
+        const float text_ratio = text_width / (float)(text_height);
+
+        float ratio_w, ratio_h;
+        if (text_ratio < box_ratio) {
+            ratio_w = text_ratio / box_ratio;
+            ratio_h = 1.0;
+        } else {
+            ratio_w = 1.0;
+            ratio_h = box_ratio / text_ratio;
         }
 
-        if ((ret = ngli_buffer_init(s->vertices, nb_vertices * 3 * sizeof(*vertices), DYNAMIC_VERTEX_USAGE_FLAGS)) < 0 ||
-            (ret = ngli_buffer_init(s->uvcoords, nb_uvcoords * 2 * sizeof(*uvcoords), DYNAMIC_VERTEX_USAGE_FLAGS)) < 0 ||
-            (ret = ngli_buffer_init(s->indices,  nb_indices  * sizeof(*indices),  DYNAMIC_INDEX_USAGE_FLAGS)) < 0)
-            goto end;
+        /* Apply aspect ratio and font scaling */
+        float width[3];
+        float height[3];
+        ngli_vec3_scale(width, o->box_width, ratio_w * o->font_scale);
+        ngli_vec3_scale(height, o->box_height, ratio_h * o->font_scale);
+
+        /* User padding */
+        float padw[3];
+        float padh[3];
+        ngli_vec3_scale(padw, width,  o->padding / (float)text_width);
+        ngli_vec3_scale(padh, height, o->padding / (float)text_height);
+
+        /* Width and height of 1 character */
+        const float chr_width[3] = {
+            (width[0] - 2 * padw[0]) / (float)text_cols,
+            (width[1] - 2 * padw[1]) / (float)text_cols,
+            (width[2] - 2 * padw[2]) / (float)text_cols,
+        };
+        const float chr_height[3] = {
+            (height[0] - 2 * padh[0]) / (float)text_rows,
+            (height[1] - 2 * padh[1]) / (float)text_rows,
+            (height[2] - 2 * padh[2]) / (float)text_rows,
+        };
 
-        struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
-        const int nb_descs = ngli_darray_count(&s->pipeline_descs);
-        for (int i = 0; i < nb_descs; i++) {
-            struct pipeline_subdesc *desc = &descs[i].fg;
+        /* Adjust text position according to alignment settings */
+        const float align_padw[3] = NGLI_VEC3_SUB(o->box_width, width);
+        const float align_padh[3] = NGLI_VEC3_SUB(o->box_height, height);
+
+        const float spx = (o->halign == HALIGN_CENTER ? .5f :
+                           o->halign == HALIGN_RIGHT  ? 1.f :
+                           0.f);
+        const float spy = (o->valign == VALIGN_CENTER ? .5f :
+                           o->valign == VALIGN_TOP    ? 1.f :
+                           0.f);
+
+        float corner[3] = {
+            BC(0) + align_padw[0] * spx + align_padh[0] * spy + padw[0] + padh[0],
+            BC(1) + align_padw[1] * spx + align_padh[1] * spy + padw[1] + padh[1],
+            BC(2) + align_padw[2] * spx + align_padh[2] * spy + padw[2] + padh[2],
+        };
+
+        int px = 0, py = 0;
+        int n = 1;
+
+        for (int i = 0; str[i]; i++) {
+            if (str[i] == '\n') {
+                py++;
+                px = 0;
+                continue;
+            }
+
+            struct text_quad quad = {
+                .corner = {
+                    corner[0] + W(0) * px + H(0) * (text_rows - py - 1),
+                    corner[1] + W(1) * px + H(1) * (text_rows - py - 1),
+                    corner[2] + W(2) * px + H(2) * (text_rows - py - 1),
+                    0.f,
+                },
+                .width  = {W(0), W(1), W(2)},
+                .height = {H(0), H(1), H(2)},
+            };
+
+            /* focus uvcoords on the character in the atlas texture */
+            ngli_font_atlas_get_glyph(ctx->font_atlas, str[i], quad.uvrect);
+
+            if (set_quad(s, n, &quad)) {
+                upload_start = NGLI_MIN(upload_start, n);
+                upload_end = NGLI_MAX(upload_end, n + 1);
+            }
 
-            ngli_pipeline_compat_update_attribute(desc->pipeline_compat, 0, s->vertices);
-            ngli_pipeline_compat_update_attribute(desc->pipeline_compat, 1, s->uvcoords);
+            n++;
+            px++;
         }
     }
 
-    if ((ret = ngli_buffer_upload(s->vertices, vertices, nb_vertices * 3 * sizeof(*vertices), 0)) < 0 ||
-        (ret = ngli_buffer_upload(s->uvcoords, uvcoords, nb_uvcoords * 2 * sizeof(*uvcoords), 0)) < 0 ||
-        (ret = ngli_buffer_upload(s->indices, indices, nb_indices * sizeof(*indices), 0)) < 0)
-        goto end;
+    /* Only the quads that changed are uploaded, typically a few characters of a live text */
+    if (upload_end > upload_start) {
+        const int offset = upload_start * s->quad_size;
+        const int size = (upload_end - upload_start) * s->quad_size;
+        ret = ngli_buffer_upload(s->quads, s->quads_data + offset, size, offset);
+        if (ret < 0)
+            return ret;
+    }
 
-    s->nb_indices = nb_indices;
+    ret = ngli_font_atlas_upload(ctx->font_atlas);
+    if (ret < 0)
+        return ret;
 
-end:
-    ngli_free(vertices);
-    ngli_free(uvcoords);
-    ngli_free(indices);
-    return ret;
+    s->nb_quads = nb_quads;
+    s->nb_uploaded = NGLI_MAX(s->nb_uploaded, nb_quads);
+    return 0;
 }
 
-static int init_bounding_box_geometry(struct ngl_node *node)
+static int init_quad_coords(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
     struct text_priv *s = node->priv_data;
-    const struct text_opts *o = node->opts;
 
-    const float vertices[] = {
-        BC(0),                 BC(1),                 BC(2),
-        BC(0) + BW(0),         BC(1) + BW(1),         BC(2) + BW(2),
-        BC(0) + BH(0),         BC(1) + BH(1),         BC(2) + BH(2),
-        BC(0) + BH(0) + BW(0), BC(1) + BH(1) + BW(1), BC(2) + BH(2) + BW(2),
+    /* Unit quad drawn as a triangle strip */
+    static const float coords[] = {
+        0.f, 0.f,
+        1.f, 0.f,
+        0.f, 1.f,
+        1.f, 1.f,
     };
 
-    s->bg_vertices = ngli_buffer_create(gpu_ctx);
-    if (!s->bg_vertices)
+    s->quad_coords = ngli_buffer_create(gpu_ctx);
+    if (!s->quad_coords)
         return NGL_ERROR_MEMORY;
 
     int ret;
-    if ((ret = ngli_buffer_init(s->bg_vertices, sizeof(vertices), VERTEX_USAGE_FLAGS)) < 0 ||
-        (ret = ngli_buffer_upload(s->bg_vertices, vertices, sizeof(vertices), 0)) < 0)
+    if ((ret = ngli_buffer_init(s->quad_coords, sizeof(coords), VERTEX_USAGE_FLAGS)) < 0 ||
+        (ret = ngli_buffer_upload(s->quad_coords, coords, sizeof(coords), 0)) < 0)
         return ret;
 
     return 0;
@@ -426,45 +499,24 @@ static int atlas_create(struct ngl_node *node)
     if (ctx->font_atlas)
         return 0;
 
-    struct canvas canvas = {0};
-    int ret = ngli_drawutils_get_font_atlas(&canvas);
-    if (ret < 0)
-        goto end;
-
-    struct texture_params tex_params = {
-        .type          = NGLI_TEXTURE_TYPE_2D,
-        .width         = canvas.w,
-        .height        = canvas.h,
-        .format        = NGLI_FORMAT_R8_UNORM,
-        .min_filter    = NGLI_FILTER_LINEAR,
-        .mag_filter    = NGLI_FILTER_NEAREST,
-        .mipmap_filter = NGLI_MIPMAP_FILTER_LINEAR,
-        .usage         = NGLI_TEXTURE_USAGE_TRANSFER_SRC_BIT
-                       | NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT
-                       | NGLI_TEXTURE_USAGE_SAMPLED_BIT,
-    };
+    struct font_atlas *font_atlas = ngli_font_atlas_create(gpu_ctx);
+    if (!font_atlas)
+        return NGL_ERROR_MEMORY;
 
-    ctx->font_atlas = ngli_texture_create(gpu_ctx); // freed at context reconfiguration/destruction
-    if (!ctx->font_atlas) {
-        ret = NGL_ERROR_MEMORY;
-        goto end;
+    int ret = ngli_font_atlas_init(font_atlas);
+    if (ret < 0) {
+        ngli_font_atlas_freep(&font_atlas);
+        return ret;
     }
 
-    ret = ngli_texture_init(ctx->font_atlas, &tex_params);
-    if (ret < 0)
-        goto end;
-
-    ret = ngli_texture_upload(ctx->font_atlas, canvas.buf, 0);
-    if (ret < 0)
-        goto end;
-
-end:
-    ngli_free(canvas.buf);
-    return ret;
+    ctx->font_atlas = font_atlas; // freed at context reconfiguration/destruction
+    return 0;
 }
 
 static int text_init(struct ngl_node *node)
 {
+    struct ngl_ctx *ctx = node->ctx;
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
     struct text_priv *s = node->priv_data;
 
     int ret = atlas_create(node);
@@ -473,9 +525,14 @@ static int text_init(struct ngl_node *node)
 
     ngli_darray_init(&s->pipeline_descs, sizeof(struct pipeline_desc), 0);
 
-    ret = init_bounding_box_geometry(node);
-    if (ret < 0)
-        return ret;
+    s->instanced = (gpu_ctx->features & NGLI_FEATURE_INSTANCED_DRAW) != 0;
+    s->quad_size = s->instanced ? sizeof(struct text_quad) : NB_QUAD_VERTICES * sizeof(struct text_vertex);
+
+    if (s->instanced) {
+        ret = init_quad_coords(node);
+        if (ret < 0)
+            return ret;
+    }
 
     ret = update_character_geometries(node);
     if (ret < 0)
@@ -484,116 +541,21 @@ static int text_init(struct ngl_node *node)
     return 0;
 }
 
-static int init_subdesc(struct ngl_node *node,
-                        struct pipeline_subdesc *desc,
-                        struct pipeline_params *pipeline_params,
-                        const struct pgcraft_params *crafter_params)
+static int text_prepare(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
-
-    desc->crafter = ngli_pgcraft_create(ctx);
-    if (!desc->crafter)
-        return NGL_ERROR_MEMORY;
-
-    int ret = ngli_pgcraft_craft(desc->crafter, crafter_params);
-    if (ret < 0)
-        return ret;
-
-    desc->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
-    if (!desc->pipeline_compat)
-        return NGL_ERROR_MEMORY;
-
-    pipeline_params->program = ngli_pgcraft_get_program(desc->crafter);
-    pipeline_params->layout = ngli_pgcraft_get_pipeline_layout(desc->crafter);
-
-    const struct pipeline_resources pipeline_resources = ngli_pgcraft_get_pipeline_resources(desc->crafter);
-    const struct pgcraft_compat_info *compat_info = ngli_pgcraft_get_compat_info(desc->crafter);
-
-    const struct pipeline_compat_params params = {
-        .params = pipeline_params,
-        .resources = &pipeline_resources,
-        .compat_info = compat_info,
-    };
-
-    ret = ngli_pipeline_compat_init(desc->pipeline_compat, &params);
-    if (ret < 0)
-        return ret;
-
-    desc->modelview_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "modelview_matrix", NGLI_PROGRAM_SHADER_VERT);
-    desc->projection_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "projection_matrix", NGLI_PROGRAM_SHADER_VERT);
-    desc->color_index = ngli_pgcraft_get_uniform_index(desc->crafter, "color", NGLI_PROGRAM_SHADER_FRAG);
-    desc->opacity_index = ngli_pgcraft_get_uniform_index(desc->crafter, "opacity", NGLI_PROGRAM_SHADER_FRAG);
-
-    return 0;
-}
-
-static int bg_prepare(struct ngl_node *node, struct pipeline_subdesc *desc)
-{
-    struct ngl_ctx *ctx = node->ctx;
     struct rnode *rnode = ctx->rnode_pos;
     struct text_priv *s = node->priv_data;
     const struct text_opts *o = node->opts;
 
     const struct pgcraft_uniform uniforms[] = {
-        {.name = "modelview_matrix",  .type = NGLI_TYPE_MAT4, .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
-        {.name = "projection_matrix", .type = NGLI_TYPE_MAT4, .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
-        {.name = "color",             .type = NGLI_TYPE_VEC3, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = o->bg_color},
-        {.name = "opacity",           .type = NGLI_TYPE_FLOAT, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = &o->bg_opacity},
-    };
-
-    const struct pgcraft_attribute attributes[] = {
-        {
-            .name     = "position",
-            .type     = NGLI_TYPE_VEC3,
-            .format   = NGLI_FORMAT_R32G32B32_SFLOAT,
-            .stride   = 3 * 4,
-            .buffer   = s->bg_vertices,
-        },
-    };
-
-    /* This controls how the background blends onto the current framebuffer */
-    struct graphicstate state = rnode->graphicstate;
-    state.blend = 1;
-    state.blend_src_factor   = NGLI_BLEND_FACTOR_ONE;
-    state.blend_dst_factor   = NGLI_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    state.blend_src_factor_a = NGLI_BLEND_FACTOR_ONE;
-    state.blend_dst_factor_a = NGLI_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-
-    struct pipeline_params pipeline_params = {
-        .type          = NGLI_PIPELINE_TYPE_GRAPHICS,
-        .graphics      = {
-            .topology       = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
-            .state          = state,
-            .rt_desc        = rnode->rendertarget_desc,
-        }
-    };
-
-    const struct pgcraft_params crafter_params = {
-        .program_label    = "nodegl/text-bg",
-        .vert_base        = bg_vertex_data,
-        .frag_base        = bg_fragment_data,
-        .uniforms         = uniforms,
-        .nb_uniforms      = NGLI_ARRAY_NB(uniforms),
-        .attributes       = attributes,
-        .nb_attributes    = NGLI_ARRAY_NB(attributes),
-    };
-
-    return init_subdesc(node, desc, &pipeline_params, &crafter_params);
-}
-
-static int fg_prepare(struct ngl_node *node, struct pipeline_subdesc *desc)
-{
-    struct ngl_ctx *ctx = node->ctx;
-    struct rnode *rnode = ctx->rnode_pos;
-    struct text_priv *s = node->priv_data;
-    const struct text_opts *o = node->opts;
-
-    const struct pgcraft_uniform uniforms[] = {
-        {.name = "modelview_matrix",  .type = NGLI_TYPE_MAT4, .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
-        {.name = "projection_matrix", .type = NGLI_TYPE_MAT4, .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
-        {.name = "color",             .type = NGLI_TYPE_VEC3, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = o->fg_color},
-        {.name = "opacity",           .type = NGLI_TYPE_FLOAT, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = &o->fg_opacity},
+        {.name = "modelview_matrix",  .type = NGLI_TYPE_MAT4,  .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
+        {.name = "projection_matrix", .type = NGLI_TYPE_MAT4,  .stage = NGLI_PROGRAM_SHADER_VERT, .data = NULL},
+        {.name = "fg_color",          .type = NGLI_TYPE_VEC3,  .stage = NGLI_PROGRAM_SHADER_FRAG, .data = o->fg_color},
+        {.name = "fg_opacity",        .type = NGLI_TYPE_FLOAT, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = &o->fg_opacity},
+        {.name = "bg_color",          .type = NGLI_TYPE_VEC3,  .stage = NGLI_PROGRAM_SHADER_FRAG, .data = o->bg_color},
+        {.name = "bg_opacity",        .type = NGLI_TYPE_FLOAT, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = &o->bg_opacity},
     };
 
     const struct pgcraft_texture textures[] = {
@@ -601,28 +563,60 @@ static int fg_prepare(struct ngl_node *node, struct pipeline_subdesc *desc)
             .name     = "tex",
             .type     = NGLI_PGCRAFT_SHADER_TEX_TYPE_2D,
             .stage    = NGLI_PROGRAM_SHADER_FRAG,
-            .texture  = ctx->font_atlas,
+            .texture  = ngli_font_atlas_get_texture(ctx->font_atlas),
         },
     };
 
+    /*
+     * With instanced drawing, the quads are instances of the unit quad,
+     * otherwise the quads buffer contains the vertices of every quad
+     */
+    const int rate = s->instanced ? 1 : 0;
+    const int stride = s->instanced ? sizeof(struct text_quad) : sizeof(struct text_vertex);
     const struct pgcraft_attribute attributes[] = {
         {
-            .name     = "position",
-            .type     = NGLI_TYPE_VEC3,
-            .format   = NGLI_FORMAT_R32G32B32_SFLOAT,
-            .stride   = 3 * 4,
-            .buffer   = s->vertices,
-        },
-        {
-            .name     = "uvcoord",
+            .name     = "quad_coord",
             .type     = NGLI_TYPE_VEC2,
             .format   = NGLI_FORMAT_R32G32_SFLOAT,
-            .stride   = 2 * 4,
-            .buffer   = s->uvcoords,
+            .stride   = s->instanced ? 2 * 4 : stride,
+            .offset   = s->instanced ? 0 : offsetof(struct text_vertex, quad_coord),
+            .buffer   = s->instanced ? s->quad_coords : s->quads,
+        }, {
+            .name     = "corner",
+            .type     = NGLI_TYPE_VEC4,
+            .format   = NGLI_FORMAT_R32G32B32A32_SFLOAT,
+            .stride   = stride,
+            .offset   = offsetof(struct text_quad, corner),
+            .rate     = rate,
+            .buffer   = s->quads,
+        }, {
+            .name     = "width",
+            .type     = NGLI_TYPE_VEC3,
+            .format   = NGLI_FORMAT_R32G32B32_SFLOAT,
+            .stride   = stride,
+            .offset   = offsetof(struct text_quad, width),
+            .rate     = rate,
+            .buffer   = s->quads,
+        }, {
+            .name     = "height",
+            .type     = NGLI_TYPE_VEC3,
+            .format   = NGLI_FORMAT_R32G32B32_SFLOAT,
+            .stride   = stride,
+            .offset   = offsetof(struct text_quad, height),
+            .rate     = rate,
+            .buffer   = s->quads,
+        }, {
+            .name     = "uvrect",
+            .type     = NGLI_TYPE_VEC4,
+            .format   = NGLI_FORMAT_R32G32B32A32_SFLOAT,
+            .stride   = stride,
+            .offset   = offsetof(struct text_quad, uvrect),
+            .rate     = rate,
+            .buffer   = s->quads,
         },
     };
 
-    /* This controls how the characters blend onto the background */
+    /* This controls how the background and the characters blend onto the current framebuffer */
     struct graphicstate state = rnode->graphicstate;
     state.blend = 1;
     state.blend_src_factor   = NGLI_BLEND_FACTOR_ONE;
@@ -633,14 +627,15 @@ static int fg_prepare(struct ngl_node *node, struct pipeline_subdesc *desc)
     struct pipeline_params pipeline_params = {
         .type          = NGLI_PIPELINE_TYPE_GRAPHICS,
         .graphics      = {
-            .topology       = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+            .topology       = s->instanced ? NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP
+                                           : NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
             .state          = state,
             .rt_desc        = rnode->rendertarget_desc,
         }
     };
 
     const struct pgcraft_params crafter_params = {
-        .program_label    = "nodegl/text-fg",
+        .program_label    = "nodegl/text",
         .vert_base        = vertex_data,
         .frag_base        = fragment_data,
         .uniforms         = uniforms,
@@ -653,21 +648,6 @@ static int fg_prepare(struct ngl_node *node, struct pipeline_subdesc *desc)
         .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
     };
 
-    int ret = init_subdesc(node, desc, &pipeline_params, &crafter_params);
-    if (ret < 0)
-        return ret;
-
-    ngli_assert(!strcmp("position", pipeline_params.layout.attributes_desc[0].name));
-    ngli_assert(!strcmp("uvcoord", pipeline_params.layout.attributes_desc[1].name));
-
-    return 0;
-}
-
-static int text_prepare(struct ngl_node *node)
-{
-    struct ngl_ctx *ctx = node->ctx;
-    struct text_priv *s = node->priv_data;
-
     struct pipeline_desc *desc = ngli_darray_push(&s->pipeline_descs, NULL);
     if (!desc)
         return NGL_ERROR_MEMORY;
@@ -675,14 +655,46 @@ static int text_prepare(struct ngl_node *node)
 
     memset(desc, 0, sizeof(*desc));
 
-    int ret = bg_prepare(node, &desc->bg);
+    desc->crafter = ngli_pgcraft_create(ctx);
+    if (!desc->crafter)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_pgcraft_craft(desc->crafter, &crafter_params);
     if (ret < 0)
         return ret;
 
-    ret = fg_prepare(node, &desc->fg);
+    desc->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
+    if (!desc->pipeline_compat)
+        return NGL_ERROR_MEMORY;
+
+    pipeline_params.program = ngli_pgcraft_get_program(desc->crafter);
+    pipeline_params.layout = ngli_pgcraft_get_pipeline_layout(desc->crafter);
+
+    const struct pipeline_resources pipeline_resources = ngli_pgcraft_get_pipeline_resources(desc->crafter);
+    const struct pgcraft_compat_info *compat_info = ngli_pgcraft_get_compat_info(desc->crafter);
+
+    const struct pipeline_compat_params params = {
+        .params = &pipeline_params,
+        .resources = &pipeline_resources,
+        .compat_info = compat_info,
+    };
+
+    ret = ngli_pipeline_compat_init(desc->pipeline_compat, &params);
     if (ret < 0)
         return ret;
 
+    /* The quads buffer attributes are updated by index when the buffer is reallocated */
+    ngli_assert(pipeline_params.layout.nb_attributes == NB_ATTRIBUTES);
+    ngli_assert(!strcmp("quad_coord", pipeline_params.layout.attributes_desc[0].name));
+    ngli_assert(!strcmp("uvrect", pipeline_params.layout.attributes_desc[4].name));
+
+    desc->modelview_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "modelview_matrix", NGLI_PROGRAM_SHADER_VERT);
+    desc->projection_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "projection_matrix", NGLI_PROGRAM_SHADER_VERT);
+    desc->fg_color_index = ngli_pgcraft_get_uniform_index(desc->crafter, "fg_color", NGLI_PROGRAM_SHADER_FRAG);
+    desc->fg_opacity_index = ngli_pgcraft_get_uniform_index(desc->crafter, "fg_opacity", NGLI_PROGRAM_SHADER_FRAG);
+    desc->bg_color_index = ngli_pgcraft_get_uniform_index(desc->crafter, "bg_color", NGLI_PROGRAM_SHADER_FRAG);
+    desc->bg_opacity_index = ngli_pgcraft_get_uniform_index(desc->crafter, "bg_opacity", NGLI_PROGRAM_SHADER_FRAG);
+
     return 0;
 }
 
@@ -717,21 +729,19 @@ static void text_draw(struct ngl_node *node)
         ctx->render_pass_started = 1;
     }
 
-    struct pipeline_subdesc *bg_desc = &desc->bg;
-    ngli_pipeline_compat_update_uniform(bg_desc->pipeline_compat, bg_desc->modelview_matrix_index, modelview_matrix);
-    ngli_pipeline_compat_update_uniform(bg_desc->pipeline_compat, bg_desc->projection_matrix_index, projection_matrix);
-    ngli_pipeline_compat_update_uniform(bg_desc->pipeline_compat, bg_desc->color_index, o->bg_color);
-    ngli_pipeline_compat_update_uniform(bg_desc->pipeline_compat, bg_desc->opacity_index, &o->bg_opacity);
-    ngli_pipeline_compat_draw(bg_desc->pipeline_compat, 4, 1);
-
-    if (s->nb_indices) {
-        struct pipeline_subdesc *fg_desc = &desc->fg;
-        ngli_pipeline_compat_update_uniform(fg_desc->pipeline_compat, fg_desc->modelview_matrix_index, modelview_matrix);
-        ngli_pipeline_compat_update_uniform(fg_desc->pipeline_compat, fg_desc->projection_matrix_index, projection_matrix);
-        ngli_pipeline_compat_update_uniform(fg_desc->pipeline_compat, fg_desc->color_index, o->fg_color);
-        ngli_pipeline_compat_update_uniform(fg_desc->pipeline_compat, fg_desc->opacity_index, &o->fg_opacity);
-        ngli_pipeline_compat_draw_indexed(fg_desc->pipeline_compat, s->indices, NGLI_FORMAT_R16_UNORM, s->nb_indices, 1);
-    }
+    struct pipeline_compat *pipeline_compat = desc->pipeline_compat;
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->modelview_matrix_index, modelview_matrix);
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->projection_matrix_index, projection_matrix);
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->fg_color_index, o->fg_color);
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->fg_opacity_index, &o->fg_opacity);
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->bg_color_index, o->bg_color);
+    ngli_pipeline_compat_update_uniform(pipeline_compat, desc->bg_opacity_index, &o->bg_opacity);
+
+    /* The background and the characters are drawn at once */
+    if (s->instanced)
+        ngli_pipeline_compat_draw(pipeline_compat, 4, s->nb_quads);
+    else
+        ngli_pipeline_compat_draw(pipeline_compat, s->nb_quads * NB_QUAD_VERTICES, 1);
 }
 
 static void text_uninit(struct ngl_node *node)
@@ -741,16 +751,13 @@ static void text_uninit(struct ngl_node *node)
     const int nb_descs = ngli_darray_count(&s->pipeline_descs);
     for (int i = 0; i < nb_descs; i++) {
         struct pipeline_desc *desc = &descs[i];
-        ngli_pipeline_compat_freep(&desc->bg.pipeline_compat);
-        ngli_pipeline_compat_freep(&desc->fg.pipeline_compat);
-        ngli_pgcraft_freep(&desc->bg.crafter);
-        ngli_pgcraft_freep(&desc->fg.crafter);
+        ngli_pipeline_compat_freep(&desc->pipeline_compat);
+        ngli_pgcraft_freep(&desc->crafter);
     }
     ngli_darray_reset(&s->pipeline_descs);
-    ngli_buffer_freep(&s->bg_vertices);
-    ngli_buffer_freep(&s->vertices);
-    ngli_buffer_freep(&s->uvcoords);
-    ngli_buffer_freep(&s->indices);
+    ngli_buffer_freep(&s->quads);
+    ngli_buffer_freep(&s->quad_coords);
+    ngli_freep(&s->quads_data);
 }
 
 const struct node_class ngli_text_class = {
@@ -157,6 +157,7 @@ static const struct param_choices format_choices = {
 
 
 #define DATA_SRC_TYPES_LIST_2D (const int[]){NGL_NODE_MEDIA,                   \
+                                             NGL_NODE_IMAGESEQUENCE,           \
                                              BUFFER_NODES                      \
                                              -1}
 
@@ -245,6 +246,26 @@ static const struct node_param texturecube_params[] = {
     {NULL}
 };
 
+/*
+ * The audio mapping being shared, all its users must sample it the same way.
+ * The image layouts are ignored since the audio frames are always mapped to
+ * the default layout.
+ */
+static int check_audio_hwmap_params(const struct hwmap_params *p0, const struct hwmap_params *p1)
+{
+    if (p0->texture_min_filter    != p1->texture_min_filter    ||
+        p0->texture_mag_filter    != p1->texture_mag_filter    ||
+        p0->texture_mipmap_filter != p1->texture_mipmap_filter ||
+        p0->texture_wrap_s        != p1->texture_wrap_s        ||
+        p0->texture_wrap_t        != p1->texture_wrap_t        ||
+        p0->texture_usage         != p1->texture_usage) {
+        LOG(ERROR, "textures sharing the audio of a media must have the same filtering, wrapping and usage "
+            "(%s differs from %s)", p1->label, p0->label);
+        return NGL_ERROR_INVALID_USAGE;
+    }
+    return 0;
+}
+
 static int texture_prefetch(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -267,7 +288,7 @@ static int texture_prefetch(struct ngl_node *node)
         switch (o->data_src->cls->id) {
         case NGL_NODE_MEDIA: {
             struct ngl_node *media = o->data_src;
-            ngli_unused struct media_priv *media_priv = media->priv_data;
+            struct media_priv *media_priv = media->priv_data;
             const struct hwmap_params hwmap_params = {
                 .label                 = node->label,
                 .image_layouts         = s->supported_image_layouts,
@@ -282,7 +303,36 @@ static int texture_prefetch(struct ngl_node *node)
                 .android_imagereader   = media_priv->android_imagereader,
 #endif
             };
-            return ngli_hwmap_init(&s->hwmap, ctx, &hwmap_params);
+            /* The audio frames are mapped once for all the users of the media */
+            if (media_priv->audio_tex) {
+                if (media_priv->nb_audio_users++)
+                    return check_audio_hwmap_params(&media_priv->audio_hwmap_params, &hwmap_params);
+                media_priv->audio_hwmap_params = hwmap_params;
+                return ngli_hwmap_init(&media_priv->audio_hwmap, ctx, &hwmap_params);
+            }
+
+            int ret = ngli_hwmap_init(&s->hwmap, ctx, &hwmap_params);
+            if (ret < 0)
+                return ret;
+
+            if (media_priv->frame_cache_size) {
+                media_priv->frame_cache = ngli_frame_cache_create(ctx);
+                if (!media_priv->frame_cache)
+                    return NGL_ERROR_MEMORY;
+                ret = ngli_frame_cache_init(media_priv->frame_cache, &hwmap_params, media_priv->frame_cache_size);
+                if (ret < 0)
+                    return ret;
+            }
+
+            return 0;
+        }
+        case NGL_NODE_IMAGESEQUENCE: {
+            const struct imagesequence_priv *imgseq = o->data_src->priv_data;
+            params->width = imgseq->width;
+            params->height = imgseq->height;
+            params->format = imgseq->format;
+            s->imgseq_index = -1;
+            break;
         }
         case NGL_NODE_ANIMATEDBUFFERFLOAT:
         case NGL_NODE_ANIMATEDBUFFERVEC2:
@@ -364,27 +414,76 @@ static int texture_prefetch(struct ngl_node *node)
     return 0;
 }
 
+static int handle_audio_frame(struct ngl_node *node)
+{
+    struct texture_priv *s = node->priv_data;
+    const struct texture_opts *o = node->opts;
+    struct media_priv *media = o->data_src->priv_data;
+
+    /* The first Texture updated in the frame maps it for all the others */
+    struct sxplayer_frame *frame = media->frame;
+    if (frame) {
+        media->frame = NULL;
+        ngli_image_reset(&media->audio_image);
+        int ret = ngli_hwmap_map_frame(&media->audio_hwmap, frame, &media->audio_image);
+        if (ret < 0) {
+            LOG(ERROR, "could not map audio frame");
+            return ret;
+        }
+    }
+
+    s->image = media->audio_image;
+    return 0;
+}
+
 static int handle_media_frame(struct ngl_node *node)
 {
     struct texture_priv *s = node->priv_data;
     const struct texture_opts *o = node->opts;
     struct media_priv *media = o->data_src->priv_data;
+
+    if (media->audio_tex)
+        return handle_audio_frame(node);
+
+    if (media->cached_image) {
+        s->image = *media->cached_image;
+        return 0;
+    }
+
     struct sxplayer_frame *frame = media->frame;
-    if (!frame)
+    if (!frame) {
+        /*
+         * The decoder returned the same frame as previously, which is still
+         * mapped but may have been replaced by a cached one in the meantime
+         */
+        if (media->frame_cache)
+            s->image = s->media_image;
         return 0;
+    }
 
     /* Transfer frame ownership to hwmap and ensure it cannot be re-used
      * later on */
     media->frame = NULL;
+    const double ts = frame->ts;
 
     /* Reset destination image */
     ngli_image_reset(&s->image);
+    ngli_image_reset(&s->media_image);
 
     int ret = ngli_hwmap_map_frame(&s->hwmap, frame, &s->image);
     if (ret < 0) {
         LOG(ERROR, "could not map media frame");
         return ret;
     }
+    s->media_image = s->image;
+
+    if (media->frame_cache) {
+        ret = ngli_frame_cache_add(media->frame_cache, ts, &s->image);
+        if (ret < 0) {
+            LOG(ERROR, "could not cache media frame");
+            return ret;
+        }
+    }
 
     return 0;
 }
@@ -405,6 +504,25 @@ static int handle_buffer_frame(struct ngl_node *node)
     return 0;
 }
 
+static int handle_imgseq_frame(struct ngl_node *node)
+{
+    struct texture_priv *s = node->priv_data;
+    const struct texture_opts *o = node->opts;
+    const struct imagesequence_priv *imgseq = o->data_src->priv_data;
+
+    if (imgseq->index == s->imgseq_index)
+        return 0;
+
+    int ret = ngli_texture_upload(s->texture, imgseq->data, 0);
+    if (ret < 0) {
+        LOG(ERROR, "could not upload image sequence frame");
+        return ret;
+    }
+    s->imgseq_index = imgseq->index;
+
+    return 0;
+}
+
 static int texture_update(struct ngl_node *node, double t)
 {
     const struct texture_opts *o = node->opts;
@@ -425,6 +543,11 @@ static int texture_update(struct ngl_node *node, double t)
              */
             (void)handle_media_frame(node);
             break;
+        case NGL_NODE_IMAGESEQUENCE:
+            ret = handle_imgseq_frame(node);
+            if (ret < 0)
+                return ret;
+            break;
         case NGL_NODE_ANIMATEDBUFFERFLOAT:
         case NGL_NODE_ANIMATEDBUFFERVEC2:
         case NGL_NODE_ANIMATEDBUFFERVEC4:
@@ -441,9 +564,21 @@ static void texture_release(struct ngl_node *node)
 {
     struct texture_priv *s = node->priv_data;
 
+    const struct texture_opts *o = node->opts;
+    if (o->data_src && o->data_src->cls->id == NGL_NODE_MEDIA) {
+        struct media_priv *media_priv = o->data_src->priv_data;
+        media_priv->cached_image = NULL;
+        ngli_frame_cache_freep(&media_priv->frame_cache);
+        if (media_priv->audio_tex && !--media_priv->nb_audio_users) {
+            ngli_hwmap_uninit(&media_priv->audio_hwmap);
+            ngli_image_reset(&media_priv->audio_image);
+        }
+    }
+
     ngli_hwmap_uninit(&s->hwmap);
     ngli_texture_freep(&s->texture);
     ngli_image_reset(&s->image);
+    ngli_image_reset(&s->media_image);
 }
 
 static int get_preferred_format(struct gpu_ctx *gpu_ctx, int format)
@@ -481,12 +616,13 @@ static int texture2d_init(struct ngl_node *node)
     /*
      * On Android, the frame can only be uploaded once and each subsequent
      * upload will be a noop which results in an empty texture. This limitation
-     * prevents us from sharing the Media node across multiple textures.
+     * prevents us from sharing the Media node across multiple textures. The
+     * audio frames are mapped once for all the textures, so they can be shared.
      */
     struct ngl_node *data_src = o->data_src;
     if (data_src && data_src->cls->id == NGL_NODE_MEDIA) {
         struct media_priv *media_priv = data_src->priv_data;
-        if (media_priv->nb_parents++ > 0) {
+        if (!media_priv->audio_tex && media_priv->nb_parents++ > 0) {
             LOG(ERROR, "A media node (label=%s) can not be shared, "
                 "the Texture should be shared instead", data_src->label);
             return NGL_ERROR_INVALID_USAGE;
@@ -21,12 +21,17 @@
 
 #include <float.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "darray.h"
 #include "log.h"
+#include "media_scheduler.h"
 #include "nodegl.h"
 #include "internal.h"
 #include "params.h"
+#include "ptrmap.h"
+#include "utils.h"
 
 struct timerangefilter_opts {
     struct ngl_node *child;
@@ -39,6 +44,7 @@ struct timerangefilter_opts {
 struct timerangefilter_priv {
     int current_range;
     int drawme;
+    struct darray medias; /* struct ngl_node *, Media nodes reachable from the child */
 };
 
 #define RANGES_TYPES_LIST (const int[]){NGL_NODE_TIMERANGEMODEONCE,     \
@@ -61,8 +67,31 @@ static const struct node_param timerangefilter_params[] = {
     {NULL}
 };
 
+static int collect_medias(struct ptrmap *visited, struct darray *medias, struct ngl_node *node)
+{
+    if (ngli_ptrmap_get(visited, node) >= 0)
+        return 0;
+    int ret = ngli_ptrmap_set(visited, node, 0);
+    if (ret < 0)
+        return ret;
+
+    if (node->cls->id == NGL_NODE_MEDIA && !ngli_darray_push(medias, &node))
+        return NGL_ERROR_MEMORY;
+
+    const struct darray *children_array = &node->children;
+    struct ngl_node **children = ngli_darray_data(children_array);
+    for (int i = 0; i < ngli_darray_count(children_array); i++) {
+        ret = collect_medias(visited, medias, children[i]);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 static int timerangefilter_init(struct ngl_node *node)
 {
+    struct timerangefilter_priv *s = node->priv_data;
     const struct timerangefilter_opts *o = node->opts;
 
     double prev_start_time = -DBL_MAX;
@@ -87,7 +116,37 @@ static int timerangefilter_init(struct ngl_node *node)
         return NGL_ERROR_INVALID_ARG;
     }
 
-    return 0;
+    /* The medias are started ahead of the next range according to their startup latency */
+    ngli_darray_init(&s->medias, sizeof(struct ngl_node *), 0);
+    struct ptrmap *visited = ngli_ptrmap_create(0);
+    if (!visited)
+        return NGL_ERROR_MEMORY;
+    int ret = collect_medias(visited, &s->medias, o->child);
+    ngli_ptrmap_freep(&visited);
+    return ret;
+}
+
+static double get_prefetch_time(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct timerangefilter_priv *s = node->priv_data;
+    const struct timerangefilter_opts *o = node->opts;
+
+    double prefetch_time = o->prefetch_time;
+    struct ngl_node **medias = ngli_darray_data(&s->medias);
+    for (int i = 0; i < ngli_darray_count(&s->medias); i++) {
+        const struct media_priv *media = medias[i]->priv_data;
+        const double lead_time = ngli_media_scheduler_get_lead_time(ctx->media_scheduler, media->filename);
+        prefetch_time = NGLI_MAX(prefetch_time, lead_time);
+    }
+    return prefetch_time;
+}
+
+static void set_medias_deadline(struct timerangefilter_priv *s, double t, double deadline)
+{
+    struct ngl_node **medias = ngli_darray_data(&s->medias);
+    for (int i = 0; i < ngli_darray_count(&s->medias); i++)
+        ngli_node_media_set_deadline(medias[i], t, deadline);
 }
 
 static int get_rr_id(const struct timerangefilter_opts *o, int start, double t)
@@ -160,14 +219,16 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
                     // as the current one doesn't.
                     const struct timerangemode_opts *next = o->ranges[rr_id + 1]->opts;
                     const double next_use_in = next->start_time - t;
+                    const double prefetch_time = get_prefetch_time(node);
 
-                    if (next_use_in <= o->prefetch_time) {
+                    if (next_use_in <= prefetch_time) {
                         TRACE("next use of %s in %g (< %g), mark as active",
-                              child->label, next_use_in, o->prefetch_time);
+                              child->label, next_use_in, prefetch_time);
 
                         // The node will actually be needed soon, so we need to
                         // start it if necessary.
                         is_active = 1;
+                        set_medias_deadline(s, t, next->start_time);
                     } else if (next_use_in <= o->max_idle_time && child->is_active) {
                         TRACE("%s not currently needed but will be soon %g (< %g), keep as active",
                               child->label, next_use_in, o->max_idle_time);
@@ -178,16 +239,22 @@ static int timerangefilter_visit(struct ngl_node *node, int is_active, double t)
                         // already active it's not worth releasing it to start
                         // it again soon after, so we keep it active.
                         is_active = 1;
+                        set_medias_deadline(s, t, next->start_time);
                     }
                 }
-            } else if (rr->cls->id == NGL_NODE_TIMERANGEMODEONCE) {
-                // If the child of the current once range is inactive, meaning
-                // it has been previously released, we need to force an update
-                // otherwise the child will stay uninitialized.
-                if (!child->is_active) {
-                    struct timerangemode_priv *rro = rr->priv_data;
-                    rro->updated = 0;
+            } else {
+                if (rr->cls->id == NGL_NODE_TIMERANGEMODEONCE) {
+                    // If the child of the current once range is inactive, meaning
+                    // it has been previously released, we need to force an update
+                    // otherwise the child will stay uninitialized.
+                    if (!child->is_active) {
+                        struct timerangemode_priv *rro = rr->priv_data;
+                        rro->updated = 0;
+                    }
                 }
+
+                // The child is used right away
+                set_medias_deadline(s, t, t);
             }
         }
     }
@@ -237,6 +304,12 @@ static void timerangefilter_draw(struct ngl_node *node)
     ngli_node_draw(o->child);
 }
 
+static void timerangefilter_uninit(struct ngl_node *node)
+{
+    struct timerangefilter_priv *s = node->priv_data;
+    ngli_darray_reset(&s->medias);
+}
+
 const struct node_class ngli_timerangefilter_class = {
     .id        = NGL_NODE_TIMERANGEFILTER,
     .name      = "TimeRangeFilter",
@@ -244,8 +317,10 @@ const struct node_class ngli_timerangefilter_class = {
     .visit     = timerangefilter_visit,
     .update    = timerangefilter_update,
     .draw      = timerangefilter_draw,
+    .uninit    = timerangefilter_uninit,
     .opts_size = sizeof(struct timerangefilter_opts),
     .priv_size = sizeof(struct timerangefilter_priv),
     .params    = timerangefilter_params,
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -206,6 +206,7 @@ const struct node_class ngli_velocity##type##_class = {
     .opts_size = sizeof(struct velocity_opts),                                  \
     .priv_size = sizeof(struct velocity_priv),                                  \
     .params    = velocity##type##_params,                                       \
+    .flags     = NGLI_NODE_FLAG_PARALLEL_UPDATE | NGLI_NODE_FLAG_TIME_DEPENDENT,     \
     .file      = __FILE__,                                                      \
 };
 
@@ -159,6 +159,17 @@ struct ngl_node *ngl_node_create(int type)
     return node;
 }
 
+static void node_reset_static_branch(struct ngl_node *node)
+{
+    node->static_updated = 0;
+    struct ngl_node **parents = ngli_darray_data(&node->parents);
+    for (int i = 0; i < ngli_darray_count(&node->parents); i++) {
+        /* A parent cannot be marked updated if one of its children is not */
+        if (parents[i]->static_updated)
+            node_reset_static_branch(parents[i]);
+    }
+}
+
 static void node_release(struct ngl_node *node)
 {
     if (node->state != STATE_READY)
@@ -171,6 +182,12 @@ static void node_release(struct ngl_node *node)
     }
     node->state = STATE_INITIALIZED;
     node->last_update_time = -1.;
+
+    /*
+     * The static parents may depend on resources that have just been
+     * released, so their update must be honored again
+     */
+    node_reset_static_branch(node);
 }
 
 static void node_uninit(struct ngl_node *node)
@@ -308,6 +325,12 @@ static int node_init(struct ngl_node *node)
         return ret;
     }
 
+    node->is_static = !(node->cls->flags & NGLI_NODE_FLAG_TIME_DEPENDENT);
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (int i = 0; i < ngli_darray_count(&node->children); i++)
+        node->is_static &= children[i]->is_static;
+    node->static_updated = 0;
+
     if (node->cls->prefetch)
         node->state = STATE_INITIALIZED;
     else
@@ -733,11 +756,16 @@ int ngli_node_update(struct ngl_node *node, double t)
     ngli_assert(node->state == STATE_READY);
     if (node->cls->update) {
         if (node->last_update_time != t) {
-            TRACE("UPDATE %s @ %p with t=%g", node->label, node, t);
-            int ret = node->cls->update(node, t);
-            if (ret < 0) {
-                LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
-                return ret;
+            if (node->static_updated) {
+                TRACE("%s is static and already updated, skip it", node->label);
+            } else {
+                TRACE("UPDATE %s @ %p with t=%g", node->label, node, t);
+                int ret = node->cls->update(node, t);
+                if (ret < 0) {
+                    LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
+                    return ret;
+                }
+                node->static_updated = node->is_static;
             }
             node->last_update_time = t;
             node->draw_count = 0;
@@ -835,6 +863,7 @@ int ngl_node_param_add_f64s(struct ngl_node *node, const char *key,
 static int node_invalidate_branch(struct ngl_node *node)
 {
     node->last_update_time = -1;
+    node->static_updated = 0;
     if (node->cls->invalidate) {
         int ret = node->cls->invalidate(node);
         if (ret < 0)
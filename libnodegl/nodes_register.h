@@ -90,6 +90,7 @@
     action(NGL_NODE_GRAPHICCONFIG,          ngli_graphicconfig_class)           \
     action(NGL_NODE_GROUP,                  ngli_group_class)                   \
     action(NGL_NODE_IDENTITY,               ngli_identity_class)                \
+    action(NGL_NODE_IMAGESEQUENCE,          ngli_imagesequence_class)           \
     action(NGL_NODE_IOINT,                  ngli_ioint_class)                   \
     action(NGL_NODE_IOIVEC2,                ngli_ioivec2_class)                 \
     action(NGL_NODE_IOIVEC3,                ngli_ioivec3_class)                 \
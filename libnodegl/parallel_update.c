@@ -0,0 +1,242 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal.h"
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "parallel_update.h"
+#include "ptrmap.h"
+#include "utils.h"
+
+/*
+ * Minimum number of nodes per job, to amortize the dispatch cost: a wave
+ * smaller than this is updated on the calling thread
+ */
+#define MIN_CHUNK_SIZE 16
+
+/* Number of chunks per thread, to balance the load between the threads */
+#define CHUNKS_PER_THREAD 4
+
+/* Levels of the nodes that are not part of a wave */
+#define LEVEL_SERIAL -2 /* must be updated by the serial update */
+#define LEVEL_INERT  -1 /* no update callback */
+
+/* Offset for storing the levels in the ptrmap, which only holds positive values */
+#define LEVEL_OFFSET 2
+
+struct node_level {
+    struct ngl_node *node;
+    int level;
+};
+
+static int cmp_node_level(const void *a, const void *b)
+{
+    const struct node_level *l0 = a;
+    const struct node_level *l1 = b;
+    return l0->level - l1->level;
+}
+
+static int compute_level(struct ptrmap *levels, struct darray *node_levels,
+                         struct ngl_node *node, int *levelp)
+{
+    const int cached = ngli_ptrmap_get(levels, node);
+    if (cached >= 0) {
+        *levelp = cached - LEVEL_OFFSET;
+        return 0;
+    }
+
+    const struct node_class *cls = node->cls;
+    int level = LEVEL_INERT;
+    if (cls->update)
+        level = (cls->flags & NGLI_NODE_FLAG_PARALLEL_UPDATE) && !cls->prefetch && !cls->release ? 0 : LEVEL_SERIAL;
+
+    /* All the children are explored since they may be reachable by other paths */
+    const struct darray *children_array = &node->children;
+    struct ngl_node **children = ngli_darray_data(children_array);
+    for (int i = 0; i < ngli_darray_count(children_array); i++) {
+        int child_level;
+        int ret = compute_level(levels, node_levels, children[i], &child_level);
+        if (ret < 0)
+            return ret;
+
+        if (level < 0 || child_level == LEVEL_INERT)
+            continue;
+        if (child_level == LEVEL_SERIAL)
+            level = LEVEL_SERIAL;
+        else
+            level = NGLI_MAX(level, child_level + 1);
+    }
+
+    int ret = ngli_ptrmap_set(levels, node, level + LEVEL_OFFSET);
+    if (ret < 0)
+        return ret;
+
+    if (level >= 0) {
+        const struct node_level node_level = {.node = node, .level = level};
+        if (!ngli_darray_push(node_levels, &node_level))
+            return NGL_ERROR_MEMORY;
+    }
+
+    *levelp = level;
+    return 0;
+}
+
+static int build_waves(struct parallel_update *s, struct ngl_node *scene)
+{
+    struct ptrmap *levels = ngli_ptrmap_create(0);
+    if (!levels)
+        return NGL_ERROR_MEMORY;
+
+    struct darray node_levels_array;
+    ngli_darray_init(&node_levels_array, sizeof(struct node_level), 0);
+
+    int level;
+    int ret = compute_level(levels, &node_levels_array, scene, &level);
+    if (ret < 0)
+        goto end;
+
+    struct node_level *node_levels = ngli_darray_data(&node_levels_array);
+    const int nb_nodes = ngli_darray_count(&node_levels_array);
+    qsort(node_levels, nb_nodes, sizeof(*node_levels), cmp_node_level);
+
+    for (int i = 0; i < nb_nodes; i++) {
+        if (!i || node_levels[i].level != node_levels[i - 1].level) {
+            const struct parallel_update_wave wave = {.start = i};
+            if (!ngli_darray_push(&s->waves, &wave)) {
+                ret = NGL_ERROR_MEMORY;
+                goto end;
+            }
+        }
+        struct parallel_update_wave *wave = ngli_darray_tail(&s->waves);
+        wave->count++;
+
+        if (!ngli_darray_push(&s->nodes, &node_levels[i].node)) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+    }
+
+    LOG(DEBUG, "%d node(s) updated in parallel in %d wave(s)",
+        ngli_darray_count(&s->nodes), ngli_darray_count(&s->waves));
+
+end:
+    ngli_darray_reset(&node_levels_array);
+    ngli_ptrmap_freep(&levels);
+    return ret;
+}
+
+int ngli_parallel_update_init(struct parallel_update *s, struct threadpool *threadpool,
+                              struct ngl_node *scene)
+{
+    memset(s, 0, sizeof(*s));
+    ngli_darray_init(&s->nodes, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->waves, sizeof(struct parallel_update_wave), 0);
+
+    if (!threadpool || !scene)
+        return 0;
+
+    const int nb_threads = ngli_threadpool_get_nb_threads(threadpool);
+    s->work_times = ngli_calloc(nb_threads, sizeof(*s->work_times));
+    if (!s->work_times)
+        return NGL_ERROR_MEMORY;
+
+    int ret = build_waves(s, scene);
+    if (ret < 0)
+        return ret;
+
+    s->threadpool = threadpool;
+    return 0;
+}
+
+static int update_job(void *user_arg, int job_id, int thread_id)
+{
+    struct parallel_update *s = user_arg;
+    const int64_t start_time = s->measure ? ngli_gettime_relative() : 0;
+
+    struct ngl_node **nodes = ngli_darray_data(&s->nodes);
+    const int start = s->wave_start + job_id * s->chunk_size;
+    const int end = NGLI_MIN(start + s->chunk_size, s->wave_end);
+
+    int ret = 0;
+    for (int i = start; i < end; i++) {
+        struct ngl_node *node = nodes[i];
+
+        /* Only honor the nodes reached by the visit of the current frame */
+        if (!node->is_active || node->visit_time != s->t)
+            continue;
+
+        ret = ngli_node_update(node, s->t);
+        if (ret < 0)
+            break;
+    }
+
+    if (s->measure)
+        s->work_times[thread_id] += ngli_gettime_relative() - start_time;
+
+    return ret;
+}
+
+int ngli_parallel_update_run(struct parallel_update *s, double t, int64_t *work_timep)
+{
+    if (work_timep)
+        *work_timep = 0;
+
+    if (!s->threadpool)
+        return 0;
+
+    const int nb_threads = ngli_threadpool_get_nb_threads(s->threadpool);
+    memset(s->work_times, 0, nb_threads * sizeof(*s->work_times));
+    s->t = t;
+    s->measure = work_timep != NULL;
+
+    const struct parallel_update_wave *waves = ngli_darray_data(&s->waves);
+    for (int i = 0; i < ngli_darray_count(&s->waves); i++) {
+        const struct parallel_update_wave *wave = &waves[i];
+        s->wave_start = wave->start;
+        s->wave_end = wave->start + wave->count;
+        s->chunk_size = NGLI_MAX(wave->count / (nb_threads * CHUNKS_PER_THREAD), MIN_CHUNK_SIZE);
+
+        const int nb_jobs = (wave->count + s->chunk_size - 1) / s->chunk_size;
+        int ret = ngli_threadpool_execute(s->threadpool, update_job, s, nb_jobs);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (work_timep) {
+        for (int i = 0; i < nb_threads; i++)
+            *work_timep += s->work_times[i];
+    }
+
+    return 0;
+}
+
+void ngli_parallel_update_reset(struct parallel_update *s)
+{
+    ngli_darray_reset(&s->nodes);
+    ngli_darray_reset(&s->waves);
+    ngli_freep(&s->work_times);
+    memset(s, 0, sizeof(*s));
+}
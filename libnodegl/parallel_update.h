@@ -0,0 +1,75 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PARALLEL_UPDATE_H
+#define PARALLEL_UPDATE_H
+
+#include <stdint.h>
+
+#include "darray.h"
+#include "threadpool.h"
+
+struct ngl_node;
+
+/*
+ * Update the nodes flagged with NGLI_NODE_FLAG_PARALLEL_UPDATE across a
+ * thread pool, ahead of the serial scene update.
+ *
+ * The eligible nodes are grouped in waves according to their depth in the
+ * dependency graph (a node only depends on nodes from previous waves), and
+ * each wave is split into chunks distributed among the pool threads. Once a
+ * node is updated, its last_update_time matches the frame time so the serial
+ * update skips it, which also keeps diamond-shared nodes updated only once.
+ */
+struct parallel_update {
+    struct threadpool *threadpool;
+    struct darray nodes; /* struct ngl_node *, sorted by wave */
+    struct darray waves; /* struct parallel_update_wave */
+    int64_t *work_times; /* per thread */
+
+    /* Current execution */
+    int wave_start;
+    int wave_end;
+    int chunk_size;
+    double t;
+    int measure;
+};
+
+struct parallel_update_wave {
+    int start;
+    int count;
+};
+
+/*
+ * The thread pool is not owned by the parallel update; if NULL, the parallel
+ * update is disabled.
+ */
+int ngli_parallel_update_init(struct parallel_update *s, struct threadpool *threadpool,
+                              struct ngl_node *scene);
+
+/*
+ * If work_timep is not NULL, it is set to the total time spent by all the
+ * threads in the node updates.
+ */
+int ngli_parallel_update_run(struct parallel_update *s, double t, int64_t *work_timep);
+void ngli_parallel_update_reset(struct parallel_update *s);
+
+#endif
@@ -30,6 +30,7 @@
 #include "buffer.h"
 #include "darray.h"
 #include "geometry.h"
+#include "glsl_scan.h"
 #include "gpu_ctx.h"
 #include "hmap.h"
 #include "image.h"
@@ -149,6 +150,15 @@ static int register_texture(struct pass *s, const char *name, struct ngl_node *t
     }
 
     const struct pass_params *params = &s->params;
+    if (crafter_texture.type == NGLI_PGCRAFT_SHADER_TEX_TYPE_VIDEO) {
+        const char *src = stage == NGLI_PROGRAM_SHADER_VERT ? params->vert_base :
+                          stage == NGLI_PROGRAM_SHADER_FRAG ? params->frag_base :
+                                                              params->comp_base;
+        /* Disable direct rendering if the shader samples the texture by other means */
+        if (!ngli_glsl_scan_is_texvideo_only(src, name))
+            texture_priv->supported_image_layouts = 1 << NGLI_IMAGE_LAYOUT_DEFAULT;
+    }
+
     if (params->properties) {
         const struct ngl_node *resprops_node = ngli_hmap_get(params->properties, name);
         if (resprops_node) {
@@ -38,9 +38,19 @@ static void reset_cached_frag_map(void *user_arg, void *data)
     ngli_hmap_freep(&p);
 }
 
-int ngli_pgcache_init(struct pgcache *s, struct gpu_ctx *gpu_ctx)
+int ngli_pgcache_init(struct pgcache *s, struct gpu_ctx *gpu_ctx, struct pgcache *shared)
 {
     s->gpu_ctx = gpu_ctx;
+    if (shared) {
+        s->shared = shared->shared ? shared->shared : shared;
+        return 0;
+    }
+
+    if (pthread_mutex_init(&s->lock, NULL)) {
+        s->gpu_ctx = NULL;
+        return NGL_ERROR_EXTERNAL;
+    }
+
     s->graphics_cache = ngli_hmap_create();
     s->compute_cache = ngli_hmap_create();
     if (!s->graphics_cache || !s->compute_cache)
@@ -86,7 +96,7 @@ static int query_cache(struct pgcache *s, struct program **dstp,
     return 0;
 }
 
-int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program **dstp, const struct program_params *params)
+static int get_graphics_program(struct pgcache *s, struct program **dstp, const struct program_params *params)
 {
     /*
      * The first dimension of the graphics_cache hmap is another hmap: what we
@@ -110,15 +120,37 @@ int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program **dstp,
     return query_cache(s, dstp, frag_map, params->fragment, params);
 }
 
+int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program **dstp, const struct program_params *params)
+{
+    if (s->shared)
+        s = s->shared;
+
+    pthread_mutex_lock(&s->lock);
+    int ret = get_graphics_program(s, dstp, params);
+    pthread_mutex_unlock(&s->lock);
+    return ret;
+}
+
 int ngli_pgcache_get_compute_program(struct pgcache *s, struct program **dstp, const struct program_params *params)
 {
-    return query_cache(s, dstp, s->compute_cache, params->compute, params);
+    if (s->shared)
+        s = s->shared;
+
+    pthread_mutex_lock(&s->lock);
+    int ret = query_cache(s, dstp, s->compute_cache, params->compute, params);
+    pthread_mutex_unlock(&s->lock);
+    return ret;
 }
 
 void ngli_pgcache_reset(struct pgcache *s)
 {
     if (!s->gpu_ctx)
         return;
+    if (s->shared) {
+        memset(s, 0, sizeof(*s));
+        return;
+    }
+    pthread_mutex_destroy(&s->lock);
     ngli_hmap_freep(&s->compute_cache);
     ngli_hmap_freep(&s->graphics_cache);
     memset(s, 0, sizeof(*s));
@@ -24,14 +24,22 @@
 
 #include "hmap.h"
 #include "program.h"
+#include "pthread_compat.h"
 
+/*
+ * A program cache can be shared with other contexts (using the same GPU
+ * device or share group): their queries are then forwarded to it, and
+ * serialized with a lock since the contexts run in different threads.
+ */
 struct pgcache {
     struct gpu_ctx *gpu_ctx;
+    struct pgcache *shared;
+    pthread_mutex_t lock;
     struct hmap *graphics_cache;
     struct hmap *compute_cache;
 };
 
-int ngli_pgcache_init(struct pgcache *s, struct gpu_ctx *ctx);
+int ngli_pgcache_init(struct pgcache *s, struct gpu_ctx *ctx, struct pgcache *shared);
 int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program **dstp, const struct program_params *params);
 int ngli_pgcache_get_compute_program(struct pgcache *s, struct program **dstp, const struct program_params *params);
 void ngli_pgcache_reset(struct pgcache *s);
@@ -675,6 +675,10 @@ static int inject_ublock(struct pgcraft *s, struct bstr *b, int stage)
         return binding;
     compat_info->ubindings[stage] = binding;
 
+    /* The block data is written in the uniform ring at every draw */
+    struct pipeline_buffer_desc *desc = ngli_darray_tail(&s->pipeline_info.desc.buffers);
+    desc->dynamic = 1;
+
     return 0;
 }
 
@@ -64,6 +64,7 @@ struct pipeline_buffer_desc {
     int stage;
     int offset;
     int size;
+    int dynamic; /* the offset is expected to change at every draw */
 };
 
 struct pipeline_attribute_desc {
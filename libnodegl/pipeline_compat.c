@@ -19,18 +19,38 @@
  * under the License.
  */
 
+#include <string.h>
+
 #include "darray.h"
+#include "draw_list.h"
+#include "log.h"
 #include "memory.h"
 #include "nodegl.h"
 #include "pipeline_compat.h"
 #include "type.h"
+#include "uniform_ring.h"
+
+struct buffer_binding {
+    const struct buffer *buffer;
+    int offset;
+    int size;
+};
 
 struct pipeline_compat {
     struct gpu_ctx *gpu_ctx;
     struct pipeline *pipeline;
     const struct pgcraft_compat_info *compat_info;
-    struct buffer *ubuffers[NGLI_PROGRAM_SHADER_NB];
-    uint8_t *mapped_datas[NGLI_PROGRAM_SHADER_NB];
+    uint8_t *ublocks_data[NGLI_PROGRAM_SHADER_NB];
+    int ublocks_index[NGLI_PROGRAM_SHADER_NB];
+
+    /* Current bindings, only used to detect the changes */
+    const struct texture **textures;
+    int nb_textures;
+    struct buffer_binding *buffers;
+    int nb_buffers;
+    const struct buffer **attributes;
+    int nb_attributes;
+    int64_t record_flush_count; /* flush count of the draw list at the last recorded draw */
 };
 
 struct pipeline_compat *ngli_pipeline_compat_create(struct gpu_ctx *gpu_ctx)
@@ -39,9 +59,61 @@ struct pipeline_compat *ngli_pipeline_compat_create(struct gpu_ctx *gpu_ctx)
     if (!s)
         return NULL;
     s->gpu_ctx = gpu_ctx;
+    s->record_flush_count = -1;
     return s;
 }
 
+static int init_bindings(struct pipeline_compat *s, const struct pipeline_params *params,
+                         const struct pipeline_resources *resources)
+{
+    if (resources->nb_textures) {
+        s->textures = ngli_calloc(resources->nb_textures, sizeof(*s->textures));
+        if (!s->textures)
+            return NGL_ERROR_MEMORY;
+        for (int i = 0; i < resources->nb_textures; i++)
+            s->textures[i] = resources->textures[i];
+        s->nb_textures = resources->nb_textures;
+    }
+
+    if (resources->nb_buffers) {
+        s->buffers = ngli_calloc(resources->nb_buffers, sizeof(*s->buffers));
+        if (!s->buffers)
+            return NGL_ERROR_MEMORY;
+        for (int i = 0; i < resources->nb_buffers; i++) {
+            const struct pipeline_buffer_desc *desc = &params->layout.buffers_desc[i];
+            const struct buffer_binding binding = {
+                .buffer = resources->buffers[i],
+                .offset = desc->offset,
+                .size   = desc->size,
+            };
+            s->buffers[i] = binding;
+        }
+        s->nb_buffers = resources->nb_buffers;
+    }
+
+    if (resources->nb_attributes) {
+        s->attributes = ngli_calloc(resources->nb_attributes, sizeof(*s->attributes));
+        if (!s->attributes)
+            return NGL_ERROR_MEMORY;
+        for (int i = 0; i < resources->nb_attributes; i++)
+            s->attributes[i] = resources->attributes[i];
+        s->nb_attributes = resources->nb_attributes;
+    }
+
+    return 0;
+}
+
+/*
+ * The recorded draws only capture their uniform buffers: before any other
+ * binding of the pipeline changes, its pending draws must be submitted
+ */
+static void flush_recorded_draws(struct pipeline_compat *s)
+{
+    struct draw_list *draw_list = s->gpu_ctx->draw_list;
+    if (draw_list && s->record_flush_count == ngli_draw_list_get_flush_count(draw_list))
+        ngli_draw_list_flush(draw_list);
+}
+
 static int get_pipeline_ubo_index(const struct pipeline_params *params, int binding, int stage)
 {
     const struct pipeline_layout *layout = &params->layout;
@@ -55,35 +127,62 @@ static int get_pipeline_ubo_index(const struct pipeline_params *params, int bind
     return -1;
 }
 
-static int init_blocks_buffers(struct pipeline_compat *s, const struct pipeline_compat_params *params)
+/*
+ * The uniform blocks are kept on the CPU side and copied into the uniform
+ * ring of the GPU context at every draw: all the draws of a frame write their
+ * uniforms linearly into the same buffer and only differ by the bound offset
+ */
+static int init_blocks_data(struct pipeline_compat *s, const struct pipeline_compat_params *params)
 {
-    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    if (!s->gpu_ctx->uniform_ring) {
+        LOG(ERROR, "uniform blocks are not supported by this GPU context");
+        return NGL_ERROR_GRAPHICS_UNSUPPORTED;
+    }
 
     for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
         const struct block *block = &s->compat_info->ublocks[i];
         if (!block->size)
             continue;
 
-        struct buffer *buffer = ngli_buffer_create(gpu_ctx);
-        if (!buffer)
+        s->ublocks_data[i] = ngli_calloc(1, block->size);
+        if (!s->ublocks_data[i])
             return NGL_ERROR_MEMORY;
-        s->ubuffers[i] = buffer;
 
-        int ret = ngli_buffer_init(buffer,
-                                   block->size,
-                                   NGLI_BUFFER_USAGE_DYNAMIC_BIT |
-                                   NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
-                                   NGLI_BUFFER_USAGE_MAP_WRITE);
+        const struct pipeline_params *pipeline_params = params->params;
+        s->ublocks_index[i] = get_pipeline_ubo_index(pipeline_params, s->compat_info->ubindings[i], i);
+    }
+
+    return 0;
+}
+
+static int upload_blocks_data(struct pipeline_compat *s, struct draw_packet *packet)
+{
+    for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
+        if (!s->ublocks_data[i])
+            continue;
+
+        const struct block *block = &s->compat_info->ublocks[i];
+        struct uniform_ring_alloc alloc;
+        int ret = ngli_uniform_ring_alloc(s->gpu_ctx->uniform_ring, block->size, &alloc);
         if (ret < 0)
             return ret;
+        memcpy(alloc.data, s->ublocks_data[i], block->size);
+
+        /* The deferred draws bind their uniform data when submitted */
+        if (packet) {
+            const struct draw_packet_buffer buffer = {
+                .index  = s->ublocks_index[i],
+                .buffer = alloc.buffer,
+                .offset = alloc.offset,
+                .size   = block->size,
+            };
+            packet->buffers[packet->nb_buffers++] = buffer;
+            continue;
+        }
 
-        ret = ngli_buffer_map(buffer, buffer->size, 0, (void **)&s->mapped_datas[i]);
+        ret = ngli_pipeline_update_buffer(s->pipeline, s->ublocks_index[i], alloc.buffer, alloc.offset, block->size);
         if (ret < 0)
             return ret;
-
-        const struct pipeline_params *pipeline_params = params->params;
-        const int index = get_pipeline_ubo_index(pipeline_params, s->compat_info->ubindings[i], i);
-        ngli_pipeline_update_buffer(s->pipeline, index, buffer, 0, buffer->size);
     }
 
     return 0;
@@ -102,12 +201,13 @@ int ngli_pipeline_compat_init(struct pipeline_compat *s, const struct pipeline_c
 
     int ret;
     if ((ret = ngli_pipeline_init(s->pipeline, pipeline_params)) < 0 ||
-        (ret = ngli_pipeline_set_resources(s->pipeline, pipeline_resources)) < 0)
+        (ret = ngli_pipeline_set_resources(s->pipeline, pipeline_resources)) < 0 ||
+        (ret = init_bindings(s, pipeline_params, pipeline_resources)) < 0)
         return ret;
 
     s->compat_info = params->compat_info;
     if (s->compat_info->use_ublocks) {
-        ret = init_blocks_buffers(s, params);
+        ret = init_blocks_data(s, params);
         if (ret < 0)
             return ret;
     }
@@ -117,6 +217,10 @@ int ngli_pipeline_compat_init(struct pipeline_compat *s, const struct pipeline_c
 
 int ngli_pipeline_compat_update_attribute(struct pipeline_compat *s, int index, const struct buffer *buffer)
 {
+    if (index >= 0 && index < s->nb_attributes && s->attributes[index] != buffer) {
+        flush_recorded_draws(s);
+        s->attributes[index] = buffer;
+    }
     return ngli_pipeline_update_attribute(s->pipeline, index, buffer);
 }
 
@@ -134,7 +238,7 @@ int ngli_pipeline_compat_update_uniform(struct pipeline_compat *s, int index, co
     const struct block_field *fields = ngli_darray_data(&block->fields);
     const struct block_field *field = &fields[field_index];
     if (value) {
-        uint8_t *dst = s->mapped_datas[stage] + field->offset;
+        uint8_t *dst = s->ublocks_data[stage] + field->offset;
         ngli_block_field_copy(field, dst, value);
     }
 
@@ -143,6 +247,10 @@ int ngli_pipeline_compat_update_uniform(struct pipeline_compat *s, int index, co
 
 int ngli_pipeline_compat_update_texture(struct pipeline_compat *s, int index, const struct texture *texture)
 {
+    if (index >= 0 && index < s->nb_textures && s->textures[index] != texture) {
+        flush_recorded_draws(s);
+        s->textures[index] = texture;
+    }
     return ngli_pipeline_update_texture(s->pipeline, index, texture);
 }
 
@@ -211,21 +319,101 @@ void ngli_pipeline_compat_update_texture_info(struct pipeline_compat *s, const s
 
 int ngli_pipeline_compat_update_buffer(struct pipeline_compat *s, int index, const struct buffer *buffer, int offset, int size)
 {
+    if (index >= 0 && index < s->nb_buffers) {
+        struct buffer_binding *binding = &s->buffers[index];
+        if (binding->buffer != buffer || binding->offset != offset || binding->size != size) {
+            flush_recorded_draws(s);
+            binding->buffer = buffer;
+            binding->offset = offset;
+            binding->size   = size;
+        }
+    }
     return ngli_pipeline_update_buffer(s->pipeline, index, buffer, offset, size);
 }
 
+static int prepare_pipeline(struct pipeline_compat *s)
+{
+    if (!s->compat_info->use_ublocks)
+        return 0;
+
+    int ret = upload_blocks_data(s, NULL);
+    if (ret < 0) {
+        LOG(ERROR, "could not upload uniform blocks data");
+        return ret;
+    }
+
+    return 0;
+}
+
+/*
+ * Record the draw in the draw list of the GPU context if any, in which case 1
+ * is returned. Deferring a draw requires all its uniforms to be captured at
+ * record time, which is only the case with uniform blocks: the other draws
+ * are submitted immediately, after the ones recorded so far.
+ */
+static int record_draw(struct pipeline_compat *s, struct draw_packet *packet)
+{
+    struct draw_list *draw_list = s->gpu_ctx->draw_list;
+    if (!draw_list)
+        return 0;
+
+    if (!s->compat_info->use_ublocks) {
+        ngli_draw_list_flush(draw_list);
+        return 0;
+    }
+
+    packet->pipeline = s->pipeline;
+    ngli_gpu_ctx_get_viewport(s->gpu_ctx, packet->viewport);
+    ngli_gpu_ctx_get_scissor(s->gpu_ctx, packet->scissor);
+
+    int ret = upload_blocks_data(s, packet);
+    if (ret < 0) {
+        LOG(ERROR, "could not upload uniform blocks data");
+        return ret;
+    }
+
+    ret = ngli_draw_list_add(draw_list, packet);
+    if (ret < 0)
+        return ret;
+    s->record_flush_count = ngli_draw_list_get_flush_count(draw_list);
+
+    return 1;
+}
+
 void ngli_pipeline_compat_draw(struct pipeline_compat *s, int nb_vertices, int nb_instances)
 {
+    struct draw_packet packet = {
+        .nb_vertices  = nb_vertices,
+        .nb_instances = nb_instances,
+    };
+    if (record_draw(s, &packet))
+        return;
+
+    if (prepare_pipeline(s) < 0)
+        return;
     ngli_pipeline_draw(s->pipeline, nb_vertices, nb_instances);
 }
 
 void ngli_pipeline_compat_draw_indexed(struct pipeline_compat *s, const struct buffer *indices, int indices_format, int nb_indices, int nb_instances)
 {
+    struct draw_packet packet = {
+        .indices        = indices,
+        .indices_format = indices_format,
+        .nb_indices     = nb_indices,
+        .nb_instances   = nb_instances,
+    };
+    if (record_draw(s, &packet))
+        return;
+
+    if (prepare_pipeline(s) < 0)
+        return;
     ngli_pipeline_draw_indexed(s->pipeline, indices, indices_format, nb_indices, nb_instances);
 }
 
 void ngli_pipeline_compat_dispatch(struct pipeline_compat *s, int nb_group_x, int nb_group_y, int nb_group_z)
 {
+    if (prepare_pipeline(s) < 0)
+        return;
     ngli_pipeline_dispatch(s->pipeline, nb_group_x, nb_group_y, nb_group_z);
 }
 
@@ -235,13 +423,10 @@ void ngli_pipeline_compat_freep(struct pipeline_compat **sp)
     if (!s)
         return;
     ngli_pipeline_freep(&s->pipeline);
-    if (s->compat_info && s->compat_info->use_ublocks) {
-        for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
-            if (s->ubuffers[i]) {
-                ngli_buffer_unmap(s->ubuffers[i]);
-                ngli_buffer_freep(&s->ubuffers[i]);
-            }
-        }
-    }
+    for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++)
+        ngli_freep(&s->ublocks_data[i]);
+    ngli_freep(&s->textures);
+    ngli_freep(&s->buffers);
+    ngli_freep(&s->attributes);
     ngli_freep(sp);
 }
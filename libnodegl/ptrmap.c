@@ -0,0 +1,187 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+
+#include "memory.h"
+#include "nodegl.h"
+#include "ptrmap.h"
+
+/* The table is grown when more than half of its slots are used */
+#define MIN_SIZE_NBIT 4
+#define MAX_SIZE_NBIT 30
+
+struct slot {
+    const void *key; /* NULL if the slot is free */
+    int value;
+};
+
+struct ptrmap {
+    struct slot *slots;
+    int size_nbit;
+    uint32_t mask;
+    int count;
+};
+
+static uint32_t hash_ptr(const void *ptr, int size_nbit)
+{
+    /* Fibonacci hashing: the multiplication spreads the low entropy of the
+     * (aligned) pointers into the upper bits, which are the ones kept */
+    const uint64_t v = (uint64_t)(uintptr_t)ptr * UINT64_C(0x9E3779B97F4A7C15);
+    return (uint32_t)(v >> (64 - size_nbit));
+}
+
+static int alloc_slots(struct ptrmap *s, int size_nbit)
+{
+    struct slot *slots = ngli_calloc(1 << size_nbit, sizeof(*slots));
+    if (!slots)
+        return NGL_ERROR_MEMORY;
+    s->slots = slots;
+    s->size_nbit = size_nbit;
+    s->mask = (1U << size_nbit) - 1;
+    return 0;
+}
+
+struct ptrmap *ngli_ptrmap_create(int capacity)
+{
+    struct ptrmap *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    int size_nbit = MIN_SIZE_NBIT;
+    while (size_nbit < MAX_SIZE_NBIT && (1 << (size_nbit - 1)) < capacity)
+        size_nbit++;
+
+    if (alloc_slots(s, size_nbit) < 0) {
+        ngli_free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int ngli_ptrmap_count(const struct ptrmap *s)
+{
+    return s->count;
+}
+
+static struct slot *find_slot(const struct ptrmap *s, const void *key)
+{
+    uint32_t i = hash_ptr(key, s->size_nbit);
+    while (s->slots[i].key && s->slots[i].key != key)
+        i = (i + 1) & s->mask;
+    return &s->slots[i];
+}
+
+static int grow(struct ptrmap *s)
+{
+    if (s->size_nbit >= MAX_SIZE_NBIT)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    struct slot *old_slots = s->slots;
+    const int old_size = 1 << s->size_nbit;
+    int ret = alloc_slots(s, s->size_nbit + 1);
+    if (ret < 0)
+        return ret;
+
+    for (int i = 0; i < old_size; i++)
+        if (old_slots[i].key)
+            *find_slot(s, old_slots[i].key) = old_slots[i];
+    ngli_free(old_slots);
+    return 0;
+}
+
+int ngli_ptrmap_set(struct ptrmap *s, const void *key, int value)
+{
+    if (!key || value < 0)
+        return NGL_ERROR_INVALID_ARG;
+
+    struct slot *slot = find_slot(s, key);
+    if (slot->key) {
+        slot->value = value;
+        return 0;
+    }
+
+    if (s->count + 1 > 1 << (s->size_nbit - 1)) {
+        int ret = grow(s);
+        if (ret < 0)
+            return ret;
+        slot = find_slot(s, key);
+    }
+
+    slot->key = key;
+    slot->value = value;
+    s->count++;
+    return 0;
+}
+
+int ngli_ptrmap_get(const struct ptrmap *s, const void *key)
+{
+    if (!key)
+        return -1;
+    const struct slot *slot = find_slot(s, key);
+    return slot->key ? slot->value : -1;
+}
+
+/* Whether the slot i is cyclically in the range (start, end] */
+static int slot_in_range(uint32_t i, uint32_t start, uint32_t end)
+{
+    return start <= end ? i > start && i <= end : i > start || i <= end;
+}
+
+int ngli_ptrmap_remove(struct ptrmap *s, const void *key)
+{
+    if (!key)
+        return NGL_ERROR_NOT_FOUND;
+
+    struct slot *slot = find_slot(s, key);
+    if (!slot->key)
+        return NGL_ERROR_NOT_FOUND;
+
+    /*
+     * Move back the following entries of the cluster which cannot be reached
+     * anymore once the slot is freed, since the lookups stop at free slots
+     */
+    uint32_t i = (uint32_t)(slot - s->slots);
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1) & s->mask;
+        if (!s->slots[j].key)
+            break;
+        const uint32_t home = hash_ptr(s->slots[j].key, s->size_nbit);
+        if (slot_in_range(home, i, j))
+            continue;
+        s->slots[i] = s->slots[j];
+        i = j;
+    }
+
+    s->slots[i] = (struct slot){0};
+    s->count--;
+    return 0;
+}
+
+void ngli_ptrmap_freep(struct ptrmap **sp)
+{
+    struct ptrmap *s = *sp;
+    if (!s)
+        return;
+    ngli_free(s->slots);
+    ngli_freep(sp);
+}
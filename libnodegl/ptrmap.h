@@ -0,0 +1,41 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PTRMAP_H
+#define PTRMAP_H
+
+/*
+ * Open addressing hash table mapping pointers to positive integers (typically
+ * indexes), for the lookups where going through the string keys of an hmap
+ * would dominate.
+ */
+struct ptrmap;
+
+struct ptrmap *ngli_ptrmap_create(int capacity);
+int ngli_ptrmap_count(const struct ptrmap *s);
+int ngli_ptrmap_set(struct ptrmap *s, const void *key, int value);
+int ngli_ptrmap_get(const struct ptrmap *s, const void *key);
+
+/* Return NGL_ERROR_NOT_FOUND if the key is not in the map */
+int ngli_ptrmap_remove(struct ptrmap *s, const void *key);
+void ngli_ptrmap_freep(struct ptrmap **sp);
+
+#endif
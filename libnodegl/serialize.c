@@ -29,42 +29,24 @@
 #include "memory.h"
 #include "internal.h"
 #include "nodegl.h"
+#include "ptrmap.h"
 #include "utils.h"
 
 extern const struct node_param ngli_base_node_params[];
 
-static void free_func(void *arg, void *data)
+static int register_node(struct ptrmap *nlist, const struct ngl_node *node)
 {
-    ngli_free(data);
+    return ngli_ptrmap_set(nlist, node, ngli_ptrmap_count(nlist));
 }
 
-static int register_node(struct hmap *nlist,
-                          const struct ngl_node *node)
+static int get_node_id(const struct ptrmap *nlist, const struct ngl_node *node)
 {
-    char key[32];
-    int ret = snprintf(key, sizeof(key), "%p", node);
-    if (ret < 0)
-        return ret;
-    char *val = ngli_asprintf("%x", ngli_hmap_count(nlist));
-    if (!val)
-        return NGL_ERROR_MEMORY;
-    ret = ngli_hmap_set(nlist, key, val);
-    if (ret < 0)
-        ngli_free(val);
-    return ret;
-}
-
-static int get_node_id(const struct hmap *nlist, const struct ngl_node *node)
-{
-    char key[32];
-    (void)snprintf(key, sizeof(key), "%p", node);
-    const char *val = ngli_hmap_get(nlist, key);
-    return val ? strtol(val, NULL, 16) : -1;
+    return ngli_ptrmap_get(nlist, node);
 }
 
-static int get_rel_node_id(const struct hmap *nlist, const struct ngl_node *node)
+static int get_rel_node_id(const struct ptrmap *nlist, const struct ngl_node *node)
 {
-    return ngli_hmap_count(nlist) - get_node_id(nlist, node);
+    return ngli_ptrmap_count(nlist) - get_node_id(nlist, node);
 }
 
 #define DECLARE_FLT_PRINT_FUNC(type, nbit, shift_exp, z)                \
@@ -214,8 +196,20 @@ static void serialize_data(struct bstr *b, const uint8_t *srcp, const struct nod
     if (!data || !size)
         return;
     ngli_bstr_printf(b, " %s:%d,", par->key, size);
-    for (int i = 0; i < size; i++)
-        ngli_bstr_printf(b, "%02x", data[i]);
+
+    /* The data is hex-encoded by chunks since it can be very large */
+    static const char hex[] = "0123456789abcdef";
+    char buf[2 * 512 + 1];
+    for (int i = 0; i < size;) {
+        const int n = NGLI_MIN(size - i, 512);
+        for (int j = 0; j < n; j++) {
+            buf[2 * j]     = hex[data[i + j] >> 4];
+            buf[2 * j + 1] = hex[data[i + j] & 0xf];
+        }
+        buf[2 * n] = 0;
+        ngli_bstr_print(b, buf);
+        i += n;
+    }
 }
 
 static void serialize_ivec(struct bstr *b, const uint8_t *srcp, const struct node_param *par)
@@ -258,7 +252,7 @@ static void serialize_mat4(struct bstr *b, const uint8_t *srcp, const struct nod
 }
 
 static void serialize_node(struct bstr *b, const uint8_t *srcp,
-                           const struct node_param *par, struct hmap *nlist)
+                           const struct node_param *par, struct ptrmap *nlist)
 {
     const struct ngl_node *node = *(struct ngl_node **)srcp;
     if (!node)
@@ -268,7 +262,7 @@ static void serialize_node(struct bstr *b, const uint8_t *srcp,
 }
 
 static void serialize_nodelist(struct bstr *b, const uint8_t *srcp,
-                               const struct node_param *par, struct hmap *nlist)
+                               const struct node_param *par, struct ptrmap *nlist)
 {
     struct ngl_node **nodes = *(struct ngl_node ***)srcp;
     const int nb_nodes = *(int *)(srcp + sizeof(struct ngl_node **));
@@ -294,7 +288,7 @@ static void serialize_f64list(struct bstr *b, const uint8_t *srcp, const struct
 }
 
 static int serialize_nodedict(struct bstr *b, const uint8_t *srcp,
-                              const struct node_param *par, struct hmap *nlist)
+                              const struct node_param *par, struct ptrmap *nlist)
 {
     struct hmap *hmap = *(struct hmap **)srcp;
     const int nb_nodes = hmap ? ngli_hmap_count(hmap) : 0;
@@ -319,7 +313,7 @@ static int serialize_nodedict(struct bstr *b, const uint8_t *srcp,
     return 0;
 }
 
-static int serialize_options(struct hmap *nlist,
+static int serialize_options(struct ptrmap *nlist,
                              struct bstr *b,
                              const struct ngl_node *node,
                              uint8_t *priv,
@@ -380,11 +374,11 @@ static int serialize_options(struct hmap *nlist,
     return 0;
 }
 
-static int serialize(struct hmap *nlist,
+static int serialize(struct ptrmap *nlist,
                      struct bstr *b,
                      const struct ngl_node *node);
 
-static int serialize_children(struct hmap *nlist,
+static int serialize_children(struct ptrmap *nlist,
                                struct bstr *b,
                                const struct ngl_node *node,
                                uint8_t *priv,
@@ -458,7 +452,7 @@ static int serialize_children(struct hmap *nlist,
     return 0;
 }
 
-static int serialize(struct hmap *nlist,
+static int serialize(struct ptrmap *nlist,
                      struct bstr *b,
                      const struct ngl_node *node)
 {
@@ -489,20 +483,19 @@ static int serialize(struct hmap *nlist,
 char *ngl_node_serialize(const struct ngl_node *node)
 {
     char *s = NULL;
-    struct hmap *nlist = ngli_hmap_create();
+    struct ptrmap *nlist = ngli_ptrmap_create(0);
     struct bstr *b = ngli_bstr_create();
     if (!nlist || !b)
         goto end;
 
-    ngli_hmap_set_free(nlist, free_func, NULL);
     ngli_bstr_printf(b, "# Node.GL v%d.%d.%d\n",
                     NGL_VERSION_MAJOR, NGL_VERSION_MINOR, NGL_VERSION_MICRO);
-    if (serialize(nlist, b, node) < 0)
+    if (serialize(nlist, b, node) < 0 || ngli_bstr_check(b) < 0)
         goto end;
     s = ngli_bstr_strdup(b);
 
 end:
-    ngli_hmap_freep(&nlist);
+    ngli_ptrmap_freep(&nlist);
     ngli_bstr_freep(&b);
     return s;
 }
@@ -0,0 +1,514 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "darray.h"
+#include "hmap.h"
+#include "log.h"
+#include "memory.h"
+#include "internal.h"
+#include "nodegl.h"
+#include "ptrmap.h"
+#include "serialize_binary.h"
+#include "utils.h"
+
+extern const struct node_param ngli_base_node_params[];
+
+struct wbuf {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    int error;
+};
+
+struct serializer {
+    struct ptrmap *nodes; /* node address -> index in the node table */
+    struct wbuf table;
+    struct wbuf data;
+};
+
+static uint8_t *wbuf_reserve(struct wbuf *b, size_t size)
+{
+    if (b->error)
+        return NULL;
+    if (b->size + size > b->capacity) {
+        size_t capacity = NGLI_MAX(b->capacity * 2, 4096);
+        while (capacity < b->size + size)
+            capacity *= 2;
+        uint8_t *data = ngli_realloc(b->data, capacity);
+        if (!data) {
+            b->error = NGL_ERROR_MEMORY;
+            return NULL;
+        }
+        b->data = data;
+        b->capacity = capacity;
+    }
+    uint8_t *p = b->data + b->size;
+    b->size += size;
+    return p;
+}
+
+static void put_bytes(struct wbuf *b, const void *data, size_t size)
+{
+    uint8_t *p = wbuf_reserve(b, size);
+    if (p && size)
+        memcpy(p, data, size);
+}
+
+static void put_u8(struct wbuf *b, uint8_t v)
+{
+    put_bytes(b, &v, 1);
+}
+
+static void write_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = v >> 8 & 0xff;
+    p[2] = v >> 16 & 0xff;
+    p[3] = v >> 24 & 0xff;
+}
+
+static void write_u64(uint8_t *p, uint64_t v)
+{
+    write_u32(p, (uint32_t)v);
+    write_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static void put_u32(struct wbuf *b, uint32_t v)
+{
+    uint8_t *p = wbuf_reserve(b, 4);
+    if (p)
+        write_u32(p, v);
+}
+
+static void put_u64(struct wbuf *b, uint64_t v)
+{
+    uint8_t *p = wbuf_reserve(b, 8);
+    if (p)
+        write_u64(p, v);
+}
+
+static void put_f32(struct wbuf *b, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    put_u32(b, v);
+}
+
+static void put_f64(struct wbuf *b, double f)
+{
+    uint64_t v;
+    memcpy(&v, &f, sizeof(v));
+    put_u64(b, v);
+}
+
+static void put_key(struct wbuf *b, const char *key)
+{
+    const size_t len = strlen(key);
+    ngli_assert(len <= UINT8_MAX);
+    put_u8(b, (uint8_t)len);
+    put_bytes(b, key, len);
+}
+
+static int register_node(struct serializer *s, const struct ngl_node *node)
+{
+    return ngli_ptrmap_set(s->nodes, node, ngli_ptrmap_count(s->nodes));
+}
+
+static int get_node_index(const struct serializer *s, const struct ngl_node *node)
+{
+    return ngli_ptrmap_get(s->nodes, node);
+}
+
+struct item {
+    const char *key;
+    void *data;
+};
+
+static int cmp_item(const void *p1, const void *p2)
+{
+    const struct item *i1 = p1;
+    const struct item *i2 = p2;
+    return strcmp(i1->key, i2->key);
+}
+
+static int hmap_to_sorted_items(struct darray *items_array, struct hmap *hm)
+{
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(hm, entry))) {
+        struct item item = {.key = entry->key, .data = entry->data};
+        if (!ngli_darray_push(items_array, &item))
+            return NGL_ERROR_MEMORY;
+    }
+
+    void *items = ngli_darray_data(items_array);
+    const int nb_items = ngli_darray_count(items_array);
+    qsort(items, nb_items, sizeof(struct item), cmp_item);
+
+    return 0;
+}
+
+/*
+ * Write the parameter record header, the value size being patched by
+ * end_param() once the value is written
+ */
+static size_t begin_param(struct wbuf *b, const struct node_param *par, int flags)
+{
+    put_key(b, par->key);
+    put_u8(b, flags);
+    const size_t size_pos = b->size;
+    put_u32(b, 0);
+    return size_pos;
+}
+
+static void end_param(struct wbuf *b, size_t size_pos)
+{
+    if (!b->error)
+        write_u32(b->data + size_pos, (uint32_t)(b->size - size_pos - 4));
+}
+
+static int is_default(const uint8_t *srcp, const struct node_param *par, const char *label)
+{
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_SELECT:
+    case NGLI_PARAM_TYPE_FLAGS:
+    case NGLI_PARAM_TYPE_BOOL:
+    case NGLI_PARAM_TYPE_I32:      return *(int *)srcp == par->def_value.i32;
+    case NGLI_PARAM_TYPE_U32:      return *(unsigned *)srcp == par->def_value.u32;
+    case NGLI_PARAM_TYPE_F32:      return *(float *)srcp == par->def_value.f32;
+    case NGLI_PARAM_TYPE_F64:      return *(double *)srcp == par->def_value.f64;
+    case NGLI_PARAM_TYPE_RATIONAL: return !memcmp(srcp, par->def_value.r, sizeof(par->def_value.r));
+    case NGLI_PARAM_TYPE_IVEC2:
+    case NGLI_PARAM_TYPE_IVEC3:
+    case NGLI_PARAM_TYPE_IVEC4:    return !memcmp(srcp, par->def_value.ivec, (par->type - NGLI_PARAM_TYPE_IVEC2 + 2) * sizeof(int));
+    case NGLI_PARAM_TYPE_UVEC2:
+    case NGLI_PARAM_TYPE_UVEC3:
+    case NGLI_PARAM_TYPE_UVEC4:    return !memcmp(srcp, par->def_value.uvec, (par->type - NGLI_PARAM_TYPE_UVEC2 + 2) * sizeof(unsigned));
+    case NGLI_PARAM_TYPE_VEC2:
+    case NGLI_PARAM_TYPE_VEC3:
+    case NGLI_PARAM_TYPE_VEC4:     return !memcmp(srcp, par->def_value.vec, (par->type - NGLI_PARAM_TYPE_VEC2 + 2) * sizeof(float));
+    case NGLI_PARAM_TYPE_MAT4:     return !memcmp(srcp, par->def_value.mat, 16 * sizeof(float));
+    case NGLI_PARAM_TYPE_STR: {
+        const char *s = *(char **)srcp;
+        if (!s || (par->def_value.str && !strcmp(s, par->def_value.str)))
+            return 1;
+        return !strcmp(par->key, "label") && ngli_is_default_label(label, s);
+    }
+    case NGLI_PARAM_TYPE_DATA:
+        return !*(uint8_t **)srcp || !*(int *)(srcp + sizeof(uint8_t *));
+    case NGLI_PARAM_TYPE_NODE:
+        return !*(struct ngl_node **)srcp;
+    case NGLI_PARAM_TYPE_NODELIST:
+        return !*(int *)(srcp + sizeof(struct ngl_node **));
+    case NGLI_PARAM_TYPE_F64LIST:
+        return !*(int *)(srcp + sizeof(double *));
+    case NGLI_PARAM_TYPE_NODEDICT: {
+        struct hmap *hmap = *(struct hmap **)srcp;
+        return !hmap || !ngli_hmap_count(hmap);
+    }
+    default:
+        return 0;
+    }
+}
+
+static void write_data(struct serializer *s, const uint8_t *srcp)
+{
+    const uint8_t *data = *(uint8_t **)srcp;
+    const int size = *(int *)(srcp + sizeof(uint8_t *));
+
+    const size_t offset = NGLI_ALIGN(s->data.size, NGLI_BINARY_DATA_ALIGN);
+    const size_t padding_size = offset - s->data.size;
+    uint8_t *padding = wbuf_reserve(&s->data, padding_size);
+    if (padding)
+        memset(padding, 0, padding_size);
+    put_bytes(&s->data, data, size);
+
+    put_u64(&s->table, offset);
+    put_u64(&s->table, size);
+}
+
+static int write_nodedict(struct serializer *s, const uint8_t *srcp)
+{
+    struct hmap *hmap = *(struct hmap **)srcp;
+
+    struct darray items_array;
+    ngli_darray_init(&items_array, sizeof(struct item), 0);
+    int ret = hmap_to_sorted_items(&items_array, hmap);
+    if (ret < 0) {
+        ngli_darray_reset(&items_array);
+        return ret;
+    }
+
+    const struct item *items = ngli_darray_data(&items_array);
+    const int nb_items = ngli_darray_count(&items_array);
+    put_u32(&s->table, nb_items);
+    for (int i = 0; i < nb_items; i++) {
+        put_key(&s->table, items[i].key);
+        put_u32(&s->table, get_node_index(s, items[i].data));
+    }
+
+    ngli_darray_reset(&items_array);
+    return 0;
+}
+
+static int write_value(struct serializer *s, const uint8_t *srcp, const struct node_param *par)
+{
+    struct wbuf *b = &s->table;
+
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_SELECT: {
+        const char *str = ngli_params_get_select_str(par->choices->consts, *(int *)srcp);
+        ngli_assert(str);
+        put_bytes(b, str, strlen(str));
+        break;
+    }
+    case NGLI_PARAM_TYPE_FLAGS: {
+        char *str = ngli_params_get_flags_str(par->choices->consts, *(int *)srcp);
+        if (!str)
+            return NGL_ERROR_MEMORY;
+        put_bytes(b, str, strlen(str));
+        ngli_free(str);
+        break;
+    }
+    case NGLI_PARAM_TYPE_STR: {
+        const char *str = *(char **)srcp;
+        put_bytes(b, str, strlen(str));
+        break;
+    }
+    case NGLI_PARAM_TYPE_BOOL:
+    case NGLI_PARAM_TYPE_I32:
+    case NGLI_PARAM_TYPE_U32:      put_u32(b, *(uint32_t *)srcp);                               break;
+    case NGLI_PARAM_TYPE_F32:      put_f32(b, *(float *)srcp);                                  break;
+    case NGLI_PARAM_TYPE_F64:      put_f64(b, *(double *)srcp);                                 break;
+    case NGLI_PARAM_TYPE_RATIONAL:
+    case NGLI_PARAM_TYPE_IVEC2:
+    case NGLI_PARAM_TYPE_UVEC2:    for (int i = 0; i < 2;  i++) put_u32(b, ((uint32_t *)srcp)[i]); break;
+    case NGLI_PARAM_TYPE_IVEC3:
+    case NGLI_PARAM_TYPE_UVEC3:    for (int i = 0; i < 3;  i++) put_u32(b, ((uint32_t *)srcp)[i]); break;
+    case NGLI_PARAM_TYPE_IVEC4:
+    case NGLI_PARAM_TYPE_UVEC4:    for (int i = 0; i < 4;  i++) put_u32(b, ((uint32_t *)srcp)[i]); break;
+    case NGLI_PARAM_TYPE_VEC2:     for (int i = 0; i < 2;  i++) put_f32(b, ((float *)srcp)[i]);    break;
+    case NGLI_PARAM_TYPE_VEC3:     for (int i = 0; i < 3;  i++) put_f32(b, ((float *)srcp)[i]);    break;
+    case NGLI_PARAM_TYPE_VEC4:     for (int i = 0; i < 4;  i++) put_f32(b, ((float *)srcp)[i]);    break;
+    case NGLI_PARAM_TYPE_MAT4:     for (int i = 0; i < 16; i++) put_f32(b, ((float *)srcp)[i]);    break;
+    case NGLI_PARAM_TYPE_DATA:     write_data(s, srcp);                                         break;
+    case NGLI_PARAM_TYPE_NODE:     put_u32(b, get_node_index(s, *(struct ngl_node **)srcp));    break;
+    case NGLI_PARAM_TYPE_NODELIST: {
+        struct ngl_node **nodes = *(struct ngl_node ***)srcp;
+        const int nb_nodes = *(int *)(srcp + sizeof(struct ngl_node **));
+        put_u32(b, nb_nodes);
+        for (int i = 0; i < nb_nodes; i++)
+            put_u32(b, get_node_index(s, nodes[i]));
+        break;
+    }
+    case NGLI_PARAM_TYPE_F64LIST: {
+        const double *elems = *(double **)srcp;
+        const int nb_elems = *(int *)(srcp + sizeof(double *));
+        put_u32(b, nb_elems);
+        for (int i = 0; i < nb_elems; i++)
+            put_f64(b, elems[i]);
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODEDICT:
+        return write_nodedict(s, srcp);
+    default:
+        LOG(ERROR, "cannot serialize %s: unsupported parameter type", par->key);
+        return NGL_ERROR_BUG;
+    }
+    return 0;
+}
+
+static int count_params(const struct ngl_node *node, uint8_t *priv, const struct node_param *p)
+{
+    if (!p)
+        return 0;
+
+    int count = 0;
+    for (; p->key; p++) {
+        const uint8_t *srcp = priv + p->offset;
+        if (p->flags & NGLI_PARAM_FLAG_ALLOW_NODE) {
+            if (*(struct ngl_node **)srcp) {
+                count++;
+                continue;
+            }
+            srcp += sizeof(struct ngl_node *);
+        }
+        if (!is_default(srcp, p, node->cls->name))
+            count++;
+    }
+    return count;
+}
+
+static int write_params(struct serializer *s, const struct ngl_node *node,
+                        uint8_t *priv, const struct node_param *p)
+{
+    if (!p)
+        return 0;
+
+    for (; p->key; p++) {
+        const uint8_t *srcp = priv + p->offset;
+
+        if (p->flags & NGLI_PARAM_FLAG_ALLOW_NODE) {
+            const struct ngl_node *src_node = *(struct ngl_node **)srcp;
+            if (src_node) {
+                const size_t size_pos = begin_param(&s->table, p, NGLI_BINARY_PARAM_FLAG_NODE);
+                put_u32(&s->table, get_node_index(s, src_node));
+                end_param(&s->table, size_pos);
+                continue;
+            }
+            srcp += sizeof(struct ngl_node *);
+        }
+
+        if (is_default(srcp, p, node->cls->name))
+            continue;
+
+        const size_t size_pos = begin_param(&s->table, p, 0);
+        int ret = write_value(s, srcp, p);
+        if (ret < 0)
+            return ret;
+        end_param(&s->table, size_pos);
+    }
+    return 0;
+}
+
+static int serialize(struct serializer *s, const struct ngl_node *node);
+
+static int serialize_children(struct serializer *s, uint8_t *priv, const struct node_param *p)
+{
+    if (!p)
+        return 0;
+
+    for (; p->key; p++) {
+        const uint8_t *srcp = priv + p->offset;
+
+        switch (p->type) {
+        case NGLI_PARAM_TYPE_NODE: {
+            const struct ngl_node *child = *(struct ngl_node **)srcp;
+            if (child) {
+                int ret = serialize(s, child);
+                if (ret < 0)
+                    return ret;
+            }
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODELIST: {
+            struct ngl_node **children = *(struct ngl_node ***)srcp;
+            const int nb_children = *(int *)(srcp + sizeof(struct ngl_node **));
+            for (int i = 0; i < nb_children; i++) {
+                int ret = serialize(s, children[i]);
+                if (ret < 0)
+                    return ret;
+            }
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODEDICT: {
+            struct hmap *hmap = *(struct hmap **)srcp;
+            if (!hmap)
+                break;
+            const struct hmap_entry *entry = NULL;
+            while ((entry = ngli_hmap_next(hmap, entry))) {
+                int ret = serialize(s, entry->data);
+                if (ret < 0)
+                    return ret;
+            }
+            break;
+        }
+        default: {
+            if (!(p->flags & NGLI_PARAM_FLAG_ALLOW_NODE))
+                break;
+            const struct ngl_node *child = *(struct ngl_node **)srcp;
+            if (child) {
+                int ret = serialize(s, child);
+                if (ret < 0)
+                    return ret;
+            }
+            break;
+        }
+        }
+    }
+    return 0;
+}
+
+static int serialize(struct serializer *s, const struct ngl_node *node)
+{
+    if (get_node_index(s, node) >= 0)
+        return 0;
+
+    int ret;
+    if ((ret = serialize_children(s, (uint8_t *)node, ngli_base_node_params)) < 0 ||
+        (ret = serialize_children(s, node->opts, node->cls->params)) < 0)
+        return ret;
+
+    put_u32(&s->table, node->cls->id);
+    put_u32(&s->table, count_params(node, node->opts, node->cls->params) +
+                       count_params(node, (uint8_t *)node, ngli_base_node_params));
+    if ((ret = write_params(s, node, node->opts, node->cls->params)) < 0 ||
+        (ret = write_params(s, node, (uint8_t *)node, ngli_base_node_params)) < 0)
+        return ret;
+
+    if (s->table.error)
+        return s->table.error;
+    if (s->data.error)
+        return s->data.error;
+
+    return register_node(s, node);
+}
+
+uint8_t *ngl_node_serialize_binary(const struct ngl_node *node, size_t *sizep)
+{
+    uint8_t *ret = NULL;
+    struct serializer s = {0};
+
+    s.nodes = ngli_ptrmap_create(0);
+    if (!s.nodes)
+        return NULL;
+
+    /* The header is written once the node table is complete */
+    if (!wbuf_reserve(&s.table, NGLI_BINARY_HEADER_SIZE) || serialize(&s, node) < 0)
+        goto end;
+
+    const size_t data_offset = NGLI_ALIGN(s.table.size, NGLI_BINARY_DATA_ALIGN);
+    const size_t size = data_offset + s.data.size;
+    ret = ngli_calloc(1, size);
+    if (!ret)
+        goto end;
+
+    uint8_t *header = s.table.data;
+    memcpy(header, NGLI_BINARY_MAGIC, 4);
+    write_u32(header + 4, NGLI_BINARY_VERSION);
+    write_u32(header + 8, NGL_VERSION_INT);
+    write_u32(header + 12, ngli_ptrmap_count(s.nodes));
+    write_u64(header + 16, data_offset);
+    write_u64(header + 24, s.data.size);
+
+    memcpy(ret, s.table.data, s.table.size);
+    if (s.data.size)
+        memcpy(ret + data_offset, s.data.data, s.data.size);
+    *sizep = size;
+
+end:
+    ngli_ptrmap_freep(&s.nodes);
+    ngli_free(s.table.data);
+    ngli_free(s.data.data);
+    return ret;
+}
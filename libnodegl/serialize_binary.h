@@ -0,0 +1,73 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SERIALIZE_BINARY_H
+#define SERIALIZE_BINARY_H
+
+/*
+ * node.gl binary serialization format (.nglb), all the integers and floats
+ * being stored in little-endian.
+ *
+ * Header:
+ *   u8[4]  magic "NGLB"
+ *   u32    format version (NGLI_BINARY_VERSION)
+ *   u32    library version (NGL_VERSION_INT), which must match the reader one
+ *   u32    number of nodes
+ *   u64    data section offset, from the start of the file
+ *   u64    data section size
+ *
+ * The node table follows the header, with the nodes ordered such that the
+ * nodes referenced by a node always come before it, the last node being the
+ * root of the scene. Each node is stored as:
+ *   u32    node type (NGL_NODE_*)
+ *   u32    number of parameters
+ *   and for each parameter set to a non-default value:
+ *     u8     key length
+ *     u8[]   key (without the trailing nul character)
+ *     u8     flags (NGLI_BINARY_PARAM_FLAG_*)
+ *     u32    value size
+ *     u8[]   value, depending on the parameter type:
+ *       i32, bool, u32, f32, f64: the scalar
+ *       ivec*, uvec*, vec*, mat4: the components
+ *       rational:                 i32 numerator, i32 denominator
+ *       select, flags, str:       the string (without the trailing nul character)
+ *       data:                     u64 offset in the data section, u64 size
+ *       node:                     u32 node index in the table
+ *       node list:                u32 count, u32 node indexes
+ *       f64 list:                 u32 count, f64 values
+ *       node dict:                u32 count, and for each entry: u8 key
+ *                                 length, u8[] key, u32 node index
+ *
+ * The data section holds the data parameters (such as the Buffer nodes
+ * content) as they are laid out in memory, each of them aligned on
+ * NGLI_BINARY_DATA_ALIGN bytes from the start of the file so they can be used
+ * directly from a memory-mapped file.
+ */
+
+#define NGLI_BINARY_MAGIC       "NGLB"
+#define NGLI_BINARY_VERSION     1
+#define NGLI_BINARY_HEADER_SIZE 32
+#define NGLI_BINARY_DATA_ALIGN  16
+
+/* The value is a node index, for the parameters also accepting a node */
+#define NGLI_BINARY_PARAM_FLAG_NODE (1 << 0)
+
+#endif
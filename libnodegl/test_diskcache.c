@@ -0,0 +1,100 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "diskcache.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+#define KEY "test_diskcache:key"
+
+static void remove_entry(const char *dir, const char *key)
+{
+    char *path = ngli_asprintf("%s/%08x.bin", dir, ngli_crc32(key));
+    ngli_assert(path);
+    remove(path);
+    ngli_free(path);
+}
+
+int main(int ac, char **av)
+{
+    if (ac != 2) {
+        fprintf(stderr, "Usage: %s <cache_dir>\n", av[0]);
+        return -1;
+    }
+
+    const char *dir = av[1];
+    static const char value[] = "some program binary";
+    void *data;
+    size_t size;
+    int nb_hits, nb_misses;
+
+    remove_entry(dir, KEY);
+
+    /* A disabled cache always misses and silently ignores stores */
+    struct diskcache disabled;
+    ngli_assert(ngli_diskcache_init(&disabled, NULL) == 0);
+    ngli_assert(!ngli_diskcache_enabled(&disabled));
+    ngli_assert(ngli_diskcache_store(&disabled, KEY, value, sizeof(value)) == 0);
+    ngli_assert(ngli_diskcache_load(&disabled, KEY, &data, &size) == NGL_ERROR_NOT_FOUND);
+    ngli_diskcache_reset(&disabled);
+
+    struct diskcache s;
+    ngli_assert(ngli_diskcache_init(&s, dir) == 0);
+    ngli_assert(ngli_diskcache_enabled(&s));
+
+    ngli_assert(ngli_diskcache_load(&s, KEY, &data, &size) == NGL_ERROR_NOT_FOUND);
+    ngli_assert(!data && !size);
+    ngli_diskcache_get_stats(&s, &nb_hits, &nb_misses);
+    ngli_assert(nb_hits == 0 && nb_misses == 1);
+
+    ngli_assert(ngli_diskcache_store(&s, KEY, value, sizeof(value)) == 0);
+    ngli_assert(ngli_diskcache_load(&s, KEY, &data, &size) == 0);
+    ngli_assert(size == sizeof(value));
+    ngli_assert(!memcmp(data, value, size));
+    ngli_diskcache_get_stats(&s, &nb_hits, &nb_misses);
+    ngli_assert(nb_hits == 1 && nb_misses == 1);
+    ngli_freep(&data);
+
+    /* Overwriting an existing entry */
+    static const char value2[] = "another binary";
+    ngli_assert(ngli_diskcache_store(&s, KEY, value2, sizeof(value2)) == 0);
+    ngli_assert(ngli_diskcache_load(&s, KEY, &data, &size) == 0);
+    ngli_assert(size == sizeof(value2));
+    ngli_assert(!memcmp(data, value2, size));
+    ngli_freep(&data);
+    ngli_diskcache_get_stats(&s, &nb_hits, &nb_misses);
+    ngli_assert(nb_hits == 2 && nb_misses == 1);
+
+    /* Data loaded but not usable by the caller is accounted as a miss */
+    ngli_assert(ngli_diskcache_load(&s, KEY, &data, &size) == 0);
+    ngli_freep(&data);
+    ngli_diskcache_reject(&s);
+    ngli_diskcache_get_stats(&s, &nb_hits, &nb_misses);
+    ngli_assert(nb_hits == 2 && nb_misses == 2);
+
+    ngli_diskcache_reset(&s);
+    remove_entry(dir, KEY);
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+
+#include "frame_cache.h"
+#include "internal.h"
+#include "memory.h"
+#include "utils.h"
+
+#define WIDTH  4
+#define HEIGHT 4
+#define FRAME_SIZE (WIDTH * HEIGHT * 4)
+
+/*
+ * The cache bookkeeping is tested without any GPU: the textures and the
+ * conversions are replaced by the stubs below
+ */
+static int nb_conversions;
+
+struct texture *ngli_texture_create(struct gpu_ctx *gpu_ctx)
+{
+    return ngli_calloc(1, sizeof(struct texture));
+}
+
+int ngli_texture_init(struct texture *s, const struct texture_params *params)
+{
+    s->params = *params;
+    return 0;
+}
+
+int ngli_texture_generate_mipmap(struct texture *s)
+{
+    return 0;
+}
+
+void ngli_texture_freep(struct texture **sp)
+{
+    ngli_freep(sp);
+}
+
+int ngli_hwconv_get_dst_usage(struct ngl_ctx *ctx, const struct image_params *src_params)
+{
+    return 0;
+}
+
+int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
+                     const struct image *dst_image,
+                     const struct image_params *src_params)
+{
+    return 0;
+}
+
+int ngli_hwconv_convert_image(struct hwconv *hwconv, const struct image *image)
+{
+    nb_conversions++;
+    return 0;
+}
+
+void ngli_hwconv_reset(struct hwconv *hwconv)
+{
+}
+
+static void check_get(struct frame_cache *s, double t, int cached, double expected_ts)
+{
+    const struct image *image = ngli_frame_cache_get(s, t);
+    if (!cached) {
+        if (image) {
+            fprintf(stderr, "t=%g: unexpected frame %g\n", t, image->ts);
+            ngli_assert(0);
+        }
+        return;
+    }
+    if (!image || image->ts != expected_ts) {
+        fprintf(stderr, "t=%g: expected frame %g\n", t, expected_ts);
+        ngli_assert(0);
+    }
+}
+
+static void add_frame(struct frame_cache *s, double ts, const struct image *src)
+{
+    ngli_assert(ngli_frame_cache_add(s, ts, src) == 0);
+}
+
+int main(void)
+{
+    static struct ngl_ctx ctx;
+    const struct hwmap_params hwmap_params = {0};
+
+    const struct image_params src_params = {
+        .width = WIDTH,
+        .height = HEIGHT,
+        .layout = NGLI_IMAGE_LAYOUT_DEFAULT,
+        .color_scale = 1.f,
+    };
+    struct texture *planes[4] = {0};
+    struct image src;
+    ngli_image_init(&src, &src_params, planes);
+
+    struct frame_cache *s = ngli_frame_cache_create(&ctx);
+    ngli_assert(s);
+    ngli_assert(ngli_frame_cache_init(s, &hwmap_params, 3 * FRAME_SIZE) == 0);
+
+    check_get(s, 0.0, 0, 0.0);
+
+    /* Each frame is displayed from its timestamp up to the next decoded one */
+    add_frame(s, 1.0, &src);
+    add_frame(s, 2.0, &src);
+    add_frame(s, 3.0, &src);
+    ngli_assert(nb_conversions == 3);
+
+    check_get(s, 0.999, 0, 0.0);
+    check_get(s, 1.0, 1, 1.0);
+    check_get(s, 1.999, 1, 1.0);
+    check_get(s, 2.0, 1, 2.0);
+    check_get(s, 2.5, 1, 2.0);
+
+    /* The interval of the most recent frame is not known yet */
+    check_get(s, 3.0, 1, 3.0);
+    check_get(s, 3.001, 0, 0.0);
+
+    /* A frame already in the cache is not converted again */
+    add_frame(s, 2.0, &src);
+    ngli_assert(nb_conversions == 3);
+
+    /* The budget is reached: the least recently used frame (2) is evicted */
+    check_get(s, 1.0, 1, 1.0);
+    check_get(s, 3.0, 1, 3.0);
+    add_frame(s, 4.0, &src);
+    ngli_assert(nb_conversions == 4);
+    check_get(s, 2.0, 0, 0.0);
+    check_get(s, 1.0, 1, 1.0);
+    check_get(s, 3.0, 1, 3.0);
+    check_get(s, 4.0, 1, 4.0);
+
+    /* Then frame 1, which was accessed before 3 and 4 */
+    add_frame(s, 5.0, &src);
+    check_get(s, 1.0, 0, 0.0);
+    check_get(s, 3.0, 1, 3.0);
+    check_get(s, 4.0, 1, 4.0);
+    check_get(s, 4.999, 1, 4.0);
+    check_get(s, 5.0, 1, 5.0);
+
+    /* A seek backward links the last frame to the new one only if it follows it */
+    add_frame(s, 0.0, &src);
+    check_get(s, 5.5, 0, 0.0);
+    check_get(s, 0.0, 1, 0.0);
+    check_get(s, 0.5, 0, 0.0);
+
+    /* Frames larger than the budget are not cached */
+    const struct image_params large_params = {
+        .width = WIDTH * 2,
+        .height = HEIGHT * 2,
+        .layout = NGLI_IMAGE_LAYOUT_DEFAULT,
+        .color_scale = 1.f,
+    };
+    struct image large;
+    ngli_image_init(&large, &large_params, planes);
+    add_frame(s, 6.0, &large);
+    check_get(s, 6.0, 0, 0.0);
+    check_get(s, 1.0, 0, 0.0);
+
+    ngli_frame_cache_freep(&s);
+    ngli_assert(!s);
+
+    s = ngli_frame_cache_create(&ctx);
+    ngli_assert(s);
+    ngli_assert(ngli_frame_cache_init(s, &hwmap_params, 8 * FRAME_SIZE) == 0);
+
+    /* A single interval does not tell whether the frames are consecutive */
+    add_frame(s, 1.0, &src);
+    add_frame(s, 5.0, &src);
+    check_get(s, 1.0, 1, 1.0);
+    check_get(s, 3.0, 0, 0.0);
+
+    /* The frame duration is now known: the first interval was a gap */
+    add_frame(s, 5.5, &src);
+    add_frame(s, 6.0, &src);
+    check_get(s, 3.0, 0, 0.0);
+    check_get(s, 5.25, 1, 5.0);
+    check_get(s, 5.75, 1, 5.5);
+
+    /* Skipped frames: the frame before the gap is not extended over it */
+    add_frame(s, 8.0, &src);
+    add_frame(s, 8.5, &src);
+    check_get(s, 6.0, 1, 6.0);
+    check_get(s, 6.25, 0, 0.0);
+    check_get(s, 7.5, 0, 0.0);
+    check_get(s, 8.25, 1, 8.0);
+
+    /* A frame decoded again after a seek keeps its next frame */
+    add_frame(s, 5.5, &src);
+    add_frame(s, 8.0, &src);
+    check_get(s, 5.75, 1, 5.5);
+    check_get(s, 7.0, 0, 0.0);
+
+    ngli_frame_cache_freep(&s);
+    ngli_assert(!s);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+
+#include "glsl_scan.h"
+#include "utils.h"
+
+static void test_texvideo_only(const char *src, const char *name, int expected)
+{
+    const int ret = ngli_glsl_scan_is_texvideo_only(src, name);
+    if (ret != expected) {
+        fprintf(stderr, "\"%s\" in \"%s\": expected %d, got %d\n", name, src, expected, ret);
+        ngli_assert(0);
+    }
+}
+
+int main(void)
+{
+    /* No shader source, nothing can access the texture */
+    test_texvideo_only(NULL, "tex", 1);
+    test_texvideo_only("", "tex", 1);
+
+    /* Plain ngl_texvideo() calls */
+    test_texvideo_only("vec4 c = ngl_texvideo(tex, uv);", "tex", 1);
+    test_texvideo_only("vec4 c = ngl_texvideo ( \n\ttex , uv);", "tex", 1);
+    test_texvideo_only("ngl_texvideo(tex, uv) + ngl_texvideo(tex, uv * 0.5)", "tex", 1);
+
+    /* Any other access to the same name */
+    test_texvideo_only("vec4 c = ngl_tex2d(tex, uv);", "tex", 0);
+    test_texvideo_only("ngl_texvideo(tex, uv) * ngl_tex2d(tex, uv)", "tex", 0);
+    test_texvideo_only("ngl_tex2d(tex, uv) * ngl_texvideo(tex, uv)", "tex", 0);
+    test_texvideo_only("vec4 c = texture(tex, uv);", "tex", 0);
+    test_texvideo_only("mat4 m = tex_coord_matrix;", "tex_coord_matrix", 0);
+    test_texvideo_only("tex", "tex", 0);
+    test_texvideo_only("ngl_texvideo(uv, tex)", "tex", 0);
+    test_texvideo_only("my_ngl_texvideo(tex, uv)", "tex", 0);
+
+    /* Identifiers containing the name are not references to it */
+    test_texvideo_only("ngl_texvideo(tex, uv) * tex_coord.x", "tex", 1);
+    test_texvideo_only("ngl_texvideo(tex, uv) * ngl_tex2d(tex0, uv)", "tex", 1);
+    test_texvideo_only("ngl_texvideo(tex, uv) * ngl_tex2d(mytex, uv)", "tex", 1);
+    test_texvideo_only("ngl_tex2d(tex0, uv) * ngl_texvideo(tex, uv)", "tex", 1);
+    test_texvideo_only("ngl_texvideo(tex0, uv)", "tex", 1);
+    test_texvideo_only("ngl_texvideo(tex0, uv) * ngl_tex2d(tex, uv)", "tex", 0);
+
+    /* References in comments are conservatively considered as other accesses */
+    test_texvideo_only("ngl_texvideo(tex, uv); // tex", "tex", 0);
+    test_texvideo_only("/* sample tex */ ngl_texvideo(tex, uv);", "tex", 0);
+    test_texvideo_only("ngl_texvideo(/* video */ tex, uv)", "tex", 0);
+    test_texvideo_only("// ngl_texvideo(tex, uv)\n", "tex", 1);
+    test_texvideo_only("// ngl_tex2d(tex, uv)\nngl_texvideo(tex, uv)", "tex", 0);
+    test_texvideo_only("/* texture */ ngl_texvideo(tex, uv)", "tex", 1);
+
+    return 0;
+}
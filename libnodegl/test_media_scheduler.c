@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+
+#include "internal.h"
+#include "media_scheduler.h"
+#include "utils.h"
+
+enum {
+    MEDIA_A,
+    MEDIA_B,
+    MEDIA_C,
+    NB_MEDIAS
+};
+
+static struct ngl_node nodes[NB_MEDIAS];
+static struct media_priv medias[NB_MEDIAS];
+static int nb_starts[NB_MEDIAS];
+static int nb_stops[NB_MEDIAS];
+
+/* The decoders are not actually started, the scheduler calls are only counted */
+void ngli_node_media_start(struct ngl_node *node)
+{
+    nb_starts[node - nodes]++;
+}
+
+void ngli_node_media_stop(struct ngl_node *node)
+{
+    nb_stops[node - nodes]++;
+}
+
+static void check_state(int id, int startup_state, int expected_starts, int expected_stops)
+{
+    if (medias[id].startup_state != startup_state || nb_starts[id] != expected_starts || nb_stops[id] != expected_stops) {
+        fprintf(stderr, "media %d: state=%d starts=%d stops=%d, expected state=%d starts=%d stops=%d\n",
+                id, medias[id].startup_state, nb_starts[id], nb_stops[id],
+                startup_state, expected_starts, expected_stops);
+        ngli_assert(0);
+    }
+}
+
+/* Simulate the first frame of the decoder being obtained without blocking */
+static void get_first_frame(struct media_scheduler *s, int id)
+{
+    const int64_t t = ngli_gettime_relative();
+    ngli_assert(ngli_media_scheduler_register_frame(s, &nodes[id], t, t) == 0);
+}
+
+int main(void)
+{
+    static const char * const filenames[NB_MEDIAS] = {"a.mp4", "b.mp4", "c.mp4"};
+    for (int i = 0; i < NB_MEDIAS; i++) {
+        medias[i].filename = filenames[i];
+        nodes[i].priv_data = &medias[i];
+    }
+
+    struct media_scheduler *s = ngli_media_scheduler_create(1, 2);
+    ngli_assert(s);
+
+    /* A single startup slot: the first decoder starts, the others are queued */
+    medias[MEDIA_A].deadline = 10.0;
+    medias[MEDIA_B].deadline = 5.0;
+    medias[MEDIA_C].deadline = 8.0;
+    for (int i = 0; i < NB_MEDIAS; i++)
+        ngli_assert(ngli_media_scheduler_start(s, &nodes[i], 0) == 0);
+    check_state(MEDIA_A, NGLI_MEDIA_STARTUP_STARTING, 1, 0);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_PENDING, 0, 0);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_PENDING, 0, 0);
+    ngli_assert(ngli_media_scheduler_get_nb_decoders(s) == 1);
+    ngli_assert(ngli_media_scheduler_get_nb_pending(s) == 2);
+
+    /* The startup slot is given back to the pending decoder with the closest deadline */
+    get_first_frame(s, MEDIA_A);
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    ngli_media_scheduler_use(s, &nodes[MEDIA_A]);
+    check_state(MEDIA_A, NGLI_MEDIA_STARTUP_RUNNING, 1, 0);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_STARTING, 1, 0);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_PENDING, 0, 0);
+
+    /*
+     * The decoders budget is exhausted and no running decoder is needed later
+     * than the pending one without having been used by the previous frame
+     */
+    get_first_frame(s, MEDIA_B);
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    ngli_media_scheduler_use(s, &nodes[MEDIA_A]);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_RUNNING, 1, 0);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_PENDING, 0, 0);
+    ngli_assert(ngli_media_scheduler_get_nb_decoders(s) == 2);
+    ngli_assert(ngli_media_scheduler_get_nb_pending(s) == 1);
+
+    /*
+     * The pending decoder is now needed before the others: the latest running
+     * decoder (A) is used by every frame so the next one (B) is paused instead
+     */
+    medias[MEDIA_C].deadline = 1.0;
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    ngli_media_scheduler_use(s, &nodes[MEDIA_A]);
+    check_state(MEDIA_A, NGLI_MEDIA_STARTUP_RUNNING, 1, 0);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_PENDING, 1, 1);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_STARTING, 1, 0);
+    ngli_assert(ngli_media_scheduler_get_nb_decoders(s) == 2);
+
+    /* The paused decoder is queued again and restarts once a decoder is released */
+    ngli_assert(ngli_media_scheduler_get_nb_pending(s) == 1);
+    get_first_frame(s, MEDIA_C);
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    ngli_media_scheduler_use(s, &nodes[MEDIA_A]);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_PENDING, 1, 1);
+    ngli_media_scheduler_cancel(s, &nodes[MEDIA_C]);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_IDLE, 1, 0);
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    check_state(MEDIA_B, NGLI_MEDIA_STARTUP_STARTING, 2, 1);
+    ngli_assert(ngli_media_scheduler_get_nb_decoders(s) == 2);
+    ngli_assert(ngli_media_scheduler_get_nb_pending(s) == 0);
+
+    /* A forced start ignores the slots */
+    ngli_assert(ngli_media_scheduler_start(s, &nodes[MEDIA_C], 1) == 0);
+    check_state(MEDIA_C, NGLI_MEDIA_STARTUP_STARTING, 2, 0);
+    ngli_assert(ngli_media_scheduler_get_nb_decoders(s) == 3);
+
+    /* Only the blocking frame requests are misses, counted per frame */
+    const int64_t t = ngli_gettime_relative();
+    ngli_assert(ngli_media_scheduler_register_frame(s, &nodes[MEDIA_B], t, t + 100000) == 0);
+    ngli_assert(ngli_media_scheduler_register_frame(s, &nodes[MEDIA_C], t, t) == 0);
+    ngli_assert(ngli_media_scheduler_get_nb_misses(s) == 1);
+    ngli_assert(ngli_media_scheduler_run(s) == 0);
+    ngli_assert(ngli_media_scheduler_get_nb_misses(s) == 0);
+
+    /* The blocking first frame request measured the startup latency of the file */
+    ngli_assert(ngli_media_scheduler_get_lead_time(s, "b.mp4") > 0.);
+
+    ngli_media_scheduler_freep(&s);
+    ngli_assert(!s);
+    return 0;
+}
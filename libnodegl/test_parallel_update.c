@@ -0,0 +1,277 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "internal.h"
+#include "parallel_update.h"
+#include "threadpool.h"
+#include "utils.h"
+
+#define NB_LEAVES 40
+#define NB_MIDS   (NB_LEAVES / 2)
+
+/*
+ * The update of a node sums its index and the values of its children, so any
+ * node updated before one of its children ends up with a different value.
+ */
+struct test_node {
+    const struct ngl_node *node;
+    int index;
+    double value;
+    int nb_updates;
+};
+
+/* Set during the parallel update, where the children must already be updated */
+static int check_children;
+
+static int test_update(struct ngl_node *node, double t)
+{
+    struct test_node *s = node->priv_data;
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    double value = s->index * t;
+    for (int i = 0; i < ngli_darray_count(&node->children); i++) {
+        struct ngl_node *child = children[i];
+        if (!child->cls->update)
+            continue;
+        if (check_children)
+            ngli_assert(child->last_update_time == t);
+        int ret = ngli_node_update(child, t);
+        if (ret < 0)
+            return ret;
+        const struct test_node *c = child->priv_data;
+        value += c->value;
+    }
+    s->value = value;
+    s->nb_updates++;
+    return 0;
+}
+
+static const struct node_class parallel_class = {
+    .name   = "Parallel",
+    .update = test_update,
+    .flags  = NGLI_NODE_FLAG_PARALLEL_UPDATE,
+};
+
+static const struct node_class serial_class = {
+    .name   = "Serial",
+    .update = test_update,
+};
+
+static const struct node_class inert_class = {
+    .name   = "Inert",
+};
+
+/* Same logic as the nodes.c update, without the node state checks */
+int ngli_node_update(struct ngl_node *node, double t)
+{
+    if (!node->cls->update || node->last_update_time == t)
+        return 0;
+    int ret = node->cls->update(node, t);
+    if (ret < 0)
+        return ret;
+    node->last_update_time = t;
+    return 0;
+}
+
+struct graph {
+    struct ngl_node leaves[NB_LEAVES];
+    struct ngl_node mids[NB_MIDS];
+    struct ngl_node top;
+    struct ngl_node serial;
+    struct ngl_node serial_parent;
+    struct ngl_node root;
+    struct test_node data[NB_LEAVES + NB_MIDS + 5];
+    int nb_nodes;
+};
+
+static void init_node(struct graph *g, struct ngl_node *node, const struct node_class *cls)
+{
+    struct test_node *data = &g->data[g->nb_nodes];
+    data->node = node;
+    data->index = g->nb_nodes++;
+    node->cls = cls;
+    node->priv_data = data;
+    node->is_active = 1;
+    node->last_update_time = -1.;
+    ngli_darray_init(&node->children, sizeof(struct ngl_node *), 0);
+}
+
+static void add_child(struct ngl_node *node, struct ngl_node *child)
+{
+    ngli_assert(ngli_darray_push(&node->children, &child));
+}
+
+/*
+ *   root (inert)
+ *   |- top (level 2)
+ *   |  `- mids (level 1)
+ *   |     |- 2 leaves (level 0)
+ *   |     `- leaves[0], shared by all the mids
+ *   |- serial_parent (serial)
+ *   |  `- serial (serial)
+ *   |     `- mids[0]
+ *   `- leaves[NB_LEAVES - 1]
+ */
+static void init_graph(struct graph *g)
+{
+    memset(g, 0, sizeof(*g));
+    for (int i = 0; i < NB_LEAVES; i++)
+        init_node(g, &g->leaves[i], &parallel_class);
+    for (int i = 0; i < NB_MIDS; i++) {
+        init_node(g, &g->mids[i], &parallel_class);
+        add_child(&g->mids[i], &g->leaves[i * 2]);
+        add_child(&g->mids[i], &g->leaves[i * 2 + 1]);
+        add_child(&g->mids[i], &g->leaves[0]);
+    }
+    init_node(g, &g->top, &parallel_class);
+    for (int i = 0; i < NB_MIDS; i++)
+        add_child(&g->top, &g->mids[i]);
+    init_node(g, &g->serial, &serial_class);
+    add_child(&g->serial, &g->mids[0]);
+    init_node(g, &g->serial_parent, &parallel_class);
+    add_child(&g->serial_parent, &g->serial);
+    init_node(g, &g->root, &inert_class);
+    add_child(&g->root, &g->top);
+    add_child(&g->root, &g->serial_parent);
+    add_child(&g->root, &g->leaves[NB_LEAVES - 1]);
+}
+
+static void reset_graph(struct graph *g)
+{
+    struct ngl_node *nodes[] = {&g->top, &g->serial, &g->serial_parent, &g->root};
+    for (int i = 0; i < NB_LEAVES; i++)
+        ngli_darray_reset(&g->leaves[i].children);
+    for (int i = 0; i < NB_MIDS; i++)
+        ngli_darray_reset(&g->mids[i].children);
+    for (int i = 0; i < NGLI_ARRAY_NB(nodes); i++)
+        ngli_darray_reset(&nodes[i]->children);
+}
+
+static int find_node(const struct parallel_update *s, const struct ngl_node *node)
+{
+    struct ngl_node **nodes = ngli_darray_data(&s->nodes);
+    int index = -1;
+    for (int i = 0; i < ngli_darray_count(&s->nodes); i++) {
+        if (nodes[i] == node) {
+            ngli_assert(index == -1);
+            index = i;
+        }
+    }
+    return index;
+}
+
+static void check_wave(const struct parallel_update *s, int wave_id, const struct ngl_node *node)
+{
+    const struct parallel_update_wave *wave = ngli_darray_get(&s->waves, wave_id);
+    const int index = find_node(s, node);
+    ngli_assert(index >= wave->start && index < wave->start + wave->count);
+}
+
+static void test_levels(struct threadpool *pool)
+{
+    struct graph g;
+    init_graph(&g);
+
+    struct parallel_update s;
+    ngli_assert(ngli_parallel_update_init(&s, pool, &g.root) == 0);
+
+    /* Only the parallel nodes not depending on a serial one are part of the waves */
+    ngli_assert(ngli_darray_count(&s.waves) == 3);
+    ngli_assert(ngli_darray_count(&s.nodes) == NB_LEAVES + NB_MIDS + 1);
+    for (int i = 0; i < NB_LEAVES; i++)
+        check_wave(&s, 0, &g.leaves[i]);
+    for (int i = 0; i < NB_MIDS; i++)
+        check_wave(&s, 1, &g.mids[i]);
+    check_wave(&s, 2, &g.top);
+    ngli_assert(find_node(&s, &g.serial) == -1);
+    ngli_assert(find_node(&s, &g.serial_parent) == -1);
+    ngli_assert(find_node(&s, &g.root) == -1);
+
+    ngli_parallel_update_reset(&s);
+    reset_graph(&g);
+}
+
+static void run_serial(struct graph *g, double t)
+{
+    ngli_assert(ngli_node_update(&g->top, t) == 0);
+    ngli_assert(ngli_node_update(&g->serial_parent, t) == 0);
+    ngli_assert(ngli_node_update(&g->leaves[NB_LEAVES - 1], t) == 0);
+}
+
+static void run_parallel(struct parallel_update *s, struct graph *g, double t)
+{
+    struct ngl_node *nodes[] = {&g->top, &g->serial, &g->serial_parent};
+    for (int i = 0; i < NB_LEAVES; i++)
+        g->leaves[i].visit_time = t;
+    for (int i = 0; i < NB_MIDS; i++)
+        g->mids[i].visit_time = t;
+    for (int i = 0; i < NGLI_ARRAY_NB(nodes); i++)
+        nodes[i]->visit_time = t;
+
+    check_children = 1;
+    ngli_assert(ngli_parallel_update_run(s, t, NULL) == 0);
+    check_children = 0;
+
+    /* The serial update completes the remaining nodes */
+    run_serial(g, t);
+}
+
+static void test_results(struct threadpool *pool)
+{
+    struct graph ref, g;
+    init_graph(&ref);
+    init_graph(&g);
+
+    struct parallel_update s;
+    ngli_assert(ngli_parallel_update_init(&s, pool, &g.root) == 0);
+
+    for (int frame = 0; frame < 10; frame++) {
+        const double t = frame / 4.;
+        for (int i = 0; i < g.nb_nodes; i++)
+            g.data[i].nb_updates = 0;
+        run_serial(&ref, t);
+        run_parallel(&s, &g, t);
+
+        /* Every node with an update callback is updated exactly once */
+        for (int i = 0; i < g.nb_nodes; i++) {
+            const struct test_node *data = &g.data[i];
+            ngli_assert(data->value == ref.data[i].value);
+            ngli_assert(data->nb_updates == (data->node->cls->update ? 1 : 0));
+        }
+    }
+
+    ngli_parallel_update_reset(&s);
+    reset_graph(&ref);
+    reset_graph(&g);
+}
+
+int main(void)
+{
+    for (int nb_threads = 1; nb_threads <= 8; nb_threads++) {
+        struct threadpool *pool = ngli_threadpool_create(nb_threads);
+        ngli_assert(pool);
+        test_levels(pool);
+        test_results(pool);
+        ngli_threadpool_freep(&pool);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+
+#include "nodegl.h"
+#include "ptrmap.h"
+#include "utils.h"
+
+/* Initial table size (see MIN_SIZE_NBIT in ptrmap.c) */
+#define SIZE_NBIT 4
+
+/* Same hash as ptrmap.c, used to pick keys colliding in the initial table */
+static uint32_t hash_ptr(const void *ptr, int size_nbit)
+{
+    const uint64_t v = (uint64_t)(uintptr_t)ptr * UINT64_C(0x9E3779B97F4A7C15);
+    return (uint32_t)(v >> (64 - size_nbit));
+}
+
+static void test_basic(void)
+{
+    static const int keys[64];
+
+    struct ptrmap *pm = ngli_ptrmap_create(4);
+    ngli_assert(pm);
+    ngli_assert(ngli_ptrmap_count(pm) == 0);
+    ngli_assert(ngli_ptrmap_get(pm, &keys[0]) == -1);
+    ngli_assert(ngli_ptrmap_get(pm, NULL) == -1);
+    ngli_assert(ngli_ptrmap_set(pm, NULL, 0) == NGL_ERROR_INVALID_ARG);
+    ngli_assert(ngli_ptrmap_set(pm, &keys[0], -1) == NGL_ERROR_INVALID_ARG);
+    ngli_assert(ngli_ptrmap_remove(pm, &keys[0]) == NGL_ERROR_NOT_FOUND);
+    ngli_assert(ngli_ptrmap_remove(pm, NULL) == NGL_ERROR_NOT_FOUND);
+
+    /* Insert enough entries to grow the table a few times */
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++) {
+        ngli_assert(ngli_ptrmap_set(pm, &keys[i], i * 2) == 0);
+        ngli_assert(ngli_ptrmap_count(pm) == i + 1);
+    }
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++)
+        ngli_assert(ngli_ptrmap_get(pm, &keys[i]) == i * 2);
+
+    /* Replace */
+    ngli_assert(ngli_ptrmap_set(pm, &keys[5], 1234) == 0);
+    ngli_assert(ngli_ptrmap_count(pm) == NGLI_ARRAY_NB(keys));
+    ngli_assert(ngli_ptrmap_get(pm, &keys[5]) == 1234);
+
+    /* Remove every other entry */
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i += 2)
+        ngli_assert(ngli_ptrmap_remove(pm, &keys[i]) == 0);
+    ngli_assert(ngli_ptrmap_count(pm) == NGLI_ARRAY_NB(keys) / 2);
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++) {
+        const int expected = i & 1 ? (i == 5 ? 1234 : i * 2) : -1;
+        ngli_assert(ngli_ptrmap_get(pm, &keys[i]) == expected);
+    }
+    ngli_assert(ngli_ptrmap_remove(pm, &keys[0]) == NGL_ERROR_NOT_FOUND);
+
+    /* Re-insert the removed entries */
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i += 2)
+        ngli_assert(ngli_ptrmap_set(pm, &keys[i], i) == 0);
+    ngli_assert(ngli_ptrmap_count(pm) == NGLI_ARRAY_NB(keys));
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i += 2)
+        ngli_assert(ngli_ptrmap_get(pm, &keys[i]) == i);
+
+    ngli_ptrmap_freep(&pm);
+    ngli_assert(!pm);
+}
+
+/* Pick the keys which hash to the given slot */
+static int pick_keys(const int *pool, int pool_size, uint32_t slot, const int **keys, int nb_keys)
+{
+    int n = 0;
+    for (int i = 0; i < pool_size && n < nb_keys; i++)
+        if (hash_ptr(&pool[i], SIZE_NBIT) == slot)
+            keys[n++] = &pool[i];
+    return n;
+}
+
+static void test_collisions(void)
+{
+    static const int pool[4096];
+
+    /*
+     * Clusters of colliding keys in the 16 slots of the initial table: 3 keys
+     * in the last slot wrap around to the first slots, and 3 keys in the
+     * first slot are moved after them
+     */
+    const int *keys[6];
+    ngli_assert(pick_keys(pool, NGLI_ARRAY_NB(pool), (1 << SIZE_NBIT) - 1, keys, 3) == 3);
+    ngli_assert(pick_keys(pool, NGLI_ARRAY_NB(pool), 0, keys + 3, 3) == 3);
+
+    struct ptrmap *pm = ngli_ptrmap_create(0);
+    ngli_assert(pm);
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++)
+        ngli_assert(ngli_ptrmap_set(pm, keys[i], i) == 0);
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++)
+        ngli_assert(ngli_ptrmap_get(pm, keys[i]) == i);
+
+    /* The entries following a removed one in its cluster remain reachable */
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++) {
+        ngli_assert(ngli_ptrmap_remove(pm, keys[i]) == 0);
+        ngli_assert(ngli_ptrmap_get(pm, keys[i]) == -1);
+        for (int j = i + 1; j < NGLI_ARRAY_NB(keys); j++)
+            ngli_assert(ngli_ptrmap_get(pm, keys[j]) == j);
+        ngli_assert(ngli_ptrmap_count(pm) == NGLI_ARRAY_NB(keys) - i - 1);
+    }
+
+    /* Same, removing the entries in the reverse order */
+    for (int i = 0; i < NGLI_ARRAY_NB(keys); i++)
+        ngli_assert(ngli_ptrmap_set(pm, keys[i], i) == 0);
+    for (int i = NGLI_ARRAY_NB(keys) - 1; i >= 0; i--) {
+        ngli_assert(ngli_ptrmap_remove(pm, keys[i]) == 0);
+        for (int j = 0; j < i; j++)
+            ngli_assert(ngli_ptrmap_get(pm, keys[j]) == j);
+    }
+    ngli_assert(ngli_ptrmap_count(pm) == 0);
+
+    ngli_ptrmap_freep(&pm);
+}
+
+int main(void)
+{
+    test_basic();
+    test_collisions();
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "block.h"
+#include "buffer.h"
+#include "gpu_ctx.h"
+#include "internal.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+/*
+ * The node updates are tested without any GPU: the buffers are provided by
+ * the fake backend below, which keeps a copy of the uploaded data and the
+ * range of the last upload
+ */
+struct buffer_test {
+    struct buffer parent;
+    uint8_t *data;
+    int nb_uploads;
+    int upload_offset;
+    int upload_size;
+};
+
+static struct buffer *test_buffer_create(struct gpu_ctx *gpu_ctx)
+{
+    struct buffer_test *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->parent.gpu_ctx = gpu_ctx;
+    return (struct buffer *)s;
+}
+
+static int test_buffer_init(struct buffer *s, int size, int usage)
+{
+    struct buffer_test *s_test = (struct buffer_test *)s;
+    s->size = size;
+    s->usage = usage;
+    s_test->data = ngli_calloc(1, size);
+    return s_test->data ? 0 : NGL_ERROR_MEMORY;
+}
+
+static int test_buffer_upload(struct buffer *s, const void *data, int size, int offset)
+{
+    struct buffer_test *s_test = (struct buffer_test *)s;
+    ngli_assert(offset >= 0 && size > 0 && offset + size <= s->size);
+    memcpy(s_test->data + offset, data, size);
+    s_test->nb_uploads++;
+    s_test->upload_offset = offset;
+    s_test->upload_size = size;
+    return 0;
+}
+
+static void test_buffer_freep(struct buffer **sp)
+{
+    struct buffer_test *s_test = (struct buffer_test *)*sp;
+    if (!s_test)
+        return;
+    ngli_free(s_test->data);
+    ngli_freep(sp);
+}
+
+static const struct gpu_ctx_class test_gpu_ctx_class = {
+    .name          = "Test",
+    .buffer_create = test_buffer_create,
+    .buffer_init   = test_buffer_init,
+    .buffer_upload = test_buffer_upload,
+    .buffer_freep  = test_buffer_freep,
+};
+
+static struct ngl_node *create_node(int type, const char *label)
+{
+    struct ngl_node *node = ngl_node_create(type);
+    ngli_assert(node);
+    ngli_assert(ngl_node_param_set_str(node, "label", label) == 0);
+    return node;
+}
+
+static struct ngl_node *create_animated(void)
+{
+    static const float keyframes[][2] = {{0, 0}, {1, 1}, {2, 1}, {3, 3}};
+    struct ngl_node *anim = create_node(NGL_NODE_ANIMATEDFLOAT, "anim");
+    for (int i = 0; i < NGLI_ARRAY_NB(keyframes); i++) {
+        struct ngl_node *kf = ngl_node_create(NGL_NODE_ANIMKEYFRAMEFLOAT);
+        ngli_assert(kf);
+        ngli_assert(ngl_node_param_set_f64(kf, "time", keyframes[i][0]) == 0);
+        ngli_assert(ngl_node_param_set_f64(kf, "value", keyframes[i][1]) == 0);
+        ngli_assert(ngl_node_param_add_nodes(anim, "keyframes", 1, &kf) == 0);
+        ngl_node_unrefp(&kf);
+    }
+    return anim;
+}
+
+static const struct block_field *get_field(const struct ngl_node *block, int index)
+{
+    const struct block_info *info = block->priv_data;
+    return ngli_darray_get(&info->block.fields, index);
+}
+
+/* Read a float component of a field from the GPU copy of the block */
+static float get_float(const struct ngl_node *block, int index, int comp)
+{
+    const struct block_info *info = block->priv_data;
+    const struct buffer_test *buffer = (const struct buffer_test *)info->buffer;
+    const int offset = get_field(block, index)->offset + comp * (int)sizeof(float);
+    float value;
+    memcpy(&value, buffer->data + offset, sizeof(value));
+    return value;
+}
+
+/* Change the data of a variable behind the back of the node graph */
+static void set_vec3(struct ngl_node *node, const float *value)
+{
+    const struct variable_info *var = node->priv_data;
+    memcpy(var->data, value, 3 * sizeof(*value));
+}
+
+/* Check the range and the number of uploads since the previous check */
+static void check_upload(const struct ngl_node *block, int nb_uploads, int offset, int size)
+{
+    struct block_info *info = block->priv_data;
+    struct buffer_test *buffer = (struct buffer_test *)info->buffer;
+    ngli_assert(buffer->nb_uploads == nb_uploads);
+    if (nb_uploads) {
+        ngli_assert(buffer->upload_offset == offset);
+        ngli_assert(buffer->upload_size == size);
+    }
+    buffer->nb_uploads = 0;
+
+    /* The GPU copy always matches the CPU data */
+    ngli_assert(!memcmp(buffer->data, info->data, info->data_size));
+}
+
+int main(void)
+{
+    struct gpu_ctx gpu_ctx = {
+        .cls      = &test_gpu_ctx_class,
+        .features = NGLI_FEATURE_UNIFORM_BUFFER,
+    };
+    struct ngl_ctx ctx = {.gpu_ctx = &gpu_ctx};
+
+    /*
+     * Block fields: a matrix computed from a transform chain (so updated by
+     * the block, but not time dependent) and a vec4
+     */
+    struct ngl_node *vector = create_node(NGL_NODE_UNIFORMVEC3, "vector");
+    ngli_assert(ngl_node_param_set_vec3(vector, "value", (const float[]){1.f, 2.f, 3.f}) == 0);
+    struct ngl_node *identity = ngl_node_create(NGL_NODE_IDENTITY);
+    ngli_assert(identity);
+    struct ngl_node *translate = ngl_node_create(NGL_NODE_TRANSLATE);
+    ngli_assert(translate);
+    ngli_assert(ngl_node_param_set_node(translate, "child", identity) == 0);
+    ngli_assert(ngl_node_param_set_node(translate, "vector", vector) == 0);
+    struct ngl_node *matrix = create_node(NGL_NODE_UNIFORMMAT4, "matrix");
+    ngli_assert(ngl_node_param_set_node(matrix, "transform", translate) == 0);
+    struct ngl_node *color = create_node(NGL_NODE_UNIFORMVEC4, "color");
+    ngli_assert(ngl_node_param_set_vec4(color, "value", (const float[]){.1f, .2f, .3f, .4f}) == 0);
+    struct ngl_node *block = create_node(NGL_NODE_BLOCK, "block");
+    struct ngl_node *fields[] = {matrix, color};
+    ngli_assert(ngl_node_param_add_nodes(block, "fields", NGLI_ARRAY_NB(fields), fields) == 0);
+
+    ngli_assert(ngli_node_attach_ctx(block, &ctx) == 0);
+    ngli_assert(block->is_static && matrix->is_static);
+    const int size = ngli_node_block_get_cpu_size(block);
+
+    /* The first update uploads the whole block */
+    ngli_assert(ngli_node_update(block, 0) == 0);
+    check_upload(block, 1, 0, size);
+    ngli_assert(get_float(block, 0, 12) == 1.f);
+    ngli_assert(get_float(block, 1, 3) == .4f);
+
+    /*
+     * The static subtree is not updated again: a change of the translation
+     * not notified through a live change is not seen
+     */
+    set_vec3(vector, (const float[]){5.f, 5.f, 5.f});
+    for (int i = 1; i <= 3; i++) {
+        ngli_assert(ngli_node_update(block, i) == 0);
+        ngli_assert(block->last_update_time == i);
+        check_upload(block, 0, 0, 0);
+        ngli_assert(get_float(block, 0, 12) == 1.f);
+    }
+
+    /* A live change honors the update of its branch once */
+    ngli_assert(ngl_node_param_set_vec3(vector, "value", (const float[]){4.f, 5.f, 6.f}) == 0);
+    ngli_assert(ngli_node_update(block, 4) == 0);
+    check_upload(block, 1, 0, size);
+    ngli_assert(get_float(block, 0, 12) == 4.f);
+    ngli_assert(get_float(block, 0, 14) == 6.f);
+    ngli_assert(ngli_node_update(block, 5) == 0);
+    check_upload(block, 0, 0, 0);
+
+    /* Adding a time dependent field makes the block updated at every frame */
+    ngli_node_detach_ctx(block, &ctx);
+    struct ngl_node *anim = create_animated();
+    ngli_assert(ngl_node_param_add_nodes(block, "fields", 1, &anim) == 0);
+    ngli_assert(ngli_node_attach_ctx(block, &ctx) == 0);
+    ngli_assert(!block->is_static && !anim->is_static && matrix->is_static);
+
+    ngli_assert(ngli_node_update(block, 0) == 0);
+    check_upload(block, 1, 0, ngli_node_block_get_cpu_size(block));
+    ngli_assert(get_float(block, 0, 12) == 4.f);
+    ngli_assert(get_float(block, 2, 0) == 0.f);
+
+    /* Only the range of the changing field is uploaded */
+    const struct block_field *anim_field = get_field(block, 2);
+    ngli_assert(ngli_node_update(block, 1) == 0);
+    check_upload(block, 1, anim_field->offset, anim_field->size);
+    ngli_assert(get_float(block, 2, 0) == 1.f);
+
+    /* Nothing is uploaded if the value does not change */
+    ngli_assert(ngli_node_update(block, 1.5) == 0);
+    check_upload(block, 0, 0, 0);
+
+    /* The static matrix is still not updated along its dynamic parent */
+    set_vec3(vector, (const float[]){7.f, 7.f, 7.f});
+    ngli_assert(ngli_node_update(block, 2.5) == 0);
+    check_upload(block, 1, anim_field->offset, anim_field->size);
+    ngli_assert(get_float(block, 0, 12) == 4.f);
+    ngli_assert(get_float(block, 2, 0) == 2.f);
+
+    ngli_node_detach_ctx(block, &ctx);
+    ngl_node_unrefp(&block);
+    ngl_node_unrefp(&anim);
+    ngl_node_unrefp(&color);
+    ngl_node_unrefp(&matrix);
+    ngl_node_unrefp(&translate);
+    ngl_node_unrefp(&identity);
+    ngl_node_unrefp(&vector);
+    return 0;
+}
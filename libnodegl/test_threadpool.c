@@ -0,0 +1,80 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "nodegl.h"
+#include "threadpool.h"
+#include "utils.h"
+
+#define NB_JOBS 1000
+#define FAILING_JOB 123
+
+struct job_ctx {
+    int nb_threads;
+    int counts[NB_JOBS];
+    int fail;
+};
+
+static int job_func(void *user_arg, int job_id, int thread_id)
+{
+    struct job_ctx *ctx = user_arg;
+    ngli_assert(job_id >= 0 && job_id < NB_JOBS);
+    ngli_assert(thread_id >= 0 && thread_id < ctx->nb_threads);
+    ctx->counts[job_id]++;
+    if (ctx->fail && job_id == FAILING_JOB)
+        return NGL_ERROR_GENERIC;
+    return 0;
+}
+
+int main(void)
+{
+    for (int nb_threads = 1; nb_threads <= 8; nb_threads++) {
+        struct threadpool *pool = ngli_threadpool_create(nb_threads);
+        ngli_assert(pool);
+        ngli_assert(ngli_threadpool_get_nb_threads(pool) == nb_threads);
+
+        struct job_ctx ctx = {.nb_threads = nb_threads};
+
+        /* Every job must be executed exactly once per execution */
+        for (int run = 0; run < 50; run++) {
+            ngli_assert(ngli_threadpool_execute(pool, job_func, &ctx, NB_JOBS) == 0);
+            for (int i = 0; i < NB_JOBS; i++)
+                ngli_assert(ctx.counts[i] == run + 1);
+        }
+
+        /* An error is reported without interrupting the other jobs */
+        memset(ctx.counts, 0, sizeof(ctx.counts));
+        ctx.fail = 1;
+        ngli_assert(ngli_threadpool_execute(pool, job_func, &ctx, NB_JOBS) == NGL_ERROR_GENERIC);
+        for (int i = 0; i < NB_JOBS; i++)
+            ngli_assert(ctx.counts[i] == 1);
+
+        ngli_assert(ngli_threadpool_execute(pool, job_func, &ctx, 0) == 0);
+
+        ngli_threadpool_freep(&pool);
+        ngli_assert(!pool);
+        printf("%d thread(s): OK\n", nb_threads);
+    }
+
+    return 0;
+}
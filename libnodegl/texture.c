@@ -37,6 +37,18 @@ int ngli_texture_upload(struct texture *s, const uint8_t *data, int linesize)
     return s->gpu_ctx->cls->texture_upload(s, data, linesize);
 }
 
+int ngli_texture_upload_borrowed(struct texture *s, const uint8_t *data, int linesize,
+                                 void (*release)(void *arg), void *arg)
+{
+    const struct gpu_ctx_class *cls = s->gpu_ctx->cls;
+    if (cls->texture_upload_borrowed)
+        return cls->texture_upload_borrowed(s, data, linesize, release, arg);
+
+    int ret = cls->texture_upload(s, data, linesize);
+    release(arg);
+    return ret;
+}
+
 int ngli_texture_generate_mipmap(struct texture *s)
 {
     return s->gpu_ctx->cls->texture_generate_mipmap(s);
@@ -95,6 +95,16 @@ int ngli_texture_init(struct texture *s,
                       const struct texture_params *params);
 
 int ngli_texture_upload(struct texture *s, const uint8_t *data, int linesize);
+
+/*
+ * Upload data which remains owned by the caller until release(arg) is called.
+ * Backends able to read the data in place (without copying it into their
+ * staging memory) defer the release until the GPU is done with it, otherwise
+ * the data is released as soon as it has been uploaded. The release callback
+ * is always called exactly once, even on failure.
+ */
+int ngli_texture_upload_borrowed(struct texture *s, const uint8_t *data, int linesize,
+                                 void (*release)(void *arg), void *arg);
 int ngli_texture_generate_mipmap(struct texture *s);
 
 void ngli_texture_freep(struct texture **sp);
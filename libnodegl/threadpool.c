@@ -0,0 +1,202 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+
+#include "memory.h"
+#include "pthread_compat.h"
+#include "threadpool.h"
+#include "utils.h"
+
+struct worker {
+    struct threadpool *pool;
+    pthread_t tid;
+    int id;
+};
+
+struct threadpool {
+    int nb_threads;
+    struct worker *workers;
+    int nb_workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond_work;
+    pthread_cond_t cond_done;
+    int64_t generation;
+    int stop;
+
+    threadpool_job_func func;
+    void *user_arg;
+    int nb_jobs;
+    int next_job;
+    int nb_done;
+    int ret;
+};
+
+/* Must be called with the lock held */
+static void run_jobs(struct threadpool *s, int thread_id)
+{
+    while (s->next_job < s->nb_jobs) {
+        const int job_id = s->next_job++;
+        const threadpool_job_func func = s->func;
+        void *user_arg = s->user_arg;
+
+        pthread_mutex_unlock(&s->lock);
+        const int ret = func(user_arg, job_id, thread_id);
+        pthread_mutex_lock(&s->lock);
+
+        if (ret < 0 && !s->ret)
+            s->ret = ret;
+        if (++s->nb_done == s->nb_jobs)
+            pthread_cond_signal(&s->cond_done);
+    }
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *worker = arg;
+    struct threadpool *s = worker->pool;
+
+    ngli_thread_set_name("ngl-pool");
+
+    int64_t generation = 0;
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (!s->stop && s->generation == generation)
+            pthread_cond_wait(&s->cond_work, &s->lock);
+        if (s->stop)
+            break;
+        generation = s->generation;
+        run_jobs(s, worker->id);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+struct threadpool *ngli_threadpool_create(int nb_threads)
+{
+    if (nb_threads < 1)
+        return NULL;
+
+    struct threadpool *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->nb_threads = nb_threads;
+
+    if (pthread_mutex_init(&s->lock, NULL)) {
+        ngli_free(s);
+        return NULL;
+    }
+    if (pthread_cond_init(&s->cond_work, NULL)) {
+        pthread_mutex_destroy(&s->lock);
+        ngli_free(s);
+        return NULL;
+    }
+    if (pthread_cond_init(&s->cond_done, NULL)) {
+        pthread_cond_destroy(&s->cond_work);
+        pthread_mutex_destroy(&s->lock);
+        ngli_free(s);
+        return NULL;
+    }
+
+    if (nb_threads > 1) {
+        s->workers = ngli_calloc(nb_threads - 1, sizeof(*s->workers));
+        if (!s->workers)
+            goto fail;
+
+        for (int i = 0; i < nb_threads - 1; i++) {
+            struct worker *worker = &s->workers[i];
+            worker->pool = s;
+            worker->id = i + 1;
+            if (pthread_create(&worker->tid, NULL, worker_thread, worker))
+                goto fail;
+            s->nb_workers++;
+        }
+    }
+
+    return s;
+
+fail:
+    ngli_threadpool_freep(&s);
+    return NULL;
+}
+
+int ngli_threadpool_get_nb_threads(const struct threadpool *s)
+{
+    return s->nb_threads;
+}
+
+int ngli_threadpool_execute(struct threadpool *s, threadpool_job_func func, void *user_arg, int nb_jobs)
+{
+    if (s->nb_threads == 1 || nb_jobs == 1) {
+        int ret = 0;
+        for (int i = 0; i < nb_jobs; i++) {
+            const int job_ret = func(user_arg, i, 0);
+            if (job_ret < 0 && !ret)
+                ret = job_ret;
+        }
+        return ret;
+    }
+
+    if (nb_jobs < 1)
+        return 0;
+
+    pthread_mutex_lock(&s->lock);
+    s->func     = func;
+    s->user_arg = user_arg;
+    s->nb_jobs  = nb_jobs;
+    s->next_job = 0;
+    s->nb_done  = 0;
+    s->ret      = 0;
+    s->generation++;
+    pthread_cond_broadcast(&s->cond_work);
+
+    run_jobs(s, 0);
+    while (s->nb_done < s->nb_jobs)
+        pthread_cond_wait(&s->cond_done, &s->lock);
+    const int ret = s->ret;
+    pthread_mutex_unlock(&s->lock);
+
+    return ret;
+}
+
+void ngli_threadpool_freep(struct threadpool **sp)
+{
+    struct threadpool *s = *sp;
+    if (!s)
+        return;
+
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->cond_work);
+    pthread_mutex_unlock(&s->lock);
+
+    for (int i = 0; i < s->nb_workers; i++)
+        pthread_join(s->workers[i].tid, NULL);
+    ngli_freep(&s->workers);
+
+    pthread_cond_destroy(&s->cond_done);
+    pthread_cond_destroy(&s->cond_work);
+    pthread_mutex_destroy(&s->lock);
+
+    ngli_freep(sp);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/*
+ * Job callback: job_id is in [0, nb_jobs) and thread_id in [0, nb_threads),
+ * 0 being the thread calling ngli_threadpool_execute(). A negative return
+ * value is reported as the execution error, the remaining jobs are still
+ * executed.
+ */
+typedef int (*threadpool_job_func)(void *user_arg, int job_id, int thread_id);
+
+struct threadpool;
+
+/*
+ * Create a pool executing the jobs on nb_threads threads, the calling thread
+ * included (nb_threads - 1 worker threads are spawned).
+ */
+struct threadpool *ngli_threadpool_create(int nb_threads);
+int ngli_threadpool_get_nb_threads(const struct threadpool *s);
+
+/*
+ * Run nb_jobs jobs across the pool threads and wait for their completion.
+ * The calling thread takes part in the execution. Return the first error
+ * reported by a job, 0 otherwise.
+ */
+int ngli_threadpool_execute(struct threadpool *s, threadpool_job_func func, void *user_arg, int nb_jobs);
+void ngli_threadpool_freep(struct threadpool **sp);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "buffer.h"
+#include "darray.h"
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "uniform_ring.h"
+#include "utils.h"
+
+#define DEFAULT_BUFFER_SIZE (1024 * 1024)
+
+struct uniform_ring_buffer {
+    struct buffer *buffer;
+    uint8_t *mapped_data;
+};
+
+struct uniform_ring_frame {
+    struct darray buffers; /* struct uniform_ring_buffer */
+    int offset;            /* position in the last buffer */
+    int next_buffer_size;
+};
+
+struct uniform_ring {
+    struct gpu_ctx *gpu_ctx;
+    struct uniform_ring_frame *frames;
+    int nb_frames;
+    int cur_frame;
+    int alignment;
+};
+
+static void free_buffers(struct uniform_ring_frame *frame)
+{
+    struct uniform_ring_buffer *buffers = ngli_darray_data(&frame->buffers);
+    for (int i = 0; i < ngli_darray_count(&frame->buffers); i++) {
+        ngli_buffer_unmap(buffers[i].buffer);
+        ngli_buffer_freep(&buffers[i].buffer);
+    }
+    ngli_darray_clear(&frame->buffers);
+}
+
+struct uniform_ring *ngli_uniform_ring_create(struct gpu_ctx *gpu_ctx, int nb_frames)
+{
+    struct uniform_ring *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+    s->alignment = NGLI_MAX(gpu_ctx->limits.min_uniform_block_offset_alignment, 1);
+
+    s->frames = ngli_calloc(nb_frames, sizeof(*s->frames));
+    if (!s->frames) {
+        ngli_free(s);
+        return NULL;
+    }
+    s->nb_frames = nb_frames;
+
+    for (int i = 0; i < nb_frames; i++) {
+        struct uniform_ring_frame *frame = &s->frames[i];
+        ngli_darray_init(&frame->buffers, sizeof(struct uniform_ring_buffer), 0);
+        frame->next_buffer_size = DEFAULT_BUFFER_SIZE;
+    }
+
+    return s;
+}
+
+void ngli_uniform_ring_begin_frame(struct uniform_ring *s, int frame_index)
+{
+    s->cur_frame = frame_index;
+
+    struct uniform_ring_frame *frame = &s->frames[frame_index];
+    frame->offset = 0;
+
+    /*
+     * The frame has overflowed its uniform buffers: merge all of them into a
+     * single one (allocated on the next allocation)
+     */
+    const int nb_buffers = ngli_darray_count(&frame->buffers);
+    if (nb_buffers > 1) {
+        int total_size = 0;
+        const struct uniform_ring_buffer *buffers = ngli_darray_data(&frame->buffers);
+        for (int i = 0; i < nb_buffers; i++)
+            total_size += buffers[i].buffer->size;
+        free_buffers(frame);
+        frame->next_buffer_size = total_size;
+        LOG(DEBUG, "uniform ring of frame %d grown to %d bytes", frame_index, total_size);
+    }
+}
+
+static int add_buffer(struct uniform_ring *s, struct uniform_ring_frame *frame, int size)
+{
+    struct uniform_ring_buffer ring_buffer = {0};
+
+    ring_buffer.buffer = ngli_buffer_create(s->gpu_ctx);
+    if (!ring_buffer.buffer)
+        return NGL_ERROR_MEMORY;
+
+    const int usage = NGLI_BUFFER_USAGE_DYNAMIC_BIT |
+                      NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                      NGLI_BUFFER_USAGE_MAP_WRITE;
+    int ret = ngli_buffer_init(ring_buffer.buffer, NGLI_MAX(size, frame->next_buffer_size), usage);
+    if (ret < 0)
+        goto fail;
+
+    ret = ngli_buffer_map(ring_buffer.buffer, ring_buffer.buffer->size, 0, (void **)&ring_buffer.mapped_data);
+    if (ret < 0)
+        goto fail;
+
+    if (!ngli_darray_push(&frame->buffers, &ring_buffer)) {
+        ngli_buffer_unmap(ring_buffer.buffer);
+        ret = NGL_ERROR_MEMORY;
+        goto fail;
+    }
+    frame->offset = 0;
+
+    return 0;
+
+fail:
+    ngli_buffer_freep(&ring_buffer.buffer);
+    return ret;
+}
+
+int ngli_uniform_ring_alloc(struct uniform_ring *s, int size, struct uniform_ring_alloc *alloc)
+{
+    struct uniform_ring_frame *frame = &s->frames[s->cur_frame];
+
+    const struct uniform_ring_buffer *buffers = ngli_darray_data(&frame->buffers);
+    int nb_buffers = ngli_darray_count(&frame->buffers);
+    int offset = (frame->offset + s->alignment - 1) / s->alignment * s->alignment;
+    if (!nb_buffers || offset + size > buffers[nb_buffers - 1].buffer->size) {
+        int ret = add_buffer(s, frame, size);
+        if (ret < 0)
+            return ret;
+        buffers = ngli_darray_data(&frame->buffers);
+        nb_buffers = ngli_darray_count(&frame->buffers);
+        offset = 0;
+    }
+
+    const struct uniform_ring_buffer *ring_buffer = &buffers[nb_buffers - 1];
+    alloc->buffer = ring_buffer->buffer;
+    alloc->offset = offset;
+    alloc->data   = ring_buffer->mapped_data + offset;
+    frame->offset = offset + size;
+
+    return 0;
+}
+
+void ngli_uniform_ring_freep(struct uniform_ring **sp)
+{
+    struct uniform_ring *s = *sp;
+    if (!s)
+        return;
+
+    for (int i = 0; i < s->nb_frames; i++) {
+        free_buffers(&s->frames[i]);
+        ngli_darray_reset(&s->frames[i].buffers);
+    }
+    ngli_freep(&s->frames);
+    ngli_freep(sp);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2022 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+#include "buffer.h"
+#include "gpu_ctx.h"
+
+/*
+ * Per-frame ring of uniform buffers from which the pipelines allocate the
+ * uniform data of each draw.
+ *
+ * Each frame slot owns a set of persistently mapped uniform buffers from
+ * which the data is linearly allocated (at the uniform buffer offset
+ * alignment), so all the draws of a frame write their uniforms one after the
+ * other and bind them with a different offset. The set is recycled when the
+ * frame slot is reused, which must only happen once the GPU is done with it.
+ * If a frame overflows its buffers, a new one is added, and the set is merged
+ * into a single larger buffer when recycled, so the steady state never
+ * allocates and always binds the same buffer. The pipelines switching to the
+ * new buffer in the middle of a frame move their following draws to another
+ * descriptor set, since the one already bound must not be updated.
+ */
+struct uniform_ring;
+
+struct uniform_ring_alloc {
+    struct buffer *buffer;
+    int offset;
+    void *data;
+};
+
+struct uniform_ring *ngli_uniform_ring_create(struct gpu_ctx *gpu_ctx, int nb_frames);
+void ngli_uniform_ring_begin_frame(struct uniform_ring *s, int frame_index);
+int ngli_uniform_ring_alloc(struct uniform_ring *s, int size, struct uniform_ring_alloc *alloc);
+void ngli_uniform_ring_freep(struct uniform_ring **sp);
+
+#endif
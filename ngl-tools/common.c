@@ -109,7 +109,7 @@ void get_viewport(int width, int height, const int *aspect_ratio, int *vp)
 
 #define BUF_SIZE 1024
 
-char *get_text_file_content(const char *filename)
+char *get_file_content(const char *filename, size_t *sizep)
 {
     char *buf = NULL;
 
@@ -138,6 +138,7 @@ char *get_text_file_content(const char *filename)
         pos += n;
         if (feof(fp)) {
             buf[pos] = 0;
+            *sizep = pos;
             break;
         }
     }
@@ -147,3 +148,9 @@ end:
         fclose(fp);
     return buf;
 }
+
+char *get_text_file_content(const char *filename)
+{
+    size_t size;
+    return get_file_content(filename, &size);
+}
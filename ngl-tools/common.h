@@ -22,6 +22,7 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define ARRAY_NB(x) ((int)(sizeof(x) / sizeof(*(x))))
@@ -35,6 +36,7 @@ double clipf64(double v, double min, double max);
 int clipi32(int v, int min, int max);
 int64_t clipi64(int64_t v, int64_t min, int64_t max);
 void get_viewport(int width, int height, const int *aspect_ratio, int *vp);
+char *get_file_content(const char *filename, size_t *sizep);
 char *get_text_file_content(const char *filename);
 
 #endif
@@ -137,6 +137,8 @@ static int send_player_signal(enum player_signal sig, const void *data, int data
     void *p = NULL;
     if (data_size) {
         p = malloc(data_size);
+        if (!p)
+            return NGL_ERROR_MEMORY;
         memcpy(p, data, data_size);
     }
 
@@ -147,8 +149,10 @@ static int send_player_signal(enum player_signal sig, const void *data, int data
             .data1 = p,
         },
     };
-    if (SDL_PushEvent(&event) != 1)
+    if (SDL_PushEvent(&event) != 1) {
         free(p);
+        return NGL_ERROR_EXTERNAL;
+    }
     return 0;
 }
 
@@ -156,8 +160,19 @@ static int handle_tag_scene(const uint8_t *data, int size)
 {
     if (size < 1 || data[size - 1] != 0) // check if string is nul-terminated
         return NGL_ERROR_INVALID_DATA;
-    const char *scene = (const char *)data;
-    return send_player_signal(PLAYER_SIGNAL_SCENE, scene, size);
+
+    /*
+     * The scene is built here, straight from the received packet and while
+     * the player keeps rendering, instead of copying the string to the player
+     * thread to parse it there.
+     */
+    struct ngl_node *scene = ngl_node_deserialize((const char *)data);
+    if (!scene)
+        return NGL_ERROR_INVALID_DATA;
+    int ret = send_player_signal(PLAYER_SIGNAL_SCENE, &scene, sizeof(scene));
+    if (ret < 0)
+        ngl_node_unrefp(&scene);
+    return ret;
 }
 
 static int file_exists(const char *filename)
@@ -44,10 +44,13 @@
 
 static struct ngl_node *get_scene(const char *filename)
 {
-    char *buf = get_text_file_content(filename);
+    size_t size;
+    char *buf = get_file_content(filename, &size);
     if (!buf)
         return NULL;
-    struct ngl_node *scene = ngl_node_deserialize(buf);
+    struct ngl_node *scene = size >= 4 && !memcmp(buf, "NGLB", 4)
+                           ? ngl_node_deserialize_binary((const uint8_t *)buf, size)
+                           : ngl_node_deserialize(buf);
     free(buf);
     return scene;
 }
@@ -68,6 +71,14 @@ struct ctx {
     struct range *ranges;
     int nb_ranges;
     int aspect[2];
+
+    /* rendering state */
+    int fd;
+    uint8_t *capture_buffer;
+    size_t capture_buffer_size;
+    int write_error;
+    const struct range *cur_range;
+    int cur_range_id;
 };
 
 static int opt_timerange(const char *arg, void *dst)
@@ -93,6 +104,61 @@ static int opt_timerange(const char *arg, void *dst)
     return 0;
 }
 
+static void capture_callback(void *arg, double t, const uint8_t *data, int size)
+{
+    struct ctx *s = arg;
+    if (s->write_error)
+        return;
+    const int n = write(s->fd, data, size);
+    if (n != size) {
+        fprintf(stderr, "unable to write frame @ t=%g to output\n", t);
+        s->write_error = 1;
+    }
+}
+
+static int frame_callback(void *arg, int index, double t)
+{
+    struct ctx *s = arg;
+    const struct range *r = s->cur_range;
+
+    if (s->debug)
+        printf("draw @ t=%f [range %d/%d: %g-%g @ %dHz]\n",
+               t, s->cur_range_id + 1, s->nb_ranges, r->start, r->start + r->duration, r->freq);
+
+    if (s->capture_buffer) {
+        const size_t n = write(s->fd, s->capture_buffer, s->capture_buffer_size);
+        if (n != s->capture_buffer_size) {
+            fprintf(stderr, "unable to write capture buffer to output\n");
+            return NGL_ERROR_IO;
+        }
+    }
+
+    return s->write_error ? NGL_ERROR_IO : 0;
+}
+
+static double *get_range_times(const struct range *r, int *nb_timesp)
+{
+    const float t0 = r->start;
+    const float t1 = r->start + r->duration;
+
+    int nb_times = 0;
+    for (;;) {
+        const float t = t0 + nb_times*1./r->freq;
+        if (t >= t1)
+            break;
+        nb_times++;
+    }
+
+    double *times = calloc(nb_times ? nb_times : 1, sizeof(*times));
+    if (!times)
+        return NULL;
+    for (int k = 0; k < nb_times; k++)
+        times[k] = (float)(t0 + k*1./r->freq);
+
+    *nb_timesp = nb_times;
+    return times;
+}
+
 #define OFFSET(x) offsetof(struct ctx, x)
 static const struct opt options[] = {
     {"-d", "--debug",         OPT_TYPE_TOGGLE,   .offset=OFFSET(debug)},
@@ -107,6 +173,9 @@ static const struct opt options[] = {
     {"-z", "--swap_interval", OPT_TYPE_INT,      .offset=OFFSET(cfg.swap_interval)},
     {"-c", "--clear_color",   OPT_TYPE_COLOR,    .offset=OFFSET(cfg.clear_color)},
     {"-m", "--samples",       OPT_TYPE_INT,      .offset=OFFSET(cfg.samples)},
+    {"-k", "--capture_depth", OPT_TYPE_INT,      .offset=OFFSET(cfg.capture_async_depth)},
+    {"-j", "--threads",       OPT_TYPE_INT,      .offset=OFFSET(cfg.nb_update_threads)},
+    {"-S", "--sort_draws",    OPT_TYPE_TOGGLE,   .offset=OFFSET(cfg.sort_draws)},
 };
 
 int main(int argc, char *argv[])
@@ -122,6 +191,7 @@ int main(int argc, char *argv[])
         .cfg.clear_color[3] = 1.f,
         .aspect[0]          = 1,
         .aspect[1]          = 1,
+        .fd                 = -1,
     };
 
     SDL_Window *window = NULL;
@@ -152,10 +222,8 @@ int main(int argc, char *argv[])
         }
     }
 
-    int fd = -1;
+    s.capture_buffer_size = 4 * s.cfg.width * s.cfg.height;
     struct ngl_ctx *ctx = NULL;
-    uint8_t *capture_buffer = NULL;
-    const size_t capture_buffer_size = 4 * s.cfg.width * s.cfg.height;
 
     struct ngl_node *scene = get_scene(s.input);
     if (!scene) {
@@ -166,22 +234,29 @@ int main(int argc, char *argv[])
     if (s.output) {
         const int stdout_output = !strcmp(s.output, "-");
         if (stdout_output) {
-            fd = dup(STDOUT_FILENO);
-            if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+            s.fd = dup(STDOUT_FILENO);
+            if (s.fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
                 ret = EXIT_FAILURE;
                 goto end;
             }
         } else {
-            fd = open(s.output, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
-            if (fd == -1) {
+            s.fd = open(s.output, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+            if (s.fd == -1) {
                 fprintf(stderr, "Unable to open %s\n", s.output);
                 ret = EXIT_FAILURE;
                 goto end;
             }
         }
-        capture_buffer = calloc(1, capture_buffer_size);
-        if (!capture_buffer)
-            goto end;
+        if (s.cfg.capture_async_depth > 0) {
+            s.cfg.capture_callback = capture_callback;
+            s.cfg.capture_callback_arg = &s;
+        } else {
+            s.capture_buffer = calloc(1, s.capture_buffer_size);
+            if (!s.capture_buffer)
+                goto end;
+        }
+    } else {
+        s.cfg.capture_async_depth = 0;
     }
 
     ctx = ngl_create();
@@ -191,7 +266,7 @@ int main(int argc, char *argv[])
     }
 
     get_viewport(s.cfg.width, s.cfg.height, s.aspect, s.cfg.viewport);
-    s.cfg.capture_buffer = capture_buffer;
+    s.cfg.capture_buffer = s.capture_buffer;
 
     if (!s.cfg.offscreen) {
         ret = wsi_set_ngl_config(&s.cfg, window);
@@ -213,52 +288,62 @@ int main(int argc, char *argv[])
         goto end;
 
     for (int i = 0; i < s.nb_ranges; i++) {
-        int k = 0;
-        const struct range *r = &s.ranges[i];
-        const float t0 = r->start;
-        const float t1 = r->start + r->duration;
+        int nb_times = 0;
+        double *times = get_range_times(&s.ranges[i], &nb_times);
+        if (!times) {
+            ret = EXIT_FAILURE;
+            goto end;
+        }
+
+        s.cur_range = &s.ranges[i];
+        s.cur_range_id = i;
 
         const int64_t start = gettime_relative();
 
-        for (;;) {
-            const float t = t0 + k*1./r->freq;
-            if (t >= t1)
-                break;
-            if (s.debug)
-                printf("draw @ t=%f [range %d/%d: %g-%g @ %dHz]\n",
-                       t, i + 1, s.nb_ranges, t0, t1, r->freq);
-            ret = ngl_draw(ctx, t);
-            if (ret < 0) {
-                fprintf(stderr, "Unable to draw @ t=%g\n", t);
-                goto end;
-            }
-            if (capture_buffer) {
-                const size_t n = write(fd, capture_buffer, capture_buffer_size);
-                if (n != capture_buffer_size) {
-                    fprintf(stderr, "unable to write capture buffer to output\n");
-                    goto end;
-                }
-            }
-            if (!s.cfg.offscreen) {
+        if (s.cfg.offscreen) {
+            ret = ngl_draw_times(ctx, times, nb_times, frame_callback, &s);
+        } else {
+            /* Window events must be processed on the main thread, so the
+             * frames are drawn one by one */
+            for (int k = 0; k < nb_times; k++) {
+                ret = ngl_draw(ctx, times[k]);
+                if (ret < 0)
+                    break;
+                ret = frame_callback(&s, k, times[k]);
+                if (ret < 0)
+                    break;
                 SDL_Event event;
                 while (SDL_PollEvent(&event)) {
                 }
             }
+        }
+        free(times);
+        if (ret < 0) {
+            fprintf(stderr, "Unable to draw range %d/%d\n", i + 1, s.nb_ranges);
+            ret = EXIT_FAILURE;
+            goto end;
+        }
 
-            k++;
+        if (s.cfg.capture_async_depth > 0) {
+            ret = ngl_flush_capture(ctx);
+            if (ret < 0 || s.write_error) {
+                fprintf(stderr, "Unable to flush captured frames\n");
+                ret = EXIT_FAILURE;
+                goto end;
+            }
         }
 
         const double tdiff = (gettime_relative() - start) / 1000000.;
-        printf("Rendered %d frames in %g (FPS=%g)\n", k, tdiff, k / tdiff);
+        printf("Rendered %d frames in %g (FPS=%g)\n", nb_times, tdiff, nb_times / tdiff);
     }
 
 end:
     ngl_freep(&ctx);
 
-    if (fd != -1)
-        close(fd);
+    if (s.fd != -1)
+        close(s.fd);
 
-    free(capture_buffer);
+    free(s.capture_buffer);
     free(s.ranges);
 
     if (!s.cfg.offscreen) {
@@ -55,7 +55,7 @@ int main(int argc, char *argv[])
     int ret = 0;
 
     if (argc != 4) {
-        fprintf(stderr, "Usage: %s <module> <scene_func> <output.ngl>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <module> <scene_func> <output.ngl|output.nglb>\n", argv[0]);
         return 0;
     }
 
@@ -69,16 +69,24 @@ int main(int argc, char *argv[])
         goto end;
     }
 
-    char *serialized_scene = ngl_node_serialize(scene);
+    /* The binary format is selected by the .nglb extension of the output */
+    const size_t olen = strlen(argv[3]);
+    const int binary = olen > 5 && !strcmp(argv[3] + olen - 5, ".nglb");
+
+    size_t size;
+    char *serialized_scene = binary ? (char *)ngl_node_serialize_binary(scene, &size)
+                                    : ngl_node_serialize(scene);
     ngl_node_unrefp(&scene);
     if (!serialized_scene) {
         ret = EXIT_FAILURE;
         goto end;
     }
 
-    const size_t slen = strlen(serialized_scene);
-    const size_t n = fwrite(serialized_scene, 1, slen, of);
-    if (n != slen) {
+    if (!binary)
+        size = strlen(serialized_scene);
+    const size_t n = fwrite(serialized_scene, 1, size, of);
+    free(serialized_scene);
+    if (n != size) {
         ret = EXIT_FAILURE;
         goto end;
     }
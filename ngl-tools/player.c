@@ -475,9 +475,13 @@ void player_uninit(struct player *p)
         return;
 
     SDL_Event event;
-    while (SDL_PollEvent(&event))
-        if (event.type == SDL_USEREVENT)
-            free(event.user.data1);
+    while (SDL_PollEvent(&event)) {
+        if (event.type != SDL_USEREVENT)
+            continue;
+        if (event.user.code == PLAYER_SIGNAL_SCENE)
+            ngl_node_unrefp(event.user.data1);
+        free(event.user.data1);
+    }
 
     ngl_freep(&p->ngl);
     SDL_DestroyWindow(p->window);
@@ -486,9 +490,9 @@ void player_uninit(struct player *p)
 
 static int handle_scene(struct player *p, const void *data)
 {
-    struct ngl_node *scene = ngl_node_deserialize(data);
-    if (!scene)
-        return NGL_ERROR_INVALID_DATA;
+    /* The signal transfers the ownership of an already de-serialized scene */
+    struct ngl_node *scene;
+    memcpy(&scene, data, sizeof(scene));
     int ret = set_scene(p, scene);
     ngl_node_unrefp(&scene);
     return ret;
@@ -36,8 +36,18 @@ class Exporter(QtCore.QThread):
     failed = QtCore.Signal(str)
     export_finished = QtCore.Signal()
 
+    # Internal signals emitted from the worker threads (the exporter thread and
+    # the node.gl rendering thread calling the draw callback), forwarded to the
+    # public ones through queued connections in the thread owning the exporter
+    _progressed = QtCore.Signal(int)
+    _failed = QtCore.Signal(str)
+    _export_finished = QtCore.Signal()
+
     def __init__(self, get_scene_func, filename, w, h, extra_enc_args=None, time=None):
         super().__init__()
+        self._progressed.connect(self.progressed, QtCore.Qt.QueuedConnection)
+        self._failed.connect(self.failed, QtCore.Qt.QueuedConnection)
+        self._export_finished.connect(self.export_finished, QtCore.Qt.QueuedConnection)
         self._get_scene_func = get_scene_func
         self._filename = filename
         self._width = w
@@ -66,16 +76,16 @@ class Exporter(QtCore.QThread):
             else:
                 ok = self._export(filename, width, height, self._extra_enc_args)
             if ok:
-                self.export_finished.emit()
+                self._export_finished.emit()
         except Exception:
-            self.failed.emit("Something went wrong while trying to encode, check encoding parameters")
+            self._failed.emit("Something went wrong while trying to encode, check encoding parameters")
 
     def _export(self, filename, width, height, extra_enc_args=None):
         fd_r, fd_w = os.pipe()
 
         cfg = self._get_scene_func()
         if not cfg:
-            self.failed.emit("You didn't select any scene to export.")
+            self._failed.emit("You didn't select any scene to export.")
             return False
 
         fps = cfg["framerate"]
@@ -116,24 +126,28 @@ class Exporter(QtCore.QThread):
         )
         ctx.set_scene_from_string(cfg["scene"])
 
-        if self._time is not None:
-            ctx.draw(self._time)
-            os.write(fd_w, capture_buffer)
-            self.progressed.emit(100)
-        else:
-            # Draw every frame
-            nb_frame = int(duration * fps[0] / fps[1])
-            for i in range(nb_frame):
-                if self._cancelled:
-                    break
-                time = i * fps[1] / float(fps[0])
-                ctx.draw(time)
+        try:
+            if self._time is not None:
+                ctx.draw(self._time)
                 os.write(fd_w, capture_buffer)
-                self.progressed.emit(i * 100 / nb_frame)
-            self.progressed.emit(100)
+                self._progressed.emit(100)
+            else:
+                # Draw every frame
+                nb_frame = int(duration * fps[0] / fps[1])
+                times = [i * fps[1] / float(fps[0]) for i in range(nb_frame)]
+
+                def frame_drawn(i, time):
+                    os.write(fd_w, capture_buffer)
+                    self._progressed.emit(i * 100 / nb_frame)
+                    return 1 if self._cancelled else 0
+
+                # An exception raised in frame_drawn() is propagated by draw_times()
+                ctx.draw_times(times, frame_drawn)
+                self._progressed.emit(100)
+        finally:
+            os.close(fd_w)
+            reader.wait()
 
-        os.close(fd_w)
-        reader.wait()
         return True
 
     def cancel(self):
@@ -171,10 +185,10 @@ def test_export():
 
     exporter = Exporter(_get_scene, filename, 320, 240)
     exporter.progressed.connect(print_progress)
+    # The progress is delivered through the event loop
+    exporter.finished.connect(app.quit)
     exporter.start()
-    exporter.wait()
-
-    app.exit()
+    app.exec()
 
 
 if __name__ == "__main__":
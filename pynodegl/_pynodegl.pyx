@@ -21,9 +21,11 @@
 #
 
 from cpython cimport array
+from cpython.bytes cimport PyBytes_FromStringAndSize
+from libc.stddef cimport size_t
 from libc.stdint cimport int32_t, uint8_t, uint32_t, uintptr_t
 from libc.stdlib cimport calloc, free
-from libc.string cimport memset
+from libc.string cimport memcpy, memset
 
 
 cdef extern from "nodegl.h":
@@ -68,6 +70,11 @@ cdef extern from "nodegl.h":
     char *ngl_node_dot(const ngl_node *node)
     char *ngl_node_serialize(const ngl_node *node)
     ngl_node *ngl_node_deserialize(const char *s)
+    ctypedef int (*ngl_read_callback_type)(void *arg, char *buf, int size)
+    ngl_node *ngl_node_deserialize_from_callback(ngl_read_callback_type read_cb, void *read_arg) nogil
+    ngl_node *ngl_node_deserialize_from_fd(int fd) nogil
+    uint8_t *ngl_node_serialize_binary(const ngl_node *node, size_t *sizep)
+    ngl_node *ngl_node_deserialize_binary(const uint8_t *data, size_t size)
 
     int ngl_anim_evaluate(ngl_node *anim, void *dst, double t)
 
@@ -123,6 +130,12 @@ cdef extern from "nodegl.h":
 
     cdef struct ngl_ctx
 
+    cdef int NGL_ERROR_EXTERNAL
+    cdef int NGL_ERROR_INVALID_DATA
+
+    ctypedef void (*ngl_capture_callback_type)(void *arg, double t, const uint8_t *data, int size)
+    ctypedef int (*ngl_draw_callback_type)(void *arg, int index, double t)
+
     cdef struct ngl_config_gl:
         int external
         uint32_t external_framebuffer
@@ -148,6 +161,15 @@ cdef extern from "nodegl.h":
         int hud_refresh_rate[2]
         const char *hud_export_filename
         int hud_scale
+        const char *program_cache_dir
+        int capture_async_depth
+        ngl_capture_callback_type capture_callback
+        void *capture_callback_arg
+        int nb_update_threads
+        ngl_ctx *shared_ctx
+        int sort_draws
+        int max_media_startups
+        int max_media_decoders
 
     cdef union ngl_livectl_data:
         float f[4]
@@ -168,15 +190,18 @@ cdef extern from "nodegl.h":
     int ngl_backends_probe(const ngl_config *user_config, int *nb_backendsp, ngl_backend **backendsp)
     int ngl_backends_get(const ngl_config *user_config, int *nb_backendsp, ngl_backend **backendsp)
     void ngl_backends_freep(ngl_backend **backendsp)
-    int ngl_configure(ngl_ctx *s, ngl_config *config)
+    int ngl_configure(ngl_ctx *s, ngl_config *config) nogil
     int ngl_resize(ngl_ctx *s, int width, int height, const int *viewport)
     int ngl_set_capture_buffer(ngl_ctx *s, void *capture_buffer)
+    int ngl_flush_capture(ngl_ctx *s) nogil
     int ngl_set_scene(ngl_ctx *s, ngl_node *scene)
     int ngl_draw(ngl_ctx *s, double t) nogil
+    int ngl_draw_times(ngl_ctx *s, const double *times, int nb_times,
+                       ngl_draw_callback_type callback, void *arg) nogil
     char *ngl_dot(ngl_ctx *s, double t) nogil
     int ngl_livectls_get(ngl_node *scene, int *nb_livectlsp, ngl_livectl **livectlsp)
     void ngl_livectls_freep(ngl_livectl **livectlsp)
-    void ngl_freep(ngl_ctx **ss)
+    void ngl_freep(ngl_ctx **ss) nogil
 
     int ngl_easing_evaluate(const char *name, const double *args, int nb_args,
                             const double *offsets, double t, double *v)
@@ -263,6 +288,17 @@ cdef class _Node:
     def serialize(self):
         return _ret_pystr(ngl_node_serialize(self.ctx))
 
+    def serialize_binary(self):
+        cdef size_t size = 0
+        cdef uint8_t *data = ngl_node_serialize_binary(self.ctx, &size)
+        if data is NULL:
+            raise MemoryError()
+        try:
+            ret = <bytes>data[:size]
+        finally:
+            free(data)
+        return ret
+
     def dot(self):
         return _ret_pystr(ngl_node_dot(self.ctx))
 
@@ -558,9 +594,42 @@ cdef class ConfigGL:
         return <uintptr_t>&self.config
 
 
+cdef void _capture_callback(void *arg, double t, const uint8_t *data, int size) with gil:
+    (<object>arg)(t, PyBytes_FromStringAndSize(<const char *>data, size))
+
+
+cdef int _draw_callback(void *arg, int index, double t) with gil:
+    # The exception raised by the user callback aborts the batch and is
+    # re-raised once ngl_draw_times() returns
+    state = <object>arg
+    try:
+        ret = state[0](index, t)
+    except BaseException as e:
+        state[1] = e
+        return NGL_ERROR_EXTERNAL
+    return 0 if ret is None else ret
+
+
+cdef int _read_callback(void *arg, char *buf, int size) with gil:
+    # Same as the draw callback: the exception raised by the user callback
+    # aborts the deserialization and is re-raised by the caller
+    state = <object>arg
+    try:
+        data = bytes(state[0](size))
+        if len(data) > size:
+            raise ValueError(f"read callback returned {len(data)} bytes, more than the {size} requested")
+    except BaseException as e:
+        state[1] = e
+        return NGL_ERROR_EXTERNAL
+    memcpy(buf, <const char *>data, len(data))
+    return len(data)
+
+
 cdef class Context:
     cdef ngl_ctx *ctx
     cdef object capture_buffer
+    cdef object capture_callback
+    cdef object shared_ctx
 
     def __cinit__(self):
         self.ctx = ngl_create()
@@ -603,12 +672,35 @@ cdef class Context:
         if hud_export_filename is not None:
             config.hud_export_filename = hud_export_filename
         config.hud_scale = kwargs.get('hud_scale', 0)
+        program_cache_dir = kwargs.get('program_cache_dir')
+        if program_cache_dir is not None:
+            config.program_cache_dir = program_cache_dir
+        config.capture_async_depth = kwargs.get('capture_async_depth', 0)
+        capture_callback = kwargs.get('capture_callback')
+        if capture_callback is not None:
+            config.capture_callback = _capture_callback
+            config.capture_callback_arg = <void *>capture_callback
+        config.nb_update_threads = kwargs.get('nb_update_threads', 0)
+        config.sort_draws = kwargs.get('sort_draws', 0)
+        config.max_media_startups = kwargs.get('max_media_startups', 0)
+        config.max_media_decoders = kwargs.get('max_media_decoders', 0)
+        cdef Context shared_ctx = kwargs.get('shared_ctx')
+        if shared_ctx is not None:
+            config.shared_ctx = shared_ctx.ctx
 
     def configure(self, **kwargs):
         self.capture_buffer = kwargs.get('capture_buffer')
         cdef ngl_config config
         Context._init_ngl_config_from_dict(&config, kwargs)
-        return ngl_configure(self.ctx, &config)
+        # The pending asynchronous captures are delivered from the node.gl
+        # thread while reconfiguring, the GIL must not be held meanwhile
+        with nogil:
+            ret = ngl_configure(self.ctx, &config)
+        # The previous callback may still be called while configuring
+        self.capture_callback = kwargs.get('capture_callback')
+        # The shared context must outlive this one
+        self.shared_ctx = kwargs.get('shared_ctx')
+        return ret
 
     def resize(self, width, height, viewport=None):
         if viewport is None:
@@ -625,6 +717,11 @@ cdef class Context:
             ptr = <uint8_t *>self.capture_buffer
         return ngl_set_capture_buffer(self.ctx, ptr)
 
+    def flush_capture(self):
+        with nogil:
+            ret = ngl_flush_capture(self.ctx)
+        return ret
+
     def set_scene(self, _Node scene):
         return ngl_set_scene(self.ctx, NULL if scene is None else scene.ctx)
 
@@ -634,11 +731,65 @@ cdef class Context:
         ngl_node_unrefp(&scene)
         return ret
 
+    def set_scene_from_binary(self, const uint8_t[:] data):
+        cdef ngl_node *scene = ngl_node_deserialize_binary(&data[0], data.shape[0]) if data.shape[0] else NULL
+        if data.shape[0] and scene is NULL:
+            return NGL_ERROR_INVALID_DATA
+        ret = ngl_set_scene(self.ctx, scene)
+        ngl_node_unrefp(&scene)
+        return ret
+
+    def set_scene_from_fd(self, int fd):
+        cdef ngl_node *scene
+        with nogil:
+            scene = ngl_node_deserialize_from_fd(fd)
+        if scene is NULL:
+            return NGL_ERROR_INVALID_DATA
+        ret = ngl_set_scene(self.ctx, scene)
+        ngl_node_unrefp(&scene)
+        return ret
+
+    def set_scene_from_callback(self, read):
+        cdef ngl_node *scene
+        state = [read, None]
+        cdef void *c_arg = <void *>state
+        with nogil:
+            scene = ngl_node_deserialize_from_callback(_read_callback, c_arg)
+        if state[1] is not None:
+            ngl_node_unrefp(&scene)
+            raise state[1]
+        if scene is NULL:
+            return NGL_ERROR_INVALID_DATA
+        ret = ngl_set_scene(self.ctx, scene)
+        ngl_node_unrefp(&scene)
+        return ret
+
     def draw(self, double t):
         with nogil:
             ret = ngl_draw(self.ctx, t)
         return ret
 
+    def draw_times(self, times, callback=None):
+        cdef int nb_times = len(times)
+        cdef double *times_c = <double *>calloc(max(nb_times, 1), sizeof(double))
+        if times_c is NULL:
+            raise MemoryError()
+        cdef int i
+        for i, t in enumerate(times):
+            times_c[i] = t
+        cdef ngl_draw_callback_type c_callback = NULL
+        cdef void *c_arg = NULL
+        state = [callback, None]
+        if callback is not None:
+            c_callback = _draw_callback
+            c_arg = <void *>state
+        with nogil:
+            ret = ngl_draw_times(self.ctx, times_c, nb_times, c_callback, c_arg)
+        free(times_c)
+        if state[1] is not None:
+            raise state[1]
+        return ret
+
     def dot(self, double t):
         cdef char *s
         with nogil:
@@ -646,7 +797,9 @@ cdef class Context:
         return _ret_pystr(s) if s else None
 
     def __dealloc__(self):
-        ngl_freep(&self.ctx)
+        # Same as configure(): the pending captures are delivered on destroy
+        with nogil:
+            ngl_freep(&self.ctx)
 
     def gl_wrap_framebuffer(self, uint32_t framebuffer):
         return ngl_gl_wrap_framebuffer(self.ctx, framebuffer)
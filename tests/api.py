@@ -24,6 +24,7 @@ import os
 import random
 
 from pynodegl_utils.misc import get_backend
+from pynodegl_utils.toolbox.colors import COLORS
 from pynodegl_utils.toolbox.grid import autogrid_simple
 
 import pynodegl as ngl
@@ -36,6 +37,13 @@ def _get_scene(geometry=None):
     return ngl.RenderColor(geometry=ngl.Quad() if geometry is None else geometry)
 
 
+def _read_hud_export(filename):
+    import csv
+
+    with open(filename, newline="") as f:
+        return [{key: float(value) for key, value in row.items()} for row in csv.DictReader(f)]
+
+
 def api_backend():
     ctx = ngl.Context()
     ret = ctx.configure(backend=0x1234)
@@ -122,6 +130,143 @@ def api_capture_buffer(width=16, height=16):
     del ctx
 
 
+def _get_animated_scene():
+    color = ngl.AnimatedColor(
+        [
+            ngl.AnimKeyFrameColor(0, (1, 0, 0)),
+            ngl.AnimKeyFrameColor(1, (0, 0, 1)),
+        ]
+    )
+    return ngl.RenderColor(color)
+
+
+def api_capture_async(width=16, height=16, depth=3):
+    times = [i / 8 for i in range(9)]
+
+    # Synchronous captures used as reference
+    capture_buffer = bytearray(width * height * 4)
+    ctx = ngl.Context()
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    assert ret == 0
+    assert ctx.set_scene(_get_animated_scene()) == 0
+    expected = []
+    for t in times:
+        assert ctx.draw(t) == 0
+        expected.append((t, bytes(capture_buffer)))
+    del ctx
+
+    captured = []
+
+    def capture(t, data):
+        captured.append((t, data))
+
+    config = dict(
+        offscreen=1,
+        width=width,
+        height=height,
+        backend=_backend,
+        capture_async_depth=depth,
+        capture_callback=capture,
+    )
+    ctx = ngl.Context()
+    assert ctx.configure(**config) == 0
+    assert ctx.set_scene(_get_animated_scene()) == 0
+
+    # The frames are delivered in order, at most depth draws later
+    for i, t in enumerate(times[:5]):
+        assert ctx.draw(t) == 0
+        assert len(captured) >= i + 1 - depth
+    assert ctx.flush_capture() == 0
+    assert captured == expected[:5]
+
+    # The pending frames are delivered when reconfiguring...
+    for t in times[5:7]:
+        assert ctx.draw(t) == 0
+    assert ctx.configure(**config) == 0
+    assert captured == expected[:7]
+
+    # ...and when destroying the context
+    for t in times[7:]:
+        assert ctx.draw(t) == 0
+    del ctx
+    assert captured == expected
+
+
+def _get_parallel_update_scene(nb_tiles=64):
+    t = ngl.Time()
+    scenes = []
+    for i in range(nb_tiles):
+        anim = ngl.AnimatedFloat([ngl.AnimKeyFrameFloat(0, 0), ngl.AnimKeyFrameFloat(1, i / nb_tiles)])
+        color = ngl.EvalVec3(expr0="sat(a + n)", expr1="fract(t * 3 + a)", expr2="abs(sin(t + n))")
+        color.update_resources(t=t, a=anim, n=ngl.NoiseFloat(seed=i))
+        scenes.append(ngl.RenderColor(color))
+    return autogrid_simple(scenes)
+
+
+def api_parallel_update(width=64, height=64):
+    times = [i / 8 for i in range(9)]
+
+    captures = {}
+    for nb_update_threads in (0, 4):
+        capture_buffer = bytearray(width * height * 4)
+        ctx = ngl.Context()
+        ret = ctx.configure(
+            offscreen=1,
+            width=width,
+            height=height,
+            backend=_backend,
+            capture_buffer=capture_buffer,
+            nb_update_threads=nb_update_threads,
+        )
+        assert ret == 0
+        assert ctx.set_scene(_get_parallel_update_scene()) == 0
+        captures[nb_update_threads] = []
+        for t in times:
+            assert ctx.draw(t) == 0
+            captures[nb_update_threads].append(bytes(capture_buffer))
+        del ctx
+
+    # The parallel update must render exactly the same frames as the serial one
+    assert captures[4] == captures[0]
+    assert len(set(captures[0])) > 1
+
+
+def api_draw_times(width=16, height=16):
+    ctx = ngl.Context()
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend)
+    assert ret == 0
+    assert ctx.set_scene(_get_scene()) == 0
+
+    times = [0.0, 0.5, 1.0, 1.5]
+    drawn = []
+
+    def frame_drawn(index, t):
+        drawn.append((index, t))
+
+    assert ctx.draw_times(times, frame_drawn) == 0
+    assert drawn == list(enumerate(times))
+
+    # A positive return value stops the batch
+    drawn = []
+    assert ctx.draw_times(times, lambda index, t: drawn.append(index) or int(index == 1)) == 0
+    assert drawn == [0, 1]
+
+    # An exception raised by the callback stops the batch and is propagated
+    def frame_failed(index, t):
+        drawn.append(index)
+        raise ValueError("frame %d" % index)
+
+    drawn = []
+    try:
+        ctx.draw_times(times, frame_failed)
+    except ValueError as e:
+        assert str(e) == "frame 0"
+    else:
+        assert False
+    assert drawn == [0]
+    del ctx
+
+
 def api_ctx_ownership():
     ctx = ngl.Context()
     ctx2 = ngl.Context()
@@ -160,6 +305,419 @@ def api_ctx_ownership_subgraph():
         del ctx2
 
 
+def api_shared_ctx(width=16, height=16):
+    import tempfile
+    import zlib
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        cache_dir = os.path.join(tmpdir, "programs")
+        os.mkdir(cache_dir)
+        hud_exports = [os.path.join(tmpdir, f"hud{i}.csv") for i in range(2)]
+
+        ctx = ngl.Context()
+        ret = ctx.configure(
+            offscreen=1,
+            width=width,
+            height=height,
+            backend=_backend,
+            program_cache_dir=cache_dir,
+            hud=1,
+            hud_export_filename=hud_exports[0],
+        )
+        assert ret == 0
+        assert ctx.set_scene(_get_scene()) == 0
+        assert ctx.draw(0) == 0
+
+        capture_buffer = bytearray(width * height * 4)
+        ctx2 = ngl.Context()
+        ret = ctx2.configure(
+            offscreen=1,
+            width=width,
+            height=height,
+            backend=_backend,
+            capture_buffer=capture_buffer,
+            shared_ctx=ctx,
+            program_cache_dir=cache_dir,
+            hud=1,
+            hud_export_filename=hud_exports[1],
+        )
+        assert ret == 0
+        assert ctx2.set_scene(_get_scene()) == 0
+        assert ctx2.draw(0) == 0
+        assert ctx.draw(1) == 0
+        assert zlib.crc32(capture_buffer) == 0xB4BD32FA
+        del ctx2
+        del ctx
+
+        stats = [_read_hud_export(filename)[-1] for filename in hud_exports]
+
+    # The program of the second context is not compiled again: it is either
+    # taken from the shared context (Vulkan) or loaded from the binary stored
+    # by the shared context (OpenGL, if program binaries are supported)
+    if stats[0]["Prog. misses"]:
+        assert stats[1]["Prog. misses"] == 0
+
+
+def api_shared_ctx_fail():
+    ctx = ngl.Context()
+    ctx2 = ngl.Context()
+    ret = ctx2.configure(offscreen=1, width=16, height=16, backend=_backend, shared_ctx=ctx)
+    assert ret != 0
+    del ctx2
+    del ctx
+
+
+def _get_depth_scene():
+    # Overlapping depth-tested draws alternating between two programs, with
+    # each render node drawn twice so the sorting can share the pipeline binds
+    quad = ngl.Quad((-0.5, -0.5, 0), (1, 0, 0), (0, 1, 0))
+    render_color = ngl.RenderColor(COLORS.red, geometry=quad)
+    render_gradient = ngl.RenderGradient(color0=COLORS.green, color1=COLORS.blue, geometry=quad)
+    group = ngl.Group()
+    for i in range(4):
+        render = render_gradient if i % 2 else render_color
+        offset = -0.375 + 0.25 * i
+        depth = 0.5 - 0.125 * ((i * 3) % 4)
+        group.add_children(ngl.Translate(render, vector=(offset, offset, depth)))
+    return ngl.GraphicConfig(group, depth_test=True, depth_write_mask=True, depth_func="less")
+
+
+def _sort_draws_capture(scene, sort_draws, width, height, hud_export=None):
+    import zlib
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    hud_params = dict(hud=1, hud_export_filename=hud_export) if hud_export else {}
+    ret = ctx.configure(
+        offscreen=1,
+        width=width,
+        height=height,
+        backend=_backend,
+        capture_buffer=capture_buffer,
+        sort_draws=sort_draws,
+        **hud_params,
+    )
+    assert ret == 0
+    assert ctx.set_scene(scene) == 0
+    assert ctx.draw(0) == 0
+    del ctx
+    return zlib.crc32(capture_buffer)
+
+
+def api_sort_draws(width=16, height=16):
+    import tempfile
+
+    assert _sort_draws_capture(_get_scene(), 1, width, height) == 0xB4BD32FA
+
+    # The sorted draws must render exactly like the draws in recording order
+    crc = _sort_draws_capture(_get_depth_scene(), 0, width, height)
+    assert _sort_draws_capture(_get_depth_scene(), 1, width, height) == crc
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        hud_exports = [os.path.join(tmpdir, f"hud{i}.csv") for i in range(2)]
+        for sort_draws, hud_export in enumerate(hud_exports):
+            _sort_draws_capture(_get_depth_scene(), sort_draws, width, height, hud_export)
+        stats = [_read_hud_export(hud_export)[-1] for hud_export in hud_exports]
+
+    # Without sorting, nothing is saved. With sorting, the 4 interleaved draws
+    # only need 2 pipeline binds, unless the backend does not record the draws
+    # (the draw list is currently only available with Vulkan)
+    assert stats[0]["Binds saved"] == 0
+    assert stats[1]["Binds saved"] in (0, 2)
+    if _backend == ngl.BACKEND_VULKAN:
+        assert stats[1]["Binds saved"] == 2
+
+
+def api_media_startups(width=16, height=16):
+    import tempfile
+
+    ctx = ngl.Context()
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, max_media_startups=-1)
+    assert ret != 0
+
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, max_media_decoders=-1)
+    assert ret != 0
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        hud_export = os.path.join(tmpdir, "hud.csv")
+        ret = ctx.configure(
+            offscreen=1,
+            width=width,
+            height=height,
+            backend=_backend,
+            max_media_startups=1,
+            max_media_decoders=2,
+            hud=1,
+            hud_export_filename=hud_export,
+        )
+        assert ret == 0
+
+        # Medias prefetched at the same time, only one of them can start right away
+        # and only two of them can run at once
+        children = []
+        for i in range(3):
+            m = ngl.Media("/dev/null")
+            render = ngl.RenderTexture(ngl.Texture2D(data_src=m))
+            ranges = (ngl.TimeRangeModeNoop(0), ngl.TimeRangeModeCont(1 + i), ngl.TimeRangeModeNoop(2 + i))
+            children.append(ngl.TimeRangeFilter(render, ranges=ranges, prefetch_time=3))
+        assert ctx.set_scene(ngl.Group(children=children)) == 0
+        for t in (0, 1, 2, 3, 4, 5):
+            assert ctx.draw(t) == 0
+        del ctx
+
+        stats = _read_hud_export(hud_export)
+        assert len(stats) == 6
+
+        # No frame is requested yet: the first prefetched media holds the only
+        # startup slot and the others are queued
+        assert stats[0]["Media decoders"] == 1
+        assert stats[0]["Media pending"] == 2
+        assert stats[0]["Media misses"] == 0
+
+        assert all(row["Media decoders"] <= 2 for row in stats)
+
+
+def api_imagesequence(width=16, height=16):
+    import tempfile
+    import zlib
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    assert ret == 0
+
+    colors = (b"\xff\x00\x00\xff", b"\x00\xff\x00\xff", b"\x00\x00\xff\xff")
+    with tempfile.TemporaryDirectory() as tmpdir:
+        for i, color in enumerate(colors, 10):
+            with open(os.path.join(tmpdir, f"frame_{i:03d}.raw"), "wb") as f:
+                f.write(color * 4)
+
+        pattern = os.path.join(tmpdir, "frame_%03d.raw")
+        imgseq = ngl.ImageSequence(pattern, start_number=10, nb_frames=len(colors), framerate=(1, 1), width=2, height=2)
+        assert ctx.set_scene(ngl.RenderTexture(ngl.Texture2D(data_src=imgseq))) == 0
+
+        # Each frame is displayed, backward accesses included, and the last one
+        # is held past the end of the sequence
+        crcs = []
+        for t in (0, 1, 2, 0, 5):
+            assert ctx.draw(t) == 0
+            crcs.append(zlib.crc32(capture_buffer))
+        assert len(set(crcs[:3])) == 3
+        assert crcs[3] == crcs[0]
+        assert crcs[4] == crcs[2]
+
+        # Missing frame file
+        imgseq = ngl.ImageSequence(pattern, start_number=11, nb_frames=3, width=2, height=2)
+        assert ctx.set_scene(ngl.RenderTexture(ngl.Texture2D(data_src=imgseq))) == 0
+        assert ctx.draw(0) == 0
+        assert _ret_to_fourcc(ctx.draw(2)) == "Eio "  # I/O error
+
+        # The failed frame is retried once its file shows up
+        with open(os.path.join(tmpdir, "frame_013.raw"), "wb") as f:
+            f.write(colors[0] * 4)
+        assert ctx.draw(2) == 0
+        assert zlib.crc32(capture_buffer) == crcs[0]
+
+        # The pattern is not used as a format string
+        imgseq = ngl.ImageSequence(os.path.join(tmpdir, "frame_%s.raw"), nb_frames=1, width=2, height=2)
+        assert ctx.set_scene(ngl.RenderTexture(ngl.Texture2D(data_src=imgseq))) == 0
+        assert _ret_to_fourcc(ctx.draw(0)) == "Earg"  # Invalid argument
+
+        del ctx
+
+
+def api_serialize_binary(width=16, height=16):
+    import array
+    import zlib
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    assert ret == 0
+
+    # The scene covers the data, node list, f64 list and animated parameters
+    vertices = ngl.BufferVec3(data=array.array("f", (-1, -1, 0, 1, -1, 0, 0, 1, 0)))
+    uvcoords = ngl.BufferVec2(data=array.array("f", (0, 0, 1, 0, 0.5, 1)))
+    color = ngl.AnimatedColor(
+        [
+            ngl.AnimKeyFrameColor(0, (1, 0, 0)),
+            ngl.AnimKeyFrameColor(2, (0, 0, 1), "back_in", (1.5,)),
+        ]
+    )
+    render = ngl.RenderColor(color, geometry=ngl.Geometry(vertices, uvcoords=uvcoords))
+    scene = ngl.Group(children=(render, ngl.Translate(render, vector=(0.5, 0, 0))))
+
+    data = scene.serialize_binary()
+    assert data[:4] == b"NGLB"
+    assert scene.serialize_binary() == data
+
+    crcs = []
+    for t in (0, 1, 2):
+        assert ctx.set_scene(scene) == 0
+        assert ctx.draw(t) == 0
+        ref_crc = zlib.crc32(capture_buffer)
+        assert ctx.set_scene_from_binary(data) == 0
+        assert ctx.draw(t) == 0
+        assert zlib.crc32(capture_buffer) == ref_crc
+        crcs.append(ref_crc)
+    assert len(set(crcs)) == 3
+
+    del ctx
+
+
+def api_deserialize_streams(width=16, height=16):
+    import io
+    import threading
+    import zlib
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    assert ret == 0
+
+    color = ngl.AnimatedColor([ngl.AnimKeyFrameColor(0, (1, 0, 0)), ngl.AnimKeyFrameColor(1, (0, 0, 1))])
+    render = ngl.RenderColor(color, geometry=ngl.Circle(radius=0.5, npoints=64))
+    scene = ngl.Group(children=(render, ngl.Translate(render, vector=(0.5, 0, 0))))
+    data = scene.serialize()
+
+    assert ctx.set_scene_from_string(data) == 0
+    assert ctx.draw(0.5) == 0
+    ref_crc = zlib.crc32(capture_buffer)
+
+    def check_capture():
+        assert ctx.draw(0.5) == 0
+        assert zlib.crc32(capture_buffer) == ref_crc
+        assert ctx.set_scene(None) == 0
+
+    # The lines are split across reads of a single byte
+    reader = io.BytesIO(data)
+    assert ctx.set_scene_from_callback(lambda size: reader.read(1)) == 0
+    check_capture()
+
+    # The writer may need several reads to go through the pipe
+    fd_r, fd_w = os.pipe()
+
+    def write_scene():
+        with os.fdopen(fd_w, "wb") as f:
+            f.write(data)
+
+    writer = threading.Thread(target=write_scene)
+    writer.start()
+    try:
+        assert ctx.set_scene_from_fd(fd_r) == 0
+    finally:
+        writer.join()
+        os.close(fd_r)
+    check_capture()
+
+    # Trailing blank lines are ignored
+    for trailing in (b"\n", b"\n \n\t\r\n"):
+        reader = io.BytesIO(data + trailing)
+        assert ctx.set_scene_from_callback(reader.read) == 0
+        check_capture()
+
+    # Only the end of the stream ends the scene, any other short or blank line is an error
+    lines = data.splitlines(keepends=True)
+    for invalid in (
+        data + b"abc",
+        data + b"\n" + lines[-1],
+        b"".join(lines[:2]) + b"\n" + b"".join(lines[2:]),
+    ):
+        reader = io.BytesIO(invalid)
+        assert _ret_to_fourcc(ctx.set_scene_from_callback(reader.read)) == "Edat"  # Invalid data
+
+    # The exceptions raised by the read callback are propagated
+    def failing_read(size):
+        raise RuntimeError("read failure")
+
+    try:
+        ctx.set_scene_from_callback(failing_read)
+    except RuntimeError:
+        pass
+    else:
+        assert False
+
+    del ctx
+
+
+def _nglb_node(node_type, params=()):
+    import struct
+
+    node = struct.pack("<II", node_type, len(params))
+    for key, value in params:
+        node += struct.pack("<B", len(key)) + key + struct.pack("<BI", 0, len(value)) + value
+    return node
+
+
+def _nglb(lib_version, nodes, data=b"", nb_nodes=None):
+    import struct
+
+    table = b"".join(nodes)
+    padding = -(32 + len(table)) % 16
+    data_offset = 32 + len(table) + padding
+    nb_nodes = len(nodes) if nb_nodes is None else nb_nodes
+    header = struct.pack("<4sIIIQQ", b"NGLB", 1, lib_version, nb_nodes, data_offset, len(data))
+    return header + table + bytes(padding) + data
+
+
+def api_serialize_binary_invalid(width=16, height=16):
+    import struct
+
+    ctx = ngl.Context()
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend)
+    assert ret == 0
+
+    def get_type(node):
+        return struct.unpack("<I", node.serialize_binary()[32:36])[0]
+
+    lib_version = struct.unpack("<I", ngl.Identity().serialize_binary()[8:12])[0]
+    identity = _nglb_node(get_type(ngl.Identity()))
+    group_type = get_type(ngl.Group())
+    buffer_type = get_type(ngl.BufferFloat())
+    keyframe_type = get_type(ngl.AnimKeyFrameFloat(0, 0))
+
+    def group(*indexes):
+        return _nglb_node(group_type, [(b"children", struct.pack(f"<I{len(indexes)}I", len(indexes), *indexes))])
+
+    def buffer(offset, size):
+        return _nglb_node(buffer_type, [(b"data", struct.pack("<QQ", offset, size))])
+
+    def keyframe(count, args):
+        return _nglb_node(
+            keyframe_type,
+            [(b"easing", b"back_in"), (b"easing_args", struct.pack(f"<I{len(args)}d", count, *args))],
+        )
+
+    # Hand-crafted valid scenes, the invalid ones below are derived from them
+    valid_group = _nglb(lib_version, [identity, group(0)])
+    assert ctx.set_scene_from_binary(valid_group) == 0
+    assert ctx.set_scene_from_binary(_nglb(lib_version, [buffer(0, 8)], bytes(8))) == 0
+    assert ctx.set_scene_from_binary(_nglb(lib_version, [keyframe(1, (1.5,))])) == 0
+
+    invalid_scenes = (
+        # Truncated headers
+        valid_group[:4],
+        valid_group[:31],
+        # Node table shorter than announced
+        _nglb(lib_version, [identity, group(0)], nb_nodes=3),
+        # Out of range, self and forward node references
+        _nglb(lib_version, [identity, group(5)]),
+        _nglb(lib_version, [identity, group(1)]),
+        _nglb(lib_version, [group(1), identity]),
+        # Data out of the data section
+        _nglb(lib_version, [buffer(16, 8)], bytes(8)),
+        _nglb(lib_version, [buffer(0, 16)], bytes(8)),
+        _nglb(lib_version, [buffer(0, 8)], bytes(8))[:-1],
+        # More list elements than the value holds
+        _nglb(lib_version, [keyframe(0x10000000, (1.5,))]),
+        _nglb(lib_version, [keyframe(2, (1.5,))]),
+    )
+    for data in invalid_scenes:
+        assert _ret_to_fourcc(ctx.set_scene_from_binary(data)) == "Edat"  # Invalid data
+
+    del ctx
+
+
 def api_capture_buffer_lifetime(width=1024, height=1024):
     capture_buffer = bytearray(width * height * 4)
     ctx = ngl.Context()
@@ -228,6 +786,54 @@ def api_media_sharing_failure():
     assert _ret_to_fourcc(ctx.set_scene(scene)) == "Eusg"  # Usage error
 
 
+def _write_audio_file(filename, duration=1, rate=44100):
+    import struct
+    import wave
+
+    with wave.open(filename, "wb") as f:
+        f.setnchannels(2)
+        f.setsampwidth(2)
+        f.setframerate(rate)
+        samples = (int(32767 * math.sin(2 * math.pi * 440 * i / rate)) for i in range(duration * rate))
+        f.writeframes(b"".join(struct.pack("<hh", x, -x) for x in samples))
+
+
+def api_media_audio_sharing(width=16, height=16):
+    import tempfile
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    assert ret == 0
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        filename = os.path.join(tmpdir, "audio.wav")
+        _write_audio_file(filename)
+
+        # Both textures share the same audio mapping and must display the same frame
+        m = ngl.Media(filename, audio_tex=1)
+        left = ngl.Quad((-1, -1, 0), (1, 0, 0), (0, 2, 0))
+        right = ngl.Quad((0, -1, 0), (1, 0, 0), (0, 2, 0))
+        renders = [ngl.RenderTexture(ngl.Texture2D(data_src=m), geometry=quad) for quad in (left, right)]
+        assert ctx.set_scene(ngl.Group(children=renders)) == 0
+        half = width // 2 * 4
+        for t in (0, 0.25, 0.5):
+            assert ctx.draw(t) == 0
+            for y in range(height):
+                row = capture_buffer[y * width * 4 : (y + 1) * width * 4]
+                assert row[:half] == row[half:]
+
+        # The shared mapping can not honor different sampling parameters
+        m = ngl.Media(filename, audio_tex=1)
+        textures = (ngl.Texture2D(data_src=m), ngl.Texture2D(data_src=m, min_filter="linear"))
+        scene = ngl.Group(children=[ngl.RenderTexture(texture) for texture in textures])
+        assert ctx.set_scene(scene) == 0
+        assert _ret_to_fourcc(ctx.draw(0)) == "Eusg"  # Usage error
+
+        assert ctx.set_scene(None) == 0
+        del ctx
+
+
 def api_denied_node_live_change(width=320, height=240):
     ctx = ngl.Context()
     ret = ctx.configure(offscreen=1, width=width, height=height, backend=_backend)
@@ -376,6 +376,24 @@ def benchmark_test(cfg: SceneCfg, seed=82, enable_computes=True):
     return _get_scene(cfg, seed, enable_computes)
 
 
+@scene(seed=scene.Range(range=[0, 1000]), nb_labels=scene.Range(range=[1, 10000]))
+def benchmark_text(cfg: SceneCfg, seed=0, nb_labels=10000):
+    """Function to be used for manual testing of many animated text labels"""
+    cfg.duration = 10
+    cfg.aspect_ratio = (16, 9)
+    rng = cfg.rng
+    rng.seed(seed)
+
+    t0, t1 = 0, cfg.duration
+    children = []
+    for _ in range(nb_labels):
+        text = _get_random_text(rng)
+        text = ngl.Scale(text, factors=_get_random_animated_vec3(rng, t0, t1, _get_random_factors))
+        text = ngl.Translate(text, vector=_get_random_animated_vec3(rng, t0, t1, _get_random_position))
+        children.append(text)
+    return ngl.Group(children=children)
+
+
 @test_fingerprint(width=1920, height=1080, nb_keyframes=120, tolerance=4)
 @scene()
 def benchmark_fingerprint_with_compute(cfg: SceneCfg):